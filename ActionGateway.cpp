@@ -0,0 +1,214 @@
+#include "ActionGateway.h"
+
+#include "sc2api/sc2_typeenums.h"
+
+#include <algorithm>
+
+using namespace sc2;
+
+void ActionGateway::Reset() {
+	last_sent.clear();
+	issued = 0;
+	suppressed = 0;
+	last_prune = 0;
+}
+
+ActionGateway& ActionGateway::Bind(ActionInterface* actions_interface,
+	const ObservationInterface* observation, uint32_t game_loop) {
+	actions = actions_interface;
+	abilities = &observation->GetAbilityData();
+	current_loop = game_loop;
+	Prune();
+	return *this;
+}
+
+ActionGateway::Command ActionGateway::MakeCommand(uint32_t ability,
+	const Point2D* point, const Unit* target) {
+	Command command;
+	command.ability = ability;
+	command.target = target ? target->tag : NullTag;
+	command.point = point ? *point : Point2D();
+	command.has_point = point != nullptr;
+	return command;
+}
+
+uint32_t ActionGateway::Generic(AbilityID ability) const {
+	uint32_t id = static_cast<uint32_t>(ability);
+	if (abilities && id < abilities->size() &&
+		(*abilities)[id].remaps_to_ability_id) {
+		return (*abilities)[id].remaps_to_ability_id;
+	}
+	return id;
+}
+
+bool ActionGateway::Droppable(uint32_t generic) {
+	switch (static_cast<ABILITY_ID>(generic)) {
+	case ABILITY_ID::SMART:
+	case ABILITY_ID::MOVE:
+	case ABILITY_ID::ATTACK:
+	case ABILITY_ID::STOP:
+	case ABILITY_ID::HARVEST_GATHER:
+	case ABILITY_ID::HARVEST_RETURN:
+	case ABILITY_ID::EFFECT_REPAIR:
+	case ABILITY_ID::RALLY_BUILDING:
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER:
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_RAISE:
+	case ABILITY_ID::MORPH_SIEGEMODE:
+	case ABILITY_ID::MORPH_UNSIEGE:
+	case ABILITY_ID::LIFT:
+	case ABILITY_ID::LAND:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool ActionGateway::AlreadyMorphed(const Unit* unit, uint32_t generic) {
+	switch (static_cast<ABILITY_ID>(generic)) {
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER:
+		return unit->unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED;
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_RAISE:
+		return unit->unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOT;
+	case ABILITY_ID::MORPH_SIEGEMODE:
+		return unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANKSIEGED;
+	case ABILITY_ID::MORPH_UNSIEGE:
+		return unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANK;
+	default:
+		return false;
+	}
+}
+
+bool ActionGateway::SameTarget(const Command& a, const Command& b) const {
+	if (a.target != b.target) {
+		return false;
+	}
+	if (a.target != NullTag || !a.has_point || !b.has_point) {
+		return a.has_point == b.has_point;
+	}
+	float tolerance = settings.position_tolerance;
+	return DistanceSquared2D(a.point, b.point) <= tolerance * tolerance;
+}
+
+bool ActionGateway::Allow(const Unit* unit, const Command& command,
+	bool queued) {
+	if (!unit) {
+		return false;
+	}
+	if (!queued && Droppable(command.ability)) {
+		bool redundant = AlreadyMorphed(unit, command.ability);
+
+		// Already the current order
+		if (!redundant && !unit->orders.empty()) {
+			const UnitOrder& order = unit->orders.front();
+			Command current = MakeCommand(Generic(order.ability_id),
+				nullptr, nullptr);
+			current.target = order.target_unit_tag;
+			current.point = order.target_pos;
+			current.has_point =
+				order.target_unit_tag == NullTag && command.has_point;
+			redundant = current.ability == command.ability &&
+				SameTarget(current, command);
+		}
+
+		// Sent recently
+		auto it = last_sent.find(unit->tag);
+		if (!redundant && it != last_sent.end()) {
+			uint32_t since = current_loop - it->second.game_loop;
+			const Command& previous = it->second.command;
+			redundant = since < settings.min_interval ||
+				(since < settings.repeat_interval &&
+					previous.ability == command.ability &&
+					SameTarget(previous, command));
+		}
+
+		if (redundant) {
+			++suppressed;
+			return false;
+		}
+	}
+	last_sent[unit->tag] = { command, current_loop };
+	++issued;
+	return true;
+}
+
+void ActionGateway::Prune() {
+	uint32_t keep = std::max(settings.repeat_interval, settings.min_interval);
+	if (current_loop - last_prune < 256) {
+		return;
+	}
+	last_prune = current_loop;
+	for (auto it = last_sent.begin(); it != last_sent.end();) {
+		if (current_loop - it->second.game_loop >= keep) {
+			it = last_sent.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void ActionGateway::UnitCommand(const Unit* unit, AbilityID ability,
+	bool queued_command) {
+	if (Allow(unit, MakeCommand(Generic(ability), nullptr, nullptr),
+		queued_command)) {
+		actions->UnitCommand(unit, ability, queued_command);
+	}
+}
+
+void ActionGateway::UnitCommand(const Unit* unit, AbilityID ability,
+	const Point2D& point, bool queued_command) {
+	if (Allow(unit, MakeCommand(Generic(ability), &point, nullptr),
+		queued_command)) {
+		actions->UnitCommand(unit, ability, point, queued_command);
+	}
+}
+
+void ActionGateway::UnitCommand(const Unit* unit, AbilityID ability,
+	const Unit* target, bool queued_command) {
+	if (Allow(unit, MakeCommand(Generic(ability), nullptr, target),
+		queued_command)) {
+		actions->UnitCommand(unit, ability, target, queued_command);
+	}
+}
+
+void ActionGateway::UnitCommand(const Units& units, AbilityID ability,
+	bool queued_command) {
+	Command command = MakeCommand(Generic(ability), nullptr, nullptr);
+	Units allowed;
+	for (const auto& unit : units) {
+		if (Allow(unit, command, queued_command)) {
+			allowed.push_back(unit);
+		}
+	}
+	if (!allowed.empty()) {
+		actions->UnitCommand(allowed, ability, queued_command);
+	}
+}
+
+void ActionGateway::UnitCommand(const Units& units, AbilityID ability,
+	const Point2D& point, bool queued_command) {
+	Command command = MakeCommand(Generic(ability), &point, nullptr);
+	Units allowed;
+	for (const auto& unit : units) {
+		if (Allow(unit, command, queued_command)) {
+			allowed.push_back(unit);
+		}
+	}
+	if (!allowed.empty()) {
+		actions->UnitCommand(allowed, ability, point, queued_command);
+	}
+}
+
+void ActionGateway::UnitCommand(const Units& units, AbilityID ability,
+	const Unit* target, bool queued_command) {
+	Command command = MakeCommand(Generic(ability), nullptr, target);
+	Units allowed;
+	for (const auto& unit : units) {
+		if (Allow(unit, command, queued_command)) {
+			allowed.push_back(unit);
+		}
+	}
+	if (!allowed.empty()) {
+		actions->UnitCommand(allowed, ability, target, queued_command);
+	}
+}
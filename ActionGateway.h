@@ -0,0 +1,106 @@
+#ifndef ACTION_GATEWAY_H_
+#define ACTION_GATEWAY_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_interfaces.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// Unit commands go through here instead of Actions() directly.
+//
+// Orders a unit is already carrying out, and orders repeated within a few
+// game loops, are dropped before they reach the game. Only commands that are
+// safe to repeat are ever dropped (move, attack, gather, depot and tank
+// morphs, ...); production and queued commands always go through, since
+// sending them twice is meant to queue twice.
+class ActionGateway {
+public:
+	struct Settings {
+		// An identical command to the same unit within this many game loops
+		// is dropped
+		uint32_t repeat_interval = 8;
+
+		// Any droppable command within this many game loops of the last one
+		// sent to the unit is dropped (0 turns it off)
+		uint32_t min_interval = 0;
+
+		// Target points closer than this count as the same
+		float position_tolerance = 0.5f;
+	};
+
+	void Configure(const Settings& new_settings) { settings = new_settings; }
+
+	// Forgets the commands of a previous game
+	void Reset();
+
+	// Points the gateway at this game loop's action interface. Ability data
+	// is read from the observation to match generic and specific abilities.
+	ActionGateway& Bind(sc2::ActionInterface* actions_interface,
+		const sc2::ObservationInterface* observation, uint32_t game_loop);
+
+	// Same overloads as sc2::ActionInterface::UnitCommand
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		bool queued_command = false);
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		const sc2::Point2D& point, bool queued_command = false);
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		const sc2::Unit* target, bool queued_command = false);
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		bool queued_command = false);
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		const sc2::Point2D& point, bool queued_command = false);
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		const sc2::Unit* target, bool queued_command = false);
+
+	// Commands sent to the game and dropped, counted per unit
+	size_t Issued() const { return issued; }
+	size_t Suppressed() const { return suppressed; }
+
+private:
+	struct Command {
+		uint32_t ability;
+		sc2::Tag target;
+		sc2::Point2D point;
+		bool has_point;
+	};
+
+	struct Sent {
+		Command command;
+		uint32_t game_loop;
+	};
+
+	static Command MakeCommand(uint32_t ability, const sc2::Point2D* point,
+		const sc2::Unit* target);
+
+	// Generic ability for a specific one (ATTACK for ATTACK_ATTACK, ...)
+	uint32_t Generic(sc2::AbilityID ability) const;
+
+	// Whether repeating the ability is harmless, i.e. it may be dropped
+	static bool Droppable(uint32_t generic);
+
+	// Whether the unit is already in the state the morph would put it in
+	static bool AlreadyMorphed(const sc2::Unit* unit, uint32_t generic);
+
+	bool SameTarget(const Command& a, const Command& b) const;
+
+	// Decides for one unit and records the command if it is sent
+	bool Allow(const sc2::Unit* unit, const Command& command, bool queued);
+
+	// Drops records too old to matter
+	void Prune();
+
+	Settings settings;
+	sc2::ActionInterface* actions = nullptr;
+	const sc2::Abilities* abilities = nullptr;
+	uint32_t current_loop = 0;
+	uint32_t last_prune = 0;
+
+	std::unordered_map<sc2::Tag, Sent> last_sent;
+	size_t issued = 0;
+	size_t suppressed = 0;
+};
+
+#endif
@@ -0,0 +1,151 @@
+#include "AsyncLogger.h"
+
+#include "sc2api/sc2_gametypes.h"
+#include "sc2api/sc2_typeenums.h"
+
+#include <chrono>
+#include <cstring>
+
+using namespace sc2;
+
+const size_t AsyncLogger::capacity;
+
+namespace {
+// How long the flush thread sleeps when there is nothing to write
+const std::chrono::milliseconds idle_wait(2);
+
+// Unit name without the race prefix (COMMANDCENTER, ...)
+const char* ShortName(uint32_t unit_type) {
+	const char* name = UnitTypeToName(UnitTypeID(unit_type));
+	if (std::strncmp(name, "TERRAN_", 7) == 0) {
+		return name + 7;
+	}
+	return name;
+}
+
+void WriteTime(std::ostream& out, uint32_t game_loop) {
+	uint32_t seconds = static_cast<uint32_t>(game_loop / 22.4f);
+	out << seconds / 60 << ":" << seconds % 60;
+}
+
+void WriteArmy(std::ostream& out, const LogRecord& record) {
+	out << "Marines: " << record.values[0] << " Tanks: " << record.values[1]
+		<< " Battlecruisers: " << record.values[2] << "\n";
+}
+}
+
+AsyncLogger::AsyncLogger(std::ostream& output)
+	: out(output), thread(&AsyncLogger::FlushThread, this) {}
+
+AsyncLogger::~AsyncLogger() {
+	running.store(false);
+	thread.join();
+	Drain();
+}
+
+void AsyncLogger::Log(const LogRecord& record) {
+	uint64_t write = head.load(std::memory_order_relaxed);
+	if (write - tail.load(std::memory_order_acquire) >= capacity) {
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	ring[write % capacity] = record;
+	head.store(write + 1, std::memory_order_release);
+}
+
+void AsyncLogger::Flush() {
+	while (tail.load(std::memory_order_acquire) !=
+		head.load(std::memory_order_relaxed)) {
+		std::this_thread::sleep_for(idle_wait);
+	}
+}
+
+void AsyncLogger::FlushThread() {
+	while (running.load()) {
+		if (!Drain()) {
+			std::this_thread::sleep_for(idle_wait);
+		}
+	}
+}
+
+bool AsyncLogger::Drain() {
+	uint64_t read = tail.load(std::memory_order_relaxed);
+	uint64_t write = head.load(std::memory_order_acquire);
+	if (read == write) {
+		return false;
+	}
+	for (uint64_t i = read; i < write; ++i) {
+		Format(out, ring[i % capacity]);
+	}
+	out.flush();
+	// Free the slots only once the lines are out, so Flush() can wait on tail
+	tail.store(write, std::memory_order_release);
+	return true;
+}
+
+void AsyncLogger::Format(std::ostream& out, const LogRecord& record) {
+	switch (record.event) {
+	case LogEvent::UnitCreated:
+		if (record.unit_type ==
+			static_cast<uint32_t>(UNIT_TYPEID::TERRAN_BATTLECRUISER)) {
+			out << "Battlecruiser";
+		}
+		else if (record.unit_type ==
+			static_cast<uint32_t>(UNIT_TYPEID::TERRAN_SIEGETANK)) {
+			out << "Tank";
+		}
+		else {
+			out << ShortName(record.unit_type);
+		}
+		out << " created at ";
+		WriteTime(out, record.game_loop);
+		out << "\n";
+		WriteArmy(out, record);
+		break;
+	case LogEvent::ConstructionComplete:
+		out << ShortName(record.unit_type) << " created at ";
+		WriteTime(out, record.game_loop);
+		out << "\n";
+		WriteArmy(out, record);
+		break;
+	case LogEvent::GameResult: {
+		switch (static_cast<PlayerType>(record.values[0])) {
+		case PlayerType::Participant:
+			out << "UED";
+			break;
+		case PlayerType::Computer:
+			out << "Prey";
+			break;
+		default:
+			out << "Observer";
+			break;
+		}
+		switch (static_cast<GameResult>(record.values[1])) {
+		case GameResult::Win:
+			out << " Wins\n";
+			break;
+		case GameResult::Loss:
+			out << " Loses\n";
+			break;
+		case GameResult::Tie:
+			out << " Tied\n";
+			break;
+		default:
+			out << " Undecided\n";
+			break;
+		}
+		break;
+	}
+	case LogEvent::CommandStats:
+		out << "Unit commands: " << record.values[0] << " sent, "
+			<< record.values[1] << " suppressed\n";
+		break;
+	case LogEvent::StateTableEntries:
+	case LogEvent::StateTableSlots:
+		out << (record.event == LogEvent::StateTableEntries ?
+			"State table entries: " : "State table slots: ")
+			<< record.values[0] << " attacking, " << record.values[1]
+			<< " retreating, " << record.values[2] << " retreat locations\n";
+		break;
+	}
+}
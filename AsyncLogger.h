@@ -0,0 +1,87 @@
+#ifndef ASYNC_LOGGER_H_
+#define ASYNC_LOGGER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <thread>
+
+// What a log record is about; decides how it is formatted
+enum class LogEvent : uint8_t {
+	// unit_type was trained, values are the marine, tank and battlecruiser
+	// counts
+	UnitCreated,
+	// unit_type finished building, values as for UnitCreated
+	ConstructionComplete,
+	// values[0] is the PlayerType, values[1] the GameResult
+	GameResult,
+	// values[0] unit commands sent, values[1] suppressed
+	CommandStats,
+	// Entries in unit_attacking, battlecruiser_retreating and
+	// battlecruiser_retreat_location
+	StateTableEntries,
+	// Slots allocated by the same tables
+	StateTableSlots,
+};
+
+// One log line, kept binary until the flush thread formats it
+struct LogRecord {
+	LogEvent event;
+	uint32_t game_loop;
+	uint32_t unit_type;
+	std::array<int32_t, 3> values;
+};
+
+// Game output written from a background thread.
+//
+// Log() copies the record into a fixed ring buffer and returns; it never
+// locks, allocates or waits. When the ring is full the record is dropped and
+// counted. Only one thread may call Log() (the game thread).
+class AsyncLogger {
+public:
+	explicit AsyncLogger(std::ostream& output);
+	~AsyncLogger();
+
+	AsyncLogger(const AsyncLogger&) = delete;
+	AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+	void Log(const LogRecord& record);
+
+	void Log(LogEvent event, uint32_t game_loop, uint32_t unit_type = 0,
+		int32_t value0 = 0, int32_t value1 = 0, int32_t value2 = 0) {
+		Log(LogRecord{ event, game_loop, unit_type, { { value0, value1,
+			value2 } } });
+	}
+
+	// Waits until every record logged so far is written. Blocks, so only for
+	// the end of the game.
+	void Flush();
+
+	// Records lost to a full ring
+	uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+	static const size_t capacity = 1024;
+
+private:
+	void FlushThread();
+
+	// Writes out what is in the ring, returns whether there was anything
+	bool Drain();
+
+	static void Format(std::ostream& out, const LogRecord& record);
+
+	std::ostream& out;
+	std::array<LogRecord, capacity> ring;
+
+	// Records [tail, head) are waiting; head is only written by Log(), tail
+	// only by the flush thread. Both only grow.
+	std::atomic<uint64_t> head{ 0 };
+	std::atomic<uint64_t> tail{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+	std::atomic<bool> running{ true };
+	std::thread thread;
+};
+
+#endif
@@ -1,5 +1,34 @@
 #include "BasicSc2Bot.h"
 
+#include <chrono>
+
+namespace {
+// Reports the time of one OnStep to the game monitor, if there is one
+class StepTimer {
+public:
+	explicit StepTimer(GameMonitor* monitor) : monitor(monitor) {
+		if (monitor) {
+			start = std::chrono::steady_clock::now();
+		}
+	}
+
+	~StepTimer() {
+		if (monitor) {
+			std::chrono::duration<double, std::micro> elapsed =
+				std::chrono::steady_clock::now() - start;
+			monitor->OnStepTimed(elapsed.count());
+		}
+	}
+
+	StepTimer(const StepTimer&) = delete;
+	StepTimer& operator=(const StepTimer&) = delete;
+
+private:
+	GameMonitor* monitor;
+	std::chrono::steady_clock::time_point start;
+};
+}
+
 BasicSc2Bot::BasicSc2Bot()
 	: current_build_order_index(0), num_scvs(12), num_marines(0),
 	num_battlecruisers(0), num_siege_tanks(0), num_barracks(0),
@@ -110,16 +139,12 @@ void EchoAction(const sc2::RawActions& actions, sc2::DebugInterface* debug,
 	debug->DebugTextOut(last_action_text_);
 }
 
-// Get real time in minutes and seconds
-std::vector<uint32_t> BasicSc2Bot::GetRealTime() const {
-	const ObservationInterface* obs = Observation();
-	uint32_t game_loop = obs->GetGameLoop();
-	float real_time_seconds = game_loop / 22.4f;
-
-	uint32_t minutes = static_cast<int>(real_time_seconds) / 60;
-	uint32_t seconds = static_cast<int>(real_time_seconds) % 60;
-
-	return { minutes, seconds };
+// Logs the unit with the current army counts
+void BasicSc2Bot::LogArmy(LogEvent event, const Unit* unit) {
+	logger.Log(event, Observation()->GetGameLoop(),
+		static_cast<uint32_t>(unit->unit_type),
+		static_cast<int32_t>(num_marines), static_cast<int32_t>(num_siege_tanks),
+		static_cast<int32_t>(num_battlecruisers));
 }
 
 // Debugging function
@@ -155,26 +180,23 @@ void BasicSc2Bot::Debugging() {
 	}
 
 	// Draw all scvs that are assigned to repair
-	for (const auto& scv_repairing : scvs_repairing) {
-		const Unit* scv = obs->GetUnit(scv_repairing);
-		if (scv) {
-			// repairing
-			DrawBoxAtLocation(debug, scv->pos, 2.0f, sc2::Colors::Yellow);
-		}
+	for (const auto& scv : worker_roles.Get(WorkerRoles::RepairCrew)) {
+		// repairing
+		DrawBoxAtLocation(debug, scv->pos, 2.0f, sc2::Colors::Yellow);
 	}
 
 	// buildable map
 	/*if (current_gameloop % 100)
 	{
-		for (const auto& i : build_map[0])
+		build_map[0].ForEach([&](int x, int y, bool free)
 		{
-			if (!i.second)
+			if (!free)
 			{
-				continue;
+				return;
 			}
-			DrawBoxAtLocation(debug, Point3D(i.first.x + 0.5f, i.first.y + 0.5f,
-	height_at_float(i.first) + 0.1f), 1.0f, sc2::Colors::Green);
-		}
+			DrawBoxAtLocation(debug, Point3D(x + 0.5f, y + 0.5f,
+	height_at_float(Point2DI(x, y)) + 0.1f), 1.0f, sc2::Colors::Green);
+		});
 	}*/
 
 	/*if (Control()->GetLastStatus() != SC2APIProtocol::Status::in_game)
@@ -211,20 +233,22 @@ void BasicSc2Bot::Debugging() {
 
 // Start the bot
 void BasicSc2Bot::on_start() {
+	PROFILE_SCOPE("on_start");
 	// Initialize start locations, expansion locations, chokepoints, etc.
 	const ObservationInterface* obs = Observation();
 	start_location = obs->GetStartLocation();
 	enemy_start_locations = obs->GetGameInfo().enemy_start_locations;
+	BuildUnitTraits();
 	if (!enemy_start_locations.empty()) {
 		enemy_start_location = enemy_start_locations[0];
 	}
-	expansion_locations = search::CalculateExpansionLocations(obs, Query());
 	retreat_location = { start_location.x + 5.0f, start_location.y };
 
 	// Get map dimensions for corner coordinates
 	const GameInfo& game_info = obs->GetGameInfo();
 	playable_min = game_info.playable_min;
 	playable_max = game_info.playable_max;
+	decode_terrain_height();
 
 	// Initialize the four corners of the map
 	map_corners = {
@@ -234,10 +258,40 @@ void BasicSc2Bot::on_start() {
 		Point2D(playable_max.x, playable_max.y)  // Top-right
 	};
 
-	// find ramps
+	// Map analysis only depends on the map and our start location,
+	// so it comes from the cache after the first game
 	base_location = GetBaseLocation();
-	find_right_ramp(start_location);
-	find_ramps_build_map(false);
+	MapCacheKey map_cache_key = MapCacheKey::FromGame(game_info, start_location);
+	MapAnalysis analysis;
+	if (LoadMapAnalysis(map_cache_key, analysis)) {
+		apply_map_analysis(analysis);
+	}
+	else {
+		expansion_locations = search::CalculateExpansionLocations(obs, Query());
+
+		// find ramps
+		find_right_ramp(start_location);
+		find_ramps_build_map(false);
+
+		// Get map dimensions
+		unsigned int width = game_info.width;
+		unsigned int height = game_info.height;
+
+		// Generate grid points across the entire map for scouting
+		scout_points.clear(); // Clear previous scout points if any
+		const unsigned int step_size =
+			15; // Step size for grid points (adjust for thoroughness)
+		for (unsigned int x = 0; x < width; x += step_size) {
+			for (unsigned int y = 0; y < height; y += step_size) {
+				Point2D grid_point(static_cast<float>(x), static_cast<float>(y));
+				if (obs->IsPathable(grid_point)) {
+					scout_points.emplace_back(grid_point);
+				}
+			}
+		}
+
+		SaveMapAnalysis(map_cache_key, map_analysis());
+	}
 	update_build_map(true);
 	auto mineral_points = get_close_mineral_points(start_location);
 	main_mineral_convexHull = convexHull(mineral_points);
@@ -274,34 +328,49 @@ void BasicSc2Bot::on_start() {
 		}
 	}
 
-	// Get map dimensions
-	unsigned int width = game_info.width;
-	unsigned int height = game_info.height;
-
-	// Generate grid points across the entire map for scouting
-	scout_points.clear(); // Clear previous scout points if any
-	const unsigned int step_size =
-		15; // Step size for grid points (adjust for thoroughness)
-	for (unsigned int x = 0; x < width; x += step_size) {
-		for (unsigned int y = 0; y < height; y += step_size) {
-			Point2D grid_point(static_cast<float>(x), static_cast<float>(y));
-			if (obs->IsPathable(grid_point)) {
-				scout_points.emplace_back(grid_point);
-			}
-		}
-	}
-
 	// Start scouting from the beginning
 	clean_up_index = 0;
 }
 
 void BasicSc2Bot::OnGameStart() {
+	// Starting units don't fire OnUnitCreated
+	unit_registry.Reset(Snapshot().All(Unit::Alliance::Self));
+	action_gateway.Reset();
+	ScheduleTasks();
 	//
 	/*Debug()->DebugIgnoreResourceCost();
 	Debug()->DebugFastBuild();
 	Debug()->SendDebug();*/
 }
 
+// Periods are in game loops, costs are rough estimates in microseconds
+void BasicSc2Bot::ScheduleTasks() {
+	scheduler.Clear();
+	scheduler.Add("TrainSiegeTanks", 10, 50.0, [this] { TrainSiegeTanks(); });
+	target_siege_tank_task = scheduler.AddInPlace("TargetSiegeTank", 10, 100.0,
+		[this] { TargetSiegeTank(); });
+	scheduler.Add("SCVAttackEmergency", 23, 100.0,
+		[this] { SCVAttackEmergency(); });
+	target_battlecruisers_task = scheduler.AddInPlace("TargetBattlecruisers",
+		1, 60.0, [this] { TargetBattlecruisers(); });
+	scheduler.Add("BuilderChecks", 25, 50.0, [this] {
+		IsBuilderGettingDamaged();
+		IsBuildingProgress();
+	});
+	late_defense_task = scheduler.AddInPlace("LateDefense", 42, 200.0,
+		[this] { LateDefense(); });
+	scheduler.Add("BuildTechStructures", 46, 300.0, [this] {
+		// Building one more battlecruiser might be more helpful??
+		BuildEngineeringBay();
+		// don't need
+		BuildArmory();
+	});
+	rush_slot = scheduler.AddSlot("AllOutRush", 23, 200.0);
+	second_barracks_slot = scheduler.AddSlot("SecondBarracks", 46, 300.0);
+	late_depot_slot = scheduler.AddSlot("LateSupplyDepots", 50, 300.0);
+	idle_retreat_slot = scheduler.AddSlot("IdleBattlecruiserRetreat", 23, 50.0);
+}
+
 void BasicSc2Bot::OnGameEnd() {
 	// Get the game info
 	const ObservationInterface* observation = Observation();
@@ -311,29 +380,49 @@ void BasicSc2Bot::OnGameEnd() {
 		players[playerInfo.player_id] = &playerInfo;
 	}
 
-	// Map the player types to strings
-	auto playerTypes = std::map<PlayerType, std::string>();
-	playerTypes[PlayerType::Participant] = "UED";
-	playerTypes[PlayerType::Computer] = "Prey";
-	playerTypes[Observer] = "Observer";
-
-	// Map the game results to strings
-	auto gameResults = std::map<GameResult, std::string>();
-	gameResults[Win] = " Wins";
-	gameResults[Loss] = " Loses";
-	gameResults[Tie] = " Tied";
-	gameResults[Undecided] = " Undecided";
-
 	// Print the results of the game
+	uint32_t game_loop = observation->GetGameLoop();
 	for (auto& playerResult : observation->GetResults()) {
-		std::cout
-			<< playerTypes[((*(players[playerResult.player_id])).player_type)]
-			<< gameResults[playerResult.result] << std::endl;
+		logger.Log(LogEvent::GameResult, game_loop, 0,
+			(*(players[playerResult.player_id])).player_type,
+			playerResult.result);
+	}
+
+	logger.Log(LogEvent::CommandStats, game_loop, 0,
+		static_cast<int32_t>(action_gateway.Issued()),
+		static_cast<int32_t>(action_gateway.Suppressed()));
+	// Per unit state left over, to check it stays bounded in long games
+	logger.Log(LogEvent::StateTableEntries, game_loop, 0,
+		static_cast<int32_t>(unit_attacking.Size()),
+		static_cast<int32_t>(battlecruiser_retreating.Size()),
+		static_cast<int32_t>(battlecruiser_retreat_location.Size()));
+	logger.Log(LogEvent::StateTableSlots, game_loop, 0,
+		static_cast<int32_t>(unit_attacking.Capacity()),
+		static_cast<int32_t>(battlecruiser_retreating.Capacity()),
+		static_cast<int32_t>(battlecruiser_retreat_location.Capacity()));
+
+	// The game is over, so waiting is fine; the reports below go straight
+	// to std::cout and must come after the log
+	logger.Flush();
+	if (logger.Dropped()) {
+		std::cout << "Log records dropped: " << logger.Dropped() << std::endl;
+	}
+
+	// Time and overruns of the periodic tasks
+	scheduler.Report(std::cout);
+
+	// Frame time of every OnStep stage (UEDBOT_PROFILE builds only)
+	PROFILE_REPORT(std::cout);
+
+	if (monitor) {
+		monitor->OnGameEnded(observation);
 	}
 }
 
 // Main game loop
 void BasicSc2Bot::OnStep() {
+	PROFILE_SCOPE("OnStep");
+	StepTimer step_timer(monitor);
 	++step_counter;
 	// Wait for 10 frames
 	if (step_counter < 10) {
@@ -344,6 +433,19 @@ void BasicSc2Bot::OnStep() {
 		on_start();
 	}
 	current_gameloop = Observation()->GetGameLoop();
+	// Index all units once for this game loop
+	Snapshot();
+	EnemyGrid();
+	unit_registry.Reconcile();
+	worker_roles.Update(
+		Snapshot().OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SCV),
+		Snapshot().OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_REFINERY));
+#ifndef NDEBUG
+	if (current_gameloop % 224 == 0) {
+		unit_registry.CheckConsistency(Snapshot().All(Unit::Alliance::Self),
+			current_gameloop);
+	}
+#endif
 	/*if (current_gameloop % 22 == 0)
 		BasicSc2Bot::Debugging();*/
 
@@ -355,6 +457,7 @@ void BasicSc2Bot::OnStep() {
 		BasicSc2Bot::ControlUnits();
 		BasicSc2Bot::Defense();
 		BasicSc2Bot::Offense();
+		scheduler.Run(current_gameloop);
 	}
 }
 
@@ -391,19 +494,19 @@ void BasicSc2Bot::OnUnitIdle(const Unit* unit) {
 	case UNIT_TYPEID::TERRAN_MARINE:
 		if (Distance2D(unit->pos, rally_barrack) >= 3.0f &&
 			Distance2D(unit->pos, enemy_start_location) >= 30.0f &&
-			!unit_attacking[unit]) {
-			Actions()->UnitCommand(unit, ABILITY_ID::MOVE_MOVE, rally_barrack);
+			!unit_attacking.Get(unit->tag)) {
+			Commands().UnitCommand(unit, ABILITY_ID::MOVE_MOVE, rally_barrack);
 		}
 		break;
 	case UNIT_TYPEID::TERRAN_SIEGETANK:
 		if (Distance2D(unit->pos, rally_factory) >= 3.0f &&
 			Distance2D(unit->pos, enemy_start_location) >= 30.0f &&
-			!unit_attacking[unit]) {
-			Actions()->UnitCommand(unit, ABILITY_ID::MOVE_MOVE, rally_factory);
+			!unit_attacking.Get(unit->tag)) {
+			Commands().UnitCommand(unit, ABILITY_ID::MOVE_MOVE, rally_factory);
 		}
 		break;
 	case UNIT_TYPEID::TERRAN_BATTLECRUISER:
-		if (current_gameloop % 23 == 0 &&
+		if (scheduler.Due(idle_retreat_slot, current_gameloop) &&
 			!(Distance2D(unit->pos, start_location) < 25.0f)) {
 			Retreat(unit);
 		}
@@ -421,27 +524,23 @@ void BasicSc2Bot::OnUnitCreated(const Unit* unit) {
 	if (!unit) {
 		return;
 	}
+	unit_registry.OnCreated(unit);
 
 	// SCV created
 	if (unit->unit_type == UNIT_TYPEID::TERRAN_SCV) {
 		++num_scvs;
-		if (scvs_repairing.size() < 6) {
-			scvs_repairing.insert(unit->tag);
+		if (worker_roles.Count(WorkerRoles::RepairCrew) < 6) {
+			worker_roles.Assign(unit, WorkerRoles::RepairCrew);
 		}
 	}
 
-	std::vector<uint32_t> minsec = GetRealTime();
-
 	// Battlecruiser created
 	if (unit->unit_type == UNIT_TYPEID::TERRAN_BATTLECRUISER) {
 		if (!first_battlecruiser_trained) {
 			first_battlecruiser_trained = true;
 		}
 		num_battlecruisers++;
-		std::cout << "Battlecruiser created at " << minsec[0] << ":"
-			<< minsec[1] << std::endl;
-		std::cout << "Marines: " << num_marines << " Tanks: " << num_siege_tanks
-			<< " Battlecruisers: " << num_battlecruisers << std::endl;
+		LogArmy(LogEvent::UnitCreated, unit);
 	}
 	// Marine created
 	if (unit->unit_type == UNIT_TYPEID::TERRAN_MARINE) {
@@ -450,17 +549,14 @@ void BasicSc2Bot::OnUnitCreated(const Unit* unit) {
 	// Siege Tank created
 	if (unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANK) {
 		num_siege_tanks++;
-		std::cout << "Tank created at " << minsec[0] << ":" << minsec[1]
-			<< std::endl;
-		std::cout << "Marines: " << num_marines << " Tanks: " << num_siege_tanks
-			<< " Battlecruisers: " << num_battlecruisers << std::endl;
+		LogArmy(LogEvent::UnitCreated, unit);
 	}
 }
 
 void BasicSc2Bot::OnBuildingConstructionComplete(const Unit* unit) {
 	const ObservationInterface* obs = Observation();
+	unit_registry.OnCompleted(unit);
 	update_build_map(true);
-	std::vector<uint32_t> minsec = GetRealTime();
 	auto unit_type = unit->unit_type.ToType();
 
 	if (unit_type == UNIT_TYPEID::TERRAN_BARRACKS) {
@@ -476,10 +572,7 @@ void BasicSc2Bot::OnBuildingConstructionComplete(const Unit* unit) {
 		++num_fusioncores;
 	}
 	else if (unit_type == UNIT_TYPEID::TERRAN_COMMANDCENTER) {
-		std::cout << "COMMANDCENTER created at " << minsec[0] << ":"
-			<< minsec[1] << std::endl;
-		std::cout << "Marines: " << num_marines << " Tanks: " << num_siege_tanks
-			<< " Battlecruisers: " << num_battlecruisers << std::endl;
+		LogArmy(LogEvent::ConstructionComplete, unit);
 		bases.emplace_back(unit);
 	}
 
@@ -496,10 +589,10 @@ void BasicSc2Bot::OnBuildingConstructionComplete(const Unit* unit) {
 		// Assign them to gas
 		int scv_count = 0;
 		for (const auto& scv : scvs) {
-			if (scvs_repairing.find(scv->tag) != scvs_repairing.end()) {
+			if (worker_roles.Has(scv->tag, WorkerRoles::RepairCrew)) {
 				continue;
 			}
-			Actions()->UnitCommand(scv, ABILITY_ID::HARVEST_GATHER, unit);
+			Commands().UnitCommand(scv, ABILITY_ID::HARVEST_GATHER, unit);
 			++scv_count;
 			// make sure it has 3 including the scv that is building the
 			// refinery
@@ -523,7 +616,7 @@ void BasicSc2Bot::OnBuildingConstructionComplete(const Unit* unit) {
 			if (CanBuild(50, 25)) {
 				// it is always true because we make sure that we have enough
 				// resources to build the techlab
-				Actions()->UnitCommand(unit,
+				Commands().UnitCommand(unit,
 					ABILITY_ID::BUILD_TECHLAB_BARRACKS);
 			}
 
@@ -573,6 +666,7 @@ void BasicSc2Bot::OnUpgradeCompleted(UpgradeID upgrade_id) {
 }
 
 void BasicSc2Bot::OnUnitDestroyed(const Unit* unit) {
+	unit_registry.OnDestroyed(unit);
 	// Update unit counts and remove destroyed units from the game state
 	if (IsFriendlyStructure(*unit)) {
 		update_build_map(false, unit);
@@ -671,6 +765,7 @@ void BasicSc2Bot::OnUnitDestroyed(const Unit* unit) {
 		}
 
 		// Reset scouting
+		worker_roles.ReleaseAll(WorkerRoles::Scout);
 		scv_scout = nullptr;
 		scout_complete = true;
 		is_scouting = false;
@@ -679,28 +774,29 @@ void BasicSc2Bot::OnUnitDestroyed(const Unit* unit) {
 	// SCV died
 	if (unit->unit_type == UNIT_TYPEID::TERRAN_SCV) {
 		--num_scvs;
-		scvs_repairing.erase(unit->tag);
-		// scvs_gas.erase(unit->tag);
+		worker_roles.OnDestroyed(unit);
 	}
 	else if (unit->unit_type == UNIT_TYPEID::TERRAN_BATTLECRUISER) {
-		battlecruiser_retreating.erase(unit);
 		--num_battlecruisers;
 	}
 	else if (unit->unit_type == UNIT_TYPEID::TERRAN_MARINE) {
-		unit_attacking.erase(unit);
 		--num_marines;
 	}
 	else if (unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANK) {
-		unit_attacking.erase(unit);
 		--num_siege_tanks;
 	}
+
+	// Drop the unit's state whatever its type (tanks may die sieged)
+	unit_attacking.Erase(unit->tag);
+	battlecruiser_retreating.Erase(unit->tag);
+	battlecruiser_retreat_location.Erase(unit->tag);
 }
 
 void BasicSc2Bot::OnUnitEnterVision(const Unit* unit) {
 	return;
 }
 
-// Testing commands
+// Testing commands (UEDBot_runner -j 3 plays all of them and sums them up)
 // ./BasicSc2Bot.exe -c -a zerg -d Hard -m CactusValleyLE.SC2Map
 // ./BasicSc2Bot.exe -c -a terran -d Hard -m CactusValleyLE.SC2Map
 // ./BasicSc2Bot.exe -c -a protoss -d Hard -m CactusValleyLE.SC2Map
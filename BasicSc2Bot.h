@@ -11,6 +11,25 @@
 #include "sc2utils/sc2_arg_parser.h"
 #include "sc2utils/sc2_manage_process.h"
 
+#include "ActionGateway.h"
+#include "AsyncLogger.h"
+#include "BuildGrid.h"
+#include "DistanceField.h"
+#include "EnemyArrays.h"
+#include "FlatTagMap.h"
+#include "FrameProfiler.h"
+#include "InfluenceMap.h"
+#include "MapCache.h"
+#include "PlacementPlanner.h"
+#include "SpatialGrid.h"
+#include "TaskScheduler.h"
+#include "TypeTables.h"
+#include "UnitRegistry.h"
+#include "UnitSnapshot.h"
+#include "UnitTraits.h"
+#include "WorkerRoles.h"
+
+#include <algorithm>
 #include <iostream>
 #include <map>
 #include <string>
@@ -27,7 +46,24 @@ template <> struct std::hash<sc2::AbilityID> {
 	}
 };
 
+// Micro benchmarks (bench/) call the bot's private kernels through this
+struct BotBenchAccess;
+
+// Watches games from outside the bot, for the evaluation runner (runner/)
+class GameMonitor {
+public:
+	virtual ~GameMonitor() {}
+
+	// Time the bot spent in one OnStep
+	virtual void OnStepTimed(double microseconds) = 0;
+
+	// Called at the end of OnGameEnd, while the results can still be read
+	virtual void OnGameEnded(const sc2::ObservationInterface* observation) = 0;
+};
+
 class BasicSc2Bot : public sc2::Agent {
+	friend struct BotBenchAccess;
+
 public:
 	// Constructors
 	BasicSc2Bot();
@@ -43,18 +79,44 @@ public:
 	virtual void OnUnitDestroyed(const Unit* unit) final;
 	virtual void OnUnitEnterVision(const Unit* unit) final;
 
+	// Game interfaces. These hide the client's own, so that offline runs
+	// (offline/) can put theirs in with UseInterfaces.
+	const ObservationInterface* Observation() const;
+	QueryInterface* Query();
+	ActionInterface* Actions();
+
+	// Uses these instead of the client's interfaces; nullptr for the client's
+	void UseInterfaces(const ObservationInterface* observation,
+		QueryInterface* query, ActionInterface* actions);
+
+	// Reports step times and the game result to the monitor, nullptr for none
+	void SetMonitor(GameMonitor* game_monitor) { monitor = game_monitor; }
+
 private:
 	// =========================
 	// Debugging
 	// =========================
 	void Debugging();
-	std::vector<uint32_t> GetRealTime() const;
 	void DrawBoxesOnMap(sc2::DebugInterface* debug, uint32_t map_width,
 		uint32_t map_height);
 	void DrawBoxAtLocation(sc2::DebugInterface* debug,
 		const sc2::Point3D& location, float size,
 		const sc2::Color& color = sc2::Colors::Red) const;
 
+	// Set by UseInterfaces, nullptr for the client's
+	const ObservationInterface* observation_interface = nullptr;
+	QueryInterface* query_interface = nullptr;
+	ActionInterface* action_interface = nullptr;
+
+	// Set by SetMonitor
+	GameMonitor* monitor = nullptr;
+
+	// Game output, written off the game thread
+	AsyncLogger logger{ std::cout };
+
+	// Logs the unit with the current army counts
+	void LogArmy(LogEvent event, const Unit* unit);
+
 	uint32_t current_gameloop;
 	uint32_t last_gameloop;
 
@@ -62,6 +124,78 @@ private:
 
 	void on_start();
 
+	// Flags per unit type for the targeting checks, built in on_start
+	UnitTraits unit_traits;
+
+	// Fills unit_traits from the unit type data and the type tables
+	void BuildUnitTraits();
+
+	// Units observed this game loop, bucketed by alliance and type
+	mutable UnitSnapshot unit_snapshot;
+
+	// Returns the unit snapshot for the current game loop (built on first use)
+	const UnitSnapshot& Snapshot() const;
+
+	// Enemy units of this game loop in a uniform grid for proximity queries
+	mutable SpatialGrid enemy_grid;
+
+	// Returns the enemy grid for the current game loop (built on first use)
+	const SpatialGrid& EnemyGrid() const;
+
+	// Enemy units of this game loop as flat arrays for the distance kernels
+	mutable EnemyArrays enemy_arrays;
+
+	// Returns the enemy arrays for the current game loop (built on first use)
+	const EnemyArrays& Enemies() const;
+
+	// Distance to the nearest enemy over the whole map, per game loop
+	mutable DistanceField enemy_distances;
+
+	// Returns the enemy distances for the current game loop (built on first
+	// use)
+	const DistanceField& EnemyDistances() const;
+
+	// Enemy anti-air threat over the whole map, per game loop
+	mutable InfluenceMap anti_air_threat;
+
+	// Returns the anti-air threat for the current game loop (built on first
+	// use)
+	const InfluenceMap& AntiAirThreat() const;
+
+	// Our units by type and state, kept up to date by the unit callbacks
+	UnitRegistry unit_registry;
+
+	// What each SCV is doing and the duties we gave it, updated every game
+	// loop
+	WorkerRoles worker_roles;
+
+	// Batched placement queries, cached for the current game loop
+	PlacementPlanner placement_planner;
+
+	// Drops unit commands that repeat what a unit is already doing
+	ActionGateway action_gateway;
+
+	// Returns the action gateway for the current game loop; use it instead
+	// of Actions() for unit commands
+	ActionGateway& Commands();
+
+	// Periodic work, staggered so periods don't pile up on one game loop
+	TaskScheduler scheduler;
+
+	// Registers the periodic tasks with the scheduler
+	void ScheduleTasks();
+
+	// Throttles inside larger decisions, checked with scheduler.Due()
+	TaskScheduler::TaskId rush_slot;
+	TaskScheduler::TaskId second_barracks_slot;
+	TaskScheduler::TaskId late_depot_slot;
+	TaskScheduler::TaskId idle_retreat_slot;
+
+	// Tasks run where they give their commands, with scheduler.RunIfDue()
+	TaskScheduler::TaskId target_siege_tank_task;
+	TaskScheduler::TaskId target_battlecruisers_task;
+	TaskScheduler::TaskId late_defense_task;
+
 	// =========================
 	// Economy Management
 	// =========================
@@ -171,31 +305,6 @@ private:
 	const Unit* swap_a = nullptr;
 	const Unit* swap_b = nullptr;
 
-	// footprint_radius for building
-	std::map<UNIT_TYPEID, float> footprint_r = {
-		{UNIT_TYPEID::TERRAN_COMMANDCENTER, 2.5f},
-		{UNIT_TYPEID::TERRAN_SUPPLYDEPOT, 1.0f},
-		{UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED, 1.0f},
-		{UNIT_TYPEID::TERRAN_REFINERY, 1.0f},
-		{UNIT_TYPEID::TERRAN_BARRACKS, 1.5f},
-		{UNIT_TYPEID::TERRAN_ENGINEERINGBAY, 1.5f},
-		{UNIT_TYPEID::TERRAN_MISSILETURRET, 1.0f},
-		{UNIT_TYPEID::TERRAN_BUNKER, 1.5f},
-		{UNIT_TYPEID::TERRAN_SENSORTOWER, 0.5f},
-		{UNIT_TYPEID::TERRAN_GHOSTACADEMY, 1.5f},
-		{UNIT_TYPEID::TERRAN_FACTORY, 1.5f},
-		{UNIT_TYPEID::TERRAN_STARPORT, 1.5f},
-		{UNIT_TYPEID::TERRAN_ARMORY, 1.5f},
-		{UNIT_TYPEID::TERRAN_FUSIONCORE, 1.5f},
-		{UNIT_TYPEID::TERRAN_TECHLAB, 3.5f},
-		{UNIT_TYPEID::TERRAN_REACTOR, 3.5f},
-		{UNIT_TYPEID::TERRAN_ORBITALCOMMAND, 2.5f},
-		{UNIT_TYPEID::TERRAN_PLANETARYFORTRESS, 2.5f},
-		{UNIT_TYPEID::TERRAN_AUTOTURRET, 0.5f},
-		{UNIT_TYPEID::TERRAN_SCV,
-		 0.375f} // SCV is not a building but included for completeness
-	};
-
 	// =========================
 	// Unit Production and Upgrades
 	// =========================
@@ -262,7 +371,7 @@ private:
 	bool need_clean_up = false;
 
 	// Determines if units are attacking.
-	std::unordered_map<const Unit*, bool> unit_attacking;
+	FlatTagMap<bool> unit_attacking;
 
 	// Attack target for offense
 	Point2D attack_target;
@@ -401,10 +510,13 @@ private:
 	std::vector<Point2D> enemy_adjacent_corners;
 
 	// Retreating flag
-	std::unordered_map<const Unit*, bool> battlecruiser_retreating;
+	FlatTagMap<bool> battlecruiser_retreating;
 
 	// Retreating location
-	std::unordered_map<const Unit*, Point2D> battlecruiser_retreat_location;
+	FlatTagMap<Point2D> battlecruiser_retreat_location;
+
+	// Enemy indices in range of a Battlecruiser, reused by GetClosestThreat
+	std::vector<uint32_t> threat_candidates;
 
 	// =========================
 	// Helper Methods
@@ -506,12 +618,6 @@ private:
 	// MapInfo (Ramp, build_map, etc)
 	// =========================
 
-	struct Point2DComparator {
-		bool operator()(const Point2D& lhs, const Point2D& rhs) const {
-			return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
-		}
-	};
-
 	enum class BaseLocation {
 		lefttop, righttop, leftbottom, rightbottom
 	};
@@ -539,9 +645,6 @@ private:
 
 	Point2D Point2D_mean(const std::vector<Point2D>& points) const;
 
-	Point2D Point2D_mean(
-		const std::map<Point2D, bool, Point2DComparator>& map_points) const;
-
 	std::vector<Point2D> convexHull(std::vector<Point2D>& points) const;
 
 	std::vector<Point2D> circle_intersection(const Point2D& p1,
@@ -549,12 +652,31 @@ private:
 
 	Point2D towards(const Point2D& p1, const Point2D& p2, float distance) const;
 
-	int height_at(const Point2DI& p) const;
+	// decode the terrain height image once, height_at reads from it
+	void decode_terrain_height();
 
-	float height_at_float(const Point2DI& p) const;
+	int height_at(const Point2DI& p) const {
+		return static_cast<int>(height_at_float(p));
+	}
+
+	// points off the map read the nearest cell on its edge
+	float height_at_float(const Point2DI& p) const {
+		if (terrain_height.empty()) {
+			return 0.0f;
+		}
+		int x = std::min(std::max(p.x, 0), terrain_width - 1);
+		int y = std::min(std::max(p.y, 0), terrain_rows - 1);
+		return terrain_height[y * terrain_width + x];
+	}
 
 	void find_ramps_build_map(bool isRamp);
 
+	// the map analysis of on_start, for the map cache
+	MapAnalysis map_analysis() const;
+
+	// restore the map analysis of on_start from the map cache
+	void apply_map_analysis(MapAnalysis& analysis);
+
 	void find_groups(std::vector<Point2D>& points, int minimum_points_per_group,
 		int max_distance_between_points);
 
@@ -605,6 +727,10 @@ private:
 	// Get the closest threat to a unit
 	const Unit* GetClosestThreat(const Unit* unit);
 
+	// Target of a Battlecruiser that isn't kiting, by target priority
+	const Unit* GetBattlecruiserTarget(const Unit* unit, bool avoid_turrets,
+		float max_distance) const;
+
 	// =========================
 	// Member Variables
 	// =========================
@@ -632,8 +758,13 @@ private:
 	std::vector<sc2::Point2D> main_mineral_convexHull;
 	std::vector<sc2::Point2D> main_base_terret_locations;
 
+	// terrain height of every cell, row by row
+	std::vector<float> terrain_height;
+	int terrain_width = 0;
+	int terrain_rows = 0;
+
 	// buildable map
-	std::vector<std::map<Point2D, bool, Point2DComparator>> build_map;
+	std::vector<BuildGrid> build_map;
 
 	// map for buildings in progress
 	// it is used to check if the building is under construction after 1 or 2
@@ -678,9 +809,6 @@ private:
 	};
 	std::vector<BuildTask> build_tasks;
 
-	// For managing repairs.
-	std::unordered_set<Tag> scvs_repairing;
-
 	// For guranteeing our mineral generation.
 	std::unordered_set<Tag> scvs_gas;
 
@@ -689,117 +817,10 @@ private:
 	std::vector<sc2::Unit*> ramp_middle = { nullptr, nullptr };
 	const Unit* ramp_mid_destroyed;
 
-	// Map of threat levels for specific anti-air units
-	const std::unordered_map<sc2::UNIT_TYPEID, int> threat_levels = {
-		{sc2::UNIT_TYPEID::TERRAN_MARINE, 1},
-		{sc2::UNIT_TYPEID::TERRAN_GHOST, 1},
-		{sc2::UNIT_TYPEID::TERRAN_CYCLONE, 2},
-		{sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER, 2},
-		{sc2::UNIT_TYPEID::TERRAN_VIKINGASSAULT, 2},
-		{sc2::UNIT_TYPEID::TERRAN_THOR, 5},
-		{sc2::UNIT_TYPEID::TERRAN_MISSILETURRET, 3},
-		{sc2::UNIT_TYPEID::PROTOSS_STALKER, 3},
-		{sc2::UNIT_TYPEID::PROTOSS_SENTRY, 1},
-		{sc2::UNIT_TYPEID::PROTOSS_ARCHON, 3},
-		{sc2::UNIT_TYPEID::PROTOSS_PHOENIX, 2},
-		{sc2::UNIT_TYPEID::PROTOSS_VOIDRAY, 5},
-		{sc2::UNIT_TYPEID::PROTOSS_CARRIER, 3},
-		{sc2::UNIT_TYPEID::PROTOSS_TEMPEST, 2},
-		{sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON, 3},
-		{sc2::UNIT_TYPEID::ZERG_QUEEN, 2},
-		{sc2::UNIT_TYPEID::ZERG_HYDRALISK, 2},
-		{sc2::UNIT_TYPEID::ZERG_RAVAGER, 3},
-		{sc2::UNIT_TYPEID::ZERG_MUTALISK, 2},
-		{sc2::UNIT_TYPEID::ZERG_CORRUPTOR, 4},
-		{sc2::UNIT_TYPEID::ZERG_SPORECRAWLER, 3} };
-
 	bool IsFriendlyStructure(const Unit& unit) const {
-		switch (unit.unit_type.ToType()) {
-		case UNIT_TYPEID::TERRAN_SUPPLYDEPOT:
-			return true;
-		case UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED:
-			return true;
-		case UNIT_TYPEID::TERRAN_COMMANDCENTER:
-			return true;
-		case UNIT_TYPEID::TERRAN_ORBITALCOMMAND:
-			return true;
-		case UNIT_TYPEID::TERRAN_PLANETARYFORTRESS:
-			return true;
-		case UNIT_TYPEID::TERRAN_BARRACKS:
-			return true;
-		case UNIT_TYPEID::TERRAN_FACTORY:
-			return true;
-		case UNIT_TYPEID::TERRAN_STARPORT:
-			return true;
-		case UNIT_TYPEID::TERRAN_ENGINEERINGBAY:
-			return true;
-		case UNIT_TYPEID::TERRAN_ARMORY:
-			return true;
-		case UNIT_TYPEID::TERRAN_FUSIONCORE:
-			return true;
-		case UNIT_TYPEID::TERRAN_MISSILETURRET:
-			return true;
-		case UNIT_TYPEID::TERRAN_BUNKER:
-			return true;
-		case UNIT_TYPEID::TERRAN_TECHLAB:
-			return true;
-		case UNIT_TYPEID::TERRAN_REACTOR:
-			return true;
-		case UNIT_TYPEID::TERRAN_FACTORYTECHLAB:
-			return true;
-		case UNIT_TYPEID::TERRAN_STARPORTTECHLAB:
-			return true;
-		case UNIT_TYPEID::TERRAN_BARRACKSTECHLAB:
-			return true;
-		default:
-			return false;
-		}
+		return friendly_structure_types.Has(unit.unit_type);
 	}
 
-	// Turret types
-	std::vector<UNIT_TYPEID> turret_types = { UNIT_TYPEID::TERRAN_MISSILETURRET,
-											 UNIT_TYPEID::ZERG_SPORECRAWLER,
-											 UNIT_TYPEID::PROTOSS_PHOTONCANNON };
-
-	// Worker types
-	std::vector<UNIT_TYPEID> worker_types = {
-		UNIT_TYPEID::TERRAN_SCV, UNIT_TYPEID::TERRAN_MULE,
-		UNIT_TYPEID::PROTOSS_PROBE, UNIT_TYPEID::ZERG_DRONE };
-
-	// Resource units
-	std::vector<UNIT_TYPEID> resource_units = {
-		UNIT_TYPEID::ZERG_OVERLORD, UNIT_TYPEID::TERRAN_SUPPLYDEPOT,
-		UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED, UNIT_TYPEID::PROTOSS_PYLON };
-
-	// Heavy armored units
-	std::vector<UNIT_TYPEID> heavy_armor_units = {
-		sc2::UNIT_TYPEID::TERRAN_MARAUDER,
-		sc2::UNIT_TYPEID::TERRAN_CYCLONE,
-		sc2::UNIT_TYPEID::TERRAN_SIEGETANK,
-		sc2::UNIT_TYPEID::TERRAN_THOR,
-		sc2::UNIT_TYPEID::TERRAN_BUNKER,
-		sc2::UNIT_TYPEID::PROTOSS_STALKER,
-		sc2::UNIT_TYPEID::PROTOSS_IMMORTAL,
-		sc2::UNIT_TYPEID::PROTOSS_DISRUPTOR,
-		sc2::UNIT_TYPEID::PROTOSS_COLOSSUS,
-		sc2::UNIT_TYPEID::ZERG_ROACH,
-		sc2::UNIT_TYPEID::ZERG_ROACHBURROWED,
-		sc2::UNIT_TYPEID::ZERG_RAVAGER,
-		sc2::UNIT_TYPEID::ZERG_SWARMHOSTMP,
-		sc2::UNIT_TYPEID::ZERG_SWARMHOSTBURROWEDMP,
-		sc2::UNIT_TYPEID::ZERG_LURKERMP,
-		sc2::UNIT_TYPEID::ZERG_LURKERDENMP,
-		sc2::UNIT_TYPEID::ZERG_ULTRALISK,
-		sc2::UNIT_TYPEID::ZERG_ULTRALISKBURROWED };
-
-	// Meele units
-	std::set<UNIT_TYPEID> melee_units = {
-		UNIT_TYPEID::ZERG_DRONE,          UNIT_TYPEID::PROTOSS_PROBE,
-		UNIT_TYPEID::TERRAN_SCV,          UNIT_TYPEID::ZERG_ZERGLING,
-		UNIT_TYPEID::ZERG_BANELING,       UNIT_TYPEID::ZERG_ULTRALISK,
-		UNIT_TYPEID::TERRAN_HELLIONTANK,  UNIT_TYPEID::PROTOSS_ZEALOT,
-		UNIT_TYPEID::PROTOSS_DARKTEMPLAR, UNIT_TYPEID::ZERG_BROODLING };
-
 	// Maps UPGRADE_ID to ABILITY_ID
 	ABILITY_ID GetAbilityForUpgrade(UPGRADE_ID upgrade_id) {
 		switch (upgrade_id) {
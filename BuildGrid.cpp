@@ -0,0 +1,180 @@
+#include "BuildGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sc2;
+
+BuildGrid::BuildGrid() : BuildGrid(0, 0) {}
+
+BuildGrid::BuildGrid(int grid_width, int grid_height)
+	: width(std::max(grid_width, 0)),
+	height(std::max(grid_height, 0)),
+	words_per_row((width + 63) / 64),
+	size(0),
+	map_cells(static_cast<size_t>(words_per_row) * height, 0),
+	free_cells(static_cast<size_t>(words_per_row) * height, 0) {}
+
+bool BuildGrid::ToCell(const Point2D& p, int& x, int& y) const {
+	if (p.x != std::floor(p.x) || p.y != std::floor(p.y)) {
+		return false;
+	}
+	if (p.x < 0 || p.y < 0 || p.x >= width || p.y >= height) {
+		return false;
+	}
+	x = static_cast<int>(p.x);
+	y = static_cast<int>(p.y);
+	return true;
+}
+
+bool BuildGrid::Contains(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+	return (map_cells[y * words_per_row + x / 64] >> (x % 64)) & 1;
+}
+
+bool BuildGrid::Contains(const Point2D& p) const {
+	int x, y;
+	return ToCell(p, x, y) && Contains(x, y);
+}
+
+bool BuildGrid::IsFree(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) {
+		return false;
+	}
+	return (free_cells[y * words_per_row + x / 64] >> (x % 64)) & 1;
+}
+
+bool BuildGrid::IsFree(const Point2D& p) const {
+	int x, y;
+	return ToCell(p, x, y) && IsFree(x, y);
+}
+
+uint64_t BuildGrid::WordMask(int word, int x, int w) {
+	int lo = std::max(x - word * 64, 0);
+	int hi = std::min(x + w - word * 64, 64);
+	if (lo >= hi) {
+		return 0;
+	}
+	uint64_t upper = hi == 64 ? ~uint64_t(0) : (uint64_t(1) << hi) - 1;
+	return upper & ~((uint64_t(1) << lo) - 1);
+}
+
+bool BuildGrid::AreaFree(int x, int y, int w, int h) const {
+	if (w <= 0 || h <= 0) {
+		return true;
+	}
+	if (x < 0 || y < 0 || x + w > width || y + h > height) {
+		return false;
+	}
+	const int first_word = x / 64;
+	const int last_word = (x + w - 1) / 64;
+	for (int row = y; row < y + h; ++row) {
+		const uint64_t* free_row = &free_cells[row * words_per_row];
+		for (int word = first_word; word <= last_word; ++word) {
+			uint64_t mask = WordMask(word, x, w);
+			if ((free_row[word] & mask) != mask) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void BuildGrid::Set(int x, int y, bool is_free) {
+	SetArea(x, y, 1, 1, is_free);
+}
+
+void BuildGrid::Set(const Point2D& p, bool is_free) {
+	int x, y;
+	if (ToCell(p, x, y)) {
+		Set(x, y, is_free);
+	}
+}
+
+void BuildGrid::SetArea(int x, int y, int w, int h, bool is_free) {
+	int x0 = std::max(x, 0);
+	int y0 = std::max(y, 0);
+	int x1 = std::min(x + w, width);
+	int y1 = std::min(y + h, height);
+	if (x0 >= x1 || y0 >= y1) {
+		return;
+	}
+	const int first_word = x0 / 64;
+	const int last_word = (x1 - 1) / 64;
+	for (int row = y0; row < y1; ++row) {
+		uint64_t* in_row = &map_cells[row * words_per_row];
+		uint64_t* free_row = &free_cells[row * words_per_row];
+		for (int word = first_word; word <= last_word; ++word) {
+			uint64_t mask = WordMask(word, x0, x1 - x0);
+			size += CountBits(mask & ~in_row[word]);
+			in_row[word] |= mask;
+			if (is_free) {
+				free_row[word] |= mask;
+			}
+			else {
+				free_row[word] &= ~mask;
+			}
+		}
+	}
+}
+
+void BuildGrid::LoadMapWords(const uint64_t* words) {
+	size = 0;
+	for (size_t i = 0; i < map_cells.size(); ++i) {
+		map_cells[i] = words[i];
+		free_cells[i] = words[i];
+		size += CountBits(words[i]);
+	}
+}
+
+Point2D BuildGrid::Mean() const {
+	// Cell coordinates are small integers, so the float sums are exact
+	Point2D mean;
+	ForEach([&mean](int x, int y, bool) {
+		mean += Point2D(float(x), float(y));
+		});
+	mean /= float(size);
+	return mean;
+}
+
+Point2D BuildGrid::Min() const {
+	Point2D result(static_cast<float>(width), static_cast<float>(height));
+	ForEach([&result](int x, int y, bool) {
+		result.x = std::min(result.x, float(x));
+		result.y = std::min(result.y, float(y));
+		});
+	return result;
+}
+
+Point2D BuildGrid::Max() const {
+	Point2D result(-1.0f, -1.0f);
+	ForEach([&result](int x, int y, bool) {
+		result.x = std::max(result.x, float(x));
+		result.y = std::max(result.y, float(y));
+		});
+	return result;
+}
+
+int BuildGrid::CountTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(bits);
+#else
+	int n = 0;
+	while (!(bits & 1)) {
+		bits >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
+int BuildGrid::CountBits(uint64_t bits) {
+	int n = 0;
+	while (bits) {
+		bits &= bits - 1;
+		++n;
+	}
+	return n;
+}
@@ -0,0 +1,93 @@
+#ifndef BUILD_GRID_H_
+#define BUILD_GRID_H_
+
+#include "sc2api/sc2_common.h"
+
+#include <cstdint>
+#include <vector>
+
+// Dense bit grid over the map for one buildable area, one bit per cell in
+// row-major 64 bit words.
+//
+// Two planes mirror the map it replaces: "in map" for cells that belong to the
+// area (or were touched by a building since), and "free" for cells nothing is
+// built on. A cell is only free if it is in the map.
+class BuildGrid {
+public:
+	BuildGrid();
+	BuildGrid(int grid_width, int grid_height);
+
+	int Width() const { return width; }
+	int Height() const { return height; }
+
+	// Cells in the map
+	size_t Size() const { return size; }
+	bool Empty() const { return size == 0; }
+
+	// Cell of an integral point; false for fractional or out of range points
+	bool ToCell(const sc2::Point2D& p, int& x, int& y) const;
+
+	// True if the cell is in the map
+	bool Contains(int x, int y) const;
+	bool Contains(const sc2::Point2D& p) const;
+
+	// True if the cell is in the map and free
+	bool IsFree(int x, int y) const;
+	bool IsFree(const sc2::Point2D& p) const;
+
+	// True if every cell of the w x h footprint at (x, y) is in the map and free
+	bool AreaFree(int x, int y, int w, int h) const;
+
+	// Adds the cell to the map and marks it free or taken
+	void Set(int x, int y, bool is_free);
+	void Set(const sc2::Point2D& p, bool is_free);
+
+	// Set() for every cell of the w x h footprint at (x, y), clipped to the grid
+	void SetArea(int x, int y, int w, int h, bool is_free);
+
+	// "In map" plane, row by row, for saving the grid
+	const std::vector<uint64_t>& MapWords() const { return map_cells; }
+
+	// Replaces the map with saved MapWords() of a grid of the same size.
+	// Every cell in the map is free.
+	void LoadMapWords(const uint64_t* words);
+
+	// Mean of the cells in the map
+	sc2::Point2D Mean() const;
+
+	// Smallest and largest x and y of the cells in the map
+	sc2::Point2D Min() const;
+	sc2::Point2D Max() const;
+
+	// Calls f(x, y, free) for every cell in the map, row by row
+	template <typename F>
+	void ForEach(F f) const {
+		for (int y = 0; y < height; ++y) {
+			const uint64_t* in_row = &map_cells[y * words_per_row];
+			const uint64_t* free_row = &free_cells[y * words_per_row];
+			for (int w = 0; w < words_per_row; ++w) {
+				uint64_t bits = in_row[w];
+				while (bits) {
+					int bit = CountTrailingZeros(bits);
+					bits &= bits - 1;
+					f(w * 64 + bit, y, ((free_row[w] >> bit) & 1) != 0);
+				}
+			}
+		}
+	}
+
+private:
+	// Bits [x, x + w) of a row, one mask per word
+	static uint64_t WordMask(int word, int x, int w);
+	static int CountTrailingZeros(uint64_t bits);
+	static int CountBits(uint64_t bits);
+
+	int width;
+	int height;
+	int words_per_row;
+	size_t size;
+	std::vector<uint64_t> map_cells;
+	std::vector<uint64_t> free_cells;
+};
+
+#endif
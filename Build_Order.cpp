@@ -4,6 +4,7 @@
 using namespace sc2;
 
 void BasicSc2Bot::ExecuteBuildOrder() {
+	PROFILE_SCOPE("ExecuteBuildOrder");
 	// what do I do if some buildings are destroyed?
 	BuildBarracks();
 	BuildFactory();
@@ -12,25 +13,24 @@ void BasicSc2Bot::ExecuteBuildOrder() {
 	BuildStarport();
 	Swap(swap_a, swap_b, false);
 	BuildFusionCore();
-
-	if (current_gameloop % 46 == 0) {
-		// Building one more battlecruiser might be more helpful??
-		BuildEngineeringBay();
-		// don't need
-		BuildArmory();
-	}
+	// Engineering Bay and Armory are built by the scheduler
 }
 
 // Build Barracks if we have a Supply Depot and enough resources
 void BasicSc2Bot::BuildBarracks() {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Get Supply Depots
-	Units dps = obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return (unit.unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOT ||
-			unit.unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED) &&
-			ALLBuildingsFilter(unit);
+	Units dps = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_SUPPLYDEPOT, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
 		});
+	if (dps.empty()) {
+		dps = units.Select(Unit::Alliance::Self,
+			UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED, [this](const Unit& unit) {
+				return ALLBuildingsFilter(unit);
+			});
+	}
 
 	// Can't built Barracks without Supply Depots
 	if (dps.empty()) {
@@ -47,11 +47,10 @@ void BasicSc2Bot::BuildBarracks() {
 	}
 
 	// Build only 1 Barrack
-	Units barracks =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKS &&
-			ALLBuildingsFilter(unit);
-			});
+	Units barracks = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_BARRACKS, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 
 	// Build Barracks to block ramps at both bases if we have enough resources
 	if (phase < 1) {
@@ -62,7 +61,7 @@ void BasicSc2Bot::BuildBarracks() {
 	}
 	else if (phase == 3) {
 		if (barracks.size() < 2 && bases.size() > 1 && CanBuild(550) &&
-			current_gameloop % 46 == 0) {
+			scheduler.Due(second_barracks_slot, current_gameloop)) {
 			TryBuildStructure(ABILITY_ID::BUILD_BARRACKS,
 				UNIT_TYPEID::TERRAN_SCV);
 		}
@@ -71,16 +70,14 @@ void BasicSc2Bot::BuildBarracks() {
 
 // Build Orbital Command if we have a Command Center and enough resources
 void BasicSc2Bot::BuildOrbitalCommand() {
-	const ObservationInterface* obs = Observation();
-
 	// Can't build Orbital Command without Barracks or Factories
 	if (!num_barracks || !num_factories) {
 		return;
 	}
 
 	// Find a Command Center that can be upgraded
-	Units command_centers = obs->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_COMMANDCENTER));
+	const Units& command_centers =
+		unit_registry.Get(UNIT_TYPEID::TERRAN_COMMANDCENTER);
 
 	if (command_centers.empty()) {
 		return;
@@ -97,7 +94,7 @@ void BasicSc2Bot::BuildOrbitalCommand() {
 		}
 		// If its not upgrading, upgrade it
 		if (!is_upgrading && CanBuild(150)) {
-			Actions()->UnitCommand(cc, ABILITY_ID::MORPH_ORBITALCOMMAND, true);
+			Commands().UnitCommand(cc, ABILITY_ID::MORPH_ORBITALCOMMAND, true);
 			return;
 		}
 	}
@@ -105,7 +102,7 @@ void BasicSc2Bot::BuildOrbitalCommand() {
 
 // Build Factory if we have a Barracks and enough resources
 void BasicSc2Bot::BuildFactory() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Can't build Factory without Barracks
 	if (!num_barracks) {
@@ -121,19 +118,17 @@ void BasicSc2Bot::BuildFactory() {
 	}
 
 	// Build only 1 Factory
-	Units factories =
-		observation->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_FACTORY ||
-			unit.unit_type == UNIT_TYPEID::TERRAN_FACTORYFLYING;
-			});
-	if (factories.empty() && CanBuild(150, 100)) {
+	size_t factories =
+		units.Count(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_FACTORY) +
+		units.Count(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_FACTORYFLYING);
+	if (!factories && CanBuild(150, 100)) {
 		TryBuildStructure(ABILITY_ID::BUILD_FACTORY, UNIT_TYPEID::TERRAN_SCV);
 	}
 }
 
 // Build Starport if we have a Factory and enough resources
 void BasicSc2Bot::BuildStarport() {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Can't build Starports without Factories
 	if (!num_factories) {
@@ -141,13 +136,11 @@ void BasicSc2Bot::BuildStarport() {
 	}
 
 	// Build only 1 Starport
-	Units starports =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_STARPORT ||
-			unit.unit_type == UNIT_TYPEID::TERRAN_STARPORTFLYING;
-			});
+	size_t starports =
+		units.Count(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_STARPORT) +
+		units.Count(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_STARPORTFLYING);
 
-	if (starports.empty() && CanBuild(150, 100)) {
+	if (!starports && CanBuild(150, 100)) {
 		TryBuildStructure(ABILITY_ID::BUILD_STARPORT, UNIT_TYPEID::TERRAN_SCV);
 	}
 }
@@ -155,32 +148,22 @@ void BasicSc2Bot::BuildStarport() {
 // Build Tech lab if we have a Factory and enough resources
 void BasicSc2Bot::BuildAddon() {
 	if (!swap_in_progress) {
-		const ObservationInterface* obs = Observation();
+		const UnitSnapshot& units = Snapshot();
+		const uint8_t no_addon = UnitSnapshot::Flying | UnitSnapshot::HasAddon;
 		// Get Barracks
-		Units barracks =
-			obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKS &&
-				!unit.is_flying && !unit.add_on_tag;
-				});
+		Units barracks = units.OfType(Unit::Alliance::Self,
+			UNIT_TYPEID::TERRAN_BARRACKS, 0, no_addon);
 
 		// Get Factories
-		Units factories =
-			obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_FACTORY &&
-				!unit.is_flying && !unit.add_on_tag;
-				});
+		Units factories = units.OfType(Unit::Alliance::Self,
+			UNIT_TYPEID::TERRAN_FACTORY, 0, no_addon);
 
 		// Get Starports
-		Units starports =
-			obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_STARPORT &&
-				!unit.is_flying && !unit.add_on_tag;
-				});
+		Units starports = units.OfType(Unit::Alliance::Self,
+			UNIT_TYPEID::TERRAN_STARPORT, 0, no_addon);
 
-		Units barracks_techlab =
-			obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKSTECHLAB;
-				});
+		const Units& barracks_techlab = units.OfType(
+			Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
 
 		// use 3 bits to represent buildings without any addons
 		char addon_bits = 0;
@@ -220,7 +203,7 @@ void BasicSc2Bot::BuildAddon() {
 						}
 						// Build addon
 						if (!EnemyNearby(building->pos, true)) {
-							Actions()->UnitCommand(building, build_order);
+							Commands().UnitCommand(building, build_order);
 							break;
 						}
 					}
@@ -234,7 +217,7 @@ void BasicSc2Bot::BuildAddon() {
 
 // Build Fusion Core if we have a Starport and enough resources
 void BasicSc2Bot::BuildFusionCore() {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Can't build fusion core without Starports
 	if (!num_starports || num_fusioncores) {
@@ -242,11 +225,10 @@ void BasicSc2Bot::BuildFusionCore() {
 	}
 
 	// Build only 1 Fusion core
-	Units fusioncore =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_FUSIONCORE &&
-			ALLBuildingsFilter(unit);
-			});
+	Units fusioncore = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_FUSIONCORE, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 
 	if (fusioncore.empty() && CanBuild(150, 125)) {
 		// TODO: reduce this call?
@@ -257,7 +239,7 @@ void BasicSc2Bot::BuildFusionCore() {
 
 // Build Armory if we have a Fusion core and enough resources
 void BasicSc2Bot::BuildArmory() {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Can't build Armory core without the First Battlecruiser
 	if (!first_battlecruiser) {
@@ -265,11 +247,10 @@ void BasicSc2Bot::BuildArmory() {
 	}
 
 	// Build only 1 Armory
-	Units armories =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_ARMORY &&
-			ALLBuildingsFilter(unit);
-			});
+	Units armories = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_ARMORY, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 
 	if (armories.empty() && CanBuild(400 + 150, 300 + 50)) {
 		TryBuildStructure(ABILITY_ID::BUILD_ARMORY, UNIT_TYPEID::TERRAN_SCV);
@@ -278,20 +259,18 @@ void BasicSc2Bot::BuildArmory() {
 
 // Build Engineering bay if we have a Barrack and enough resources
 void BasicSc2Bot::BuildEngineeringBay() {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Get Barracks
-	Units barracks =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKS &&
-			ALLBuildingsFilter(unit);
-			});
+	Units barracks = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_BARRACKS, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 	// Get Startports
-	Units starports =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_STARPORT &&
-			ALLBuildingsFilter(unit);
-			});
+	Units starports = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_STARPORT, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 
 	// Can't build Engineering bay without Barracks
 	if (barracks.empty() || !first_battlecruiser) {
@@ -299,11 +278,10 @@ void BasicSc2Bot::BuildEngineeringBay() {
 	}
 
 	// Build only 1 engineering bay (After Starports)
-	Units engineeringbays =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_ENGINEERINGBAY &&
-			ALLBuildingsFilter(unit);
-			});
+	Units engineeringbays = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_ENGINEERINGBAY, [this](const Unit& unit) {
+			return ALLBuildingsFilter(unit);
+		});
 
 	if (!engineeringbays.size() && !starports.empty() && bases.size() > 1 &&
 		CanBuild(250)) {
@@ -318,8 +296,8 @@ void BasicSc2Bot::Swap(const Unit* a, const Unit* b, bool lift) {
 	// lift buildings
 	if (lift) {
 		swap_in_progress = true;
-		Actions()->UnitCommand(a, ABILITY_ID::LIFT);
-		Actions()->UnitCommand(b, ABILITY_ID::LIFT);
+		Commands().UnitCommand(a, ABILITY_ID::LIFT);
+		Commands().UnitCommand(b, ABILITY_ID::LIFT);
 		swap_a = a;
 		swap_b = b;
 	}
@@ -328,8 +306,8 @@ void BasicSc2Bot::Swap(const Unit* a, const Unit* b, bool lift) {
 			const ObservationInterface* obs = Observation();
 			Point2D swap_position_a = a->pos;
 			Point2D swap_position_b = b->pos;
-			Actions()->UnitCommand(a, ABILITY_ID::LAND, swap_position_b);
-			Actions()->UnitCommand(b, ABILITY_ID::LAND, swap_position_a);
+			Commands().UnitCommand(a, ABILITY_ID::LAND, swap_position_b);
+			Commands().UnitCommand(b, ABILITY_ID::LAND, swap_position_a);
 			swap_in_progress = false;
 		}
 	}
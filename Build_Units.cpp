@@ -3,28 +3,25 @@
 using namespace sc2;
 
 void BasicSc2Bot::ManageProduction() {
+	PROFILE_SCOPE("ManageProduction");
 	// Train units and upgrades
 	TrainMarines();
 	TrainBattlecruisers();
-	if (current_gameloop % 10 == 0)
-	{
-		TrainSiegeTanks();
-	}
 	UpgradeMarines();
 	UpgradeMechs();
 }
 
 void BasicSc2Bot::TrainMarines() {
 	// Find Barracks to train Marines
-	const ObservationInterface* obs = Observation();
-	Units barracks = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_BARRACKS));
-	Units factories = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_FACTORY));
-	Units starport = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_STARPORT));
-	Units reactor = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_BARRACKSREACTOR));
+	const UnitSnapshot& units = Snapshot();
+	const Units& barracks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BARRACKS);
+	const Units& factories =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_FACTORY);
+	const Units& starport =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_STARPORT);
+	const Units& reactor = units.OfType(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_BARRACKSREACTOR);
 
 	if (barracks.empty() ||
 		phase == 0) { // Can't train Marines without Barracks
@@ -49,12 +46,12 @@ void BasicSc2Bot::TrainMarines() {
 			if (b->orders.empty() && !reactor.empty() &&
 				b->add_on_tag == reactor.front()->tag) {
 				if (CanBuild(550)) {
-					Actions()->UnitCommand(b, ABILITY_ID::TRAIN_MARINE, true);
-					Actions()->UnitCommand(b, ABILITY_ID::TRAIN_MARINE, true);
+					Commands().UnitCommand(b, ABILITY_ID::TRAIN_MARINE, true);
+					Commands().UnitCommand(b, ABILITY_ID::TRAIN_MARINE, true);
 				}
 			}
 			else if (b->orders.empty()) {
-				Actions()->UnitCommand(b, ABILITY_ID::TRAIN_MARINE);
+				Commands().UnitCommand(b, ABILITY_ID::TRAIN_MARINE);
 			}
 		}
 	}
@@ -62,14 +59,13 @@ void BasicSc2Bot::TrainMarines() {
 
 void BasicSc2Bot::TrainBattlecruisers() {
 	// Find Starports to build a Battlecruiser
-	const ObservationInterface* obs = Observation();
-	Units starports = obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_STARPORT && unit.tag;
-		});
-	Units fusioncore =
-		obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_FUSIONCORE && unit.tag;
-			});
+	const UnitSnapshot& units = Snapshot();
+	Units starports = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_STARPORT,
+		[](const Unit& unit) { return unit.tag != 0; });
+	Units fusioncore = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_FUSIONCORE,
+		[](const Unit& unit) { return unit.tag != 0; });
 
 	if (starports.empty() || fusioncore.empty()) {
 		return;
@@ -79,7 +75,7 @@ void BasicSc2Bot::TrainBattlecruisers() {
 	if (starport->add_on_tag != 0) {
 		if (starport->orders.empty()) {
 			if (CanBuild(400, 300, 6)) {
-				Actions()->UnitCommand(starport,
+				Commands().UnitCommand(starport,
 					ABILITY_ID::TRAIN_BATTLECRUISER);
 			}
 		}
@@ -97,13 +93,11 @@ void BasicSc2Bot::TrainBattlecruisers() {
 
 void BasicSc2Bot::TrainSiegeTanks() {
 	// Find Factories to train Siege Tanks
-	const ObservationInterface* obs = Observation();
-	Units factories = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_FACTORY));
-	Units starport = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_STARPORT));
-	Units fusioncores = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_FUSIONCORE));
+	const UnitSnapshot& units = Snapshot();
+	const Units& factories =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_FACTORY);
+	const Units& starport =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_STARPORT);
 
 	// Can't train Siege Tanks without Factories
 	if (factories.empty()) {
@@ -115,7 +109,7 @@ void BasicSc2Bot::TrainSiegeTanks() {
 			factory = factories.front();
 			// Maintain 1 : 4 Ratio of Marines and Siege Tanks
 			if (factory->add_on_tag != 0 && factory->orders.empty()) {
-				Actions()->UnitCommand(factory, ABILITY_ID::TRAIN_SIEGETANK);
+				Commands().UnitCommand(factory, ABILITY_ID::TRAIN_SIEGETANK);
 			}
 		}
 		else if (phase == 3) {
@@ -132,20 +126,20 @@ void BasicSc2Bot::TrainSiegeTanks() {
 				factory = factories.front();
 				if (num_starports && ((0.0f < how_close && how_close < 0.5f))) {
 					if (factory->add_on_tag != 0 && factory->orders.empty()) {
-						Actions()->UnitCommand(factory,
+						Commands().UnitCommand(factory,
 							ABILITY_ID::TRAIN_SIEGETANK);
 					}
 				}
 				else if (num_starports && m_close > 0.9f && g_close > 0.9f) {
 
 					if (factory->add_on_tag != 0 && factory->orders.empty()) {
-						Actions()->UnitCommand(factory,
+						Commands().UnitCommand(factory,
 							ABILITY_ID::TRAIN_SIEGETANK);
 					}
 				}
 				else if (!num_starports || !num_fusioncores) {
 					if (factory->add_on_tag != 0 && factory->orders.empty()) {
-						Actions()->UnitCommand(factory,
+						Commands().UnitCommand(factory,
 							ABILITY_ID::TRAIN_SIEGETANK);
 					}
 				}
@@ -156,11 +150,11 @@ void BasicSc2Bot::TrainSiegeTanks() {
 
 void BasicSc2Bot::UpgradeMarines() {
 	// Find Tech Labs and Engineering Bays to upgrade Marines
-	const ObservationInterface* observation = Observation();
-	Units techlabs = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BARRACKSTECHLAB));
-	Units engineeringbays = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_ENGINEERINGBAY));
+	const UnitSnapshot& units = Snapshot();
+	const Units& techlabs = units.OfType(
+		Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BARRACKSTECHLAB);
+	const Units& engineeringbays = units.OfType(
+		Unit::Alliance::Self, UNIT_TYPEID::TERRAN_ENGINEERINGBAY);
 
 	// Can't upgrade Marines without Engineering Bays
 	if (engineeringbays.empty()) {
@@ -188,7 +182,7 @@ void BasicSc2Bot::UpgradeMarines() {
 				// Check if the Tech Lab is busy or not
 				for (const auto& techlab : techlabs) {
 					if (techlab->orders.empty() && CanBuild(100, 450)) {
-						Actions()->UnitCommand(techlab, upgrade);
+						Commands().UnitCommand(techlab, upgrade);
 						return;
 					}
 				}
@@ -198,7 +192,7 @@ void BasicSc2Bot::UpgradeMarines() {
 		// Check if the Engineering Bay is busy or not
 		for (const auto& engineeringbay : engineeringbays) {
 			if (engineeringbay->orders.empty() && CanBuild(200, 200)) {
-				Actions()->UnitCommand(engineeringbay, ability_id);
+				Commands().UnitCommand(engineeringbay, ability_id);
 				return;
 			}
 		}
@@ -207,9 +201,8 @@ void BasicSc2Bot::UpgradeMarines() {
 
 void BasicSc2Bot::UpgradeMechs() {
 	// Find Armories to upgrade Mechs
-	const ObservationInterface* observation = Observation();
-	Units armories = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_ARMORY));
+	const Units& armories = Snapshot().OfType(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_ARMORY);
 
 	// Can't upgrade Mechs(Battlecruisers and Tanks) without Armories
 	// Also, save resources for first Battlecruiser
@@ -233,7 +226,7 @@ void BasicSc2Bot::UpgradeMechs() {
 		// Check if the Armory is busy or not
 		for (const auto& armory : armories) {
 			if (armory->orders.empty() && CanBuild(500, 500)) {
-				Actions()->UnitCommand(armory, ability_id);
+				Commands().UnitCommand(armory, ability_id);
 				return;
 			}
 		}
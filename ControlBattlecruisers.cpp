@@ -1,6 +1,8 @@
 
 #include "BasicSc2Bot.h"
 
+#include <cstring>
+
 using namespace sc2;
 
 // ------------------ Helper Functions ------------------
@@ -12,10 +14,10 @@ void BasicSc2Bot::Retreat(const Unit* unit) {
 	}
 
 	// Retreat location for Battlecruisers
-	battlecruiser_retreat_location[unit] = retreat_location;
-	battlecruiser_retreating[unit] = true;
+	battlecruiser_retreat_location.Set(unit->tag, retreat_location);
+	battlecruiser_retreating.Set(unit->tag, true);
 	if (Distance2D(unit->pos, retreat_location) >= 5.0f) {
-		Actions()->UnitCommand(unit, ABILITY_ID::MOVE_MOVE, retreat_location);
+		Commands().UnitCommand(unit, ABILITY_ID::MOVE_MOVE, retreat_location);
 	}
 }
 
@@ -25,54 +27,102 @@ int BasicSc2Bot::CalculateThreatLevel(const Unit* unit) {
 		return 0;
 	}
 
-	int threat_level = 0;
+	// Sum of the anti-air in range, splatted once per game loop
+	return static_cast<int>(
+		std::lround(AntiAirThreat().Sample(unit->pos)));
+}
 
-	// Detect radius for Battlecruisers
-	const float defense_check_radius = 14.0f;
-	for (const auto& enemy_unit :
-		Observation()->GetUnits(Unit::Alliance::Enemy)) {
-		auto threat = threat_levels.find(enemy_unit->unit_type);
+// Get the closest threat to the Battlecruisers
+const Unit* BasicSc2Bot::GetClosestThreat(const Unit* unit) {
+	if (!unit) { // Null check
+		return nullptr;
+	}
 
-		if (threat != threat_levels.end()) {
-			float distance = Distance2D(unit->pos, enemy_unit->pos);
+	const Unit* target = nullptr;
+	// Threats further away aren't kited
+	const float max_distance = 12.0f;
+	float min_distance = std::numeric_limits<float>::max();
+	float min_hp = std::numeric_limits<float>::max();
 
-			if (distance < defense_check_radius) {
-				threat_level += threat->second;
-			}
+	// Find the closest living threat to the Battlecruisers
+	const EnemyArrays& enemies = Enemies();
+	threat_candidates.clear();
+	enemies.InRadius(unit->pos, max_distance,
+		EnemyArrays::Alive | EnemyArrays::AntiAir, threat_candidates);
+	for (uint32_t index : threat_candidates) {
+		const Unit* enemy_unit = enemies.UnitAt(index);
+		float distance = Distance2D(unit->pos, enemy_unit->pos);
+		if (distance < min_distance ||
+			(distance == min_distance && enemies.Health(index) < min_hp)) {
+			min_distance = distance;
+			min_hp = enemies.Health(index);
+			target = enemy_unit;
 		}
 	}
 
-	return threat_level;
+	return target;
 }
 
-// Get the closest threat to the Battlecruisers
-const Unit* BasicSc2Bot::GetClosestThreat(const Unit* unit) {
+// Pick the target of a Battlecruiser that isn't kiting
+const Unit* BasicSc2Bot::GetBattlecruiserTarget(const Unit* unit,
+	bool avoid_turrets, float max_distance) const {
 	if (!unit) { // Null check
 		return nullptr;
 	}
 
+	// Priority groups, the first one with a unit in range wins:
+	// 1. anti-air units (turrets only if not avoided), 2. workers,
+	// 3. turrets, 4. units that aren't structures, larva or eggs,
+	// 5. supply structures, 6. any structures.
+	// Within a group the closest, then the lowest hp. The key packs the group
+	// above the bits of the distance, which order like the distance itself.
 	const Unit* target = nullptr;
-	constexpr float max_distance = std::numeric_limits<float>::max();
-	float min_distance = max_distance;
+	uint64_t min_key = std::numeric_limits<uint64_t>::max();
 	float min_hp = std::numeric_limits<float>::max();
 
-	// Find the closest threat to the Battlecruisers
-	for (const auto& enemy_unit :
-		Observation()->GetUnits(Unit::Alliance::Enemy)) {
-		// Ensure the enemy unit is alive
+	for (const auto& enemy_unit : Snapshot().All(Unit::Alliance::Enemy)) {
 		if (!enemy_unit->is_alive) {
 			continue;
 		}
-		auto threat = threat_levels.find(enemy_unit->unit_type);
-
-		if (threat != threat_levels.end()) {
-			float distance = Distance2D(unit->pos, enemy_unit->pos);
-			if (distance < min_distance ||
-				(distance == min_distance && enemy_unit->health < min_hp)) {
-				min_distance = distance;
-				min_hp = enemy_unit->health;
-				target = enemy_unit;
-			}
+		float distance = Distance2D(unit->pos, enemy_unit->pos);
+		if (!(distance <= max_distance)) {
+			continue;
+		}
+
+		uint16_t traits = unit_traits.Of(enemy_unit->unit_type);
+		uint64_t group;
+		if (threat_levels[enemy_unit->unit_type] != 0 &&
+			!(avoid_turrets && (traits & UnitTraits::Turret))) {
+			group = 0;
+		}
+		else if (traits & UnitTraits::Worker) {
+			group = 1;
+		}
+		else if (traits & UnitTraits::Turret) {
+			group = 2;
+		}
+		else if (!(traits & UnitTraits::Structure) &&
+			enemy_unit->unit_type != UNIT_TYPEID::ZERG_LARVA &&
+			enemy_unit->unit_type != UNIT_TYPEID::ZERG_EGG) {
+			group = 3;
+		}
+		else if (traits & UnitTraits::SupplyProvider) {
+			group = 4;
+		}
+		else if (traits & UnitTraits::Structure) {
+			group = 5;
+		}
+		else {
+			continue;
+		}
+
+		uint32_t distance_bits;
+		std::memcpy(&distance_bits, &distance, sizeof(distance_bits));
+		uint64_t key = (group << 32) | distance_bits;
+		if (key < min_key || (key == min_key && enemy_unit->health < min_hp)) {
+			min_key = key;
+			min_hp = enemy_unit->health;
+			target = enemy_unit;
 		}
 	}
 
@@ -98,8 +148,11 @@ Point2D BasicSc2Bot::GetKiteVector(const Unit* unit, const Unit* target) {
 		}
 	}
 
-	// Calculate the direction away from the target
-	Point2D kite_direction = unit->pos - target->pos;
+	// Move down the anti-air threat, away from the target where it's flat
+	Point2D kite_direction = AntiAirThreat().Gradient(unit->pos, 7.0f) * -1.0f;
+	if (kite_direction.x == 0.0f && kite_direction.y == 0.0f) {
+		kite_direction = unit->pos - target->pos;
+	}
 
 	// Normalize the kite direction vector
 	float kite_length = std::sqrt(kite_direction.x * kite_direction.x +
@@ -147,8 +200,9 @@ Point2D BasicSc2Bot::GetKiteVector(const Unit* unit, const Unit* target) {
 
 // Main function to control Battlecruisers
 void BasicSc2Bot::ControlBattlecruisers() {
+	PROFILE_SCOPE("ControlBattlecruisers");
 	Jump();
-	TargetBattlecruisers();
+	scheduler.RunIfDue(target_battlecruisers_task, current_gameloop);
 	RetreatCheck();
 }
 
@@ -166,7 +220,7 @@ void BasicSc2Bot::Jump() {
 	// Check if any Battlecruiser is still retreating
 	for (const auto& unit : Observation()->GetUnits(Unit::Alliance::Self)) {
 		if (unit->unit_type == UNIT_TYPEID::TERRAN_BATTLECRUISER &&
-			battlecruiser_retreating[unit]) {
+			battlecruiser_retreating.Get(unit->tag)) {
 			// Wait until all retreating Battlecruisers finish their retreat
 			return;
 		}
@@ -179,13 +233,14 @@ void BasicSc2Bot::Jump() {
 			unit->health >= unit->health_max &&
 			Distance2D(unit->pos, enemy_start_location) > 40.0f &&
 			HasAbility(unit, ABILITY_ID::EFFECT_TACTICALJUMP)) {
-			Actions()->UnitCommand(unit, ABILITY_ID::EFFECT_TACTICALJUMP, enemy_start_location);
+			Commands().UnitCommand(unit, ABILITY_ID::EFFECT_TACTICALJUMP, enemy_start_location);
 		}
 	}
 }
 
 // Target mechanics for Battlecruisers
 void BasicSc2Bot::TargetBattlecruisers() {
+	PROFILE_SCOPE("TargetBattlecruisers");
 
 	// Maximum distance to consider for targetting
 	const float max_distace_for_target = 20.0f;
@@ -199,16 +254,20 @@ void BasicSc2Bot::TargetBattlecruisers() {
 		return;
 	}
 
-	if (current_gameloop % 23 != 0) {
-		return;
-	}
-
 	// Number of Battlecruisers in combat
 	int num_battlecruisers_in_combat = UnitsInCombat(UNIT_TYPEID::TERRAN_BATTLECRUISER);
 
 	// Threshold for "kiting" behavior
 	const int threat_threshold = 10 * num_battlecruisers_in_combat;
 
+	// Count turrets
+	int num_turrets = 0;
+	for (const auto& enemy_unit : Snapshot().All(Unit::Alliance::Enemy)) {
+		if (unit_traits.Has(enemy_unit->unit_type, UnitTraits::Turret)) {
+			num_turrets++;
+		}
+	}
+
 	for (const auto& battlecruiser : battlecruisers) {
 
         // Disables targetting while Jumping
@@ -262,128 +321,25 @@ void BasicSc2Bot::TargetBattlecruisers() {
 						continue;
 					}
 					else {
-						Actions()->UnitCommand(battlecruiser, ABILITY_ID::MOVE_MOVE, GetKiteVector(battlecruiser, target));
+						Commands().UnitCommand(battlecruiser, ABILITY_ID::MOVE_MOVE, GetKiteVector(battlecruiser, target));
 					}
 				}
 			}
 		}
 		// Do not kite if the total threat level is below the threshold
 		else {
-			const Unit* target = nullptr;
-			float min_distance = std::numeric_limits<float>::max();
-			float min_hp = std::numeric_limits<float>::max();
-
-			auto UpdateTarget = [&](const Unit* enemy_unit,
-				float max_distance) {
-					float distance =
-						Distance2D(battlecruiser->pos, enemy_unit->pos);
-					if (!enemy_unit->is_alive || distance > max_distance) {
-						return;
-					}
-					if (distance < min_distance ||
-						(distance == min_distance && enemy_unit->health < min_hp)) {
-						min_distance = distance;
-						min_hp = enemy_unit->health;
-						target = enemy_unit;
-					}
-				};
-
-			// Count turrets
-			int num_turrets = 0;
-			for (const auto& enemy_unit :
-				Observation()->GetUnits(Unit::Alliance::Enemy)) {
-				if (std::find(turret_types.begin(), turret_types.end(),
-					enemy_unit->unit_type) != turret_types.end()) {
-					num_turrets++;
-				}
-			}
-
-			// Prioritize targets based on rules
-			auto PrioritizeTargets = [&](const std::vector<UNIT_TYPEID>& types,
-				float max_distance) {
-					for (const auto& enemy_unit :
-						Observation()->GetUnits(Unit::Alliance::Enemy)) {
-						if (std::find(types.begin(), types.end(),
-							enemy_unit->unit_type) != types.end()) {
-							UpdateTarget(enemy_unit, max_distance);
-						}
-					}
-				};
-
-			// 1st Priority: Enemy units (excluding turrets based on turret
-			// conditions)
-			for (const auto& enemy_unit :
-				Observation()->GetUnits(Unit::Alliance::Enemy)) {
-				auto threat = threat_levels.find(enemy_unit->unit_type);
-				if (threat != threat_levels.end()) {
-					if (std::find(turret_types.begin(), turret_types.end(),
-						enemy_unit->unit_type) !=
-						turret_types.end()) {
-						// Avoid turrets when conditions apply
-						if (num_turrets >= 2 * num_battlecruisers_in_combat ||
-							total_threat - (3 * num_turrets) != 0) {
-							continue;
-						}
-					}
-					UpdateTarget(enemy_unit, max_distace_for_target);
-				}
-			}
-
-			if (!target) {
-				PrioritizeTargets(worker_types, max_distace_for_target);
-			}
-
-			// 3rd Priority -> Turrets
-			if (!target) {
-				PrioritizeTargets(turret_types, max_distace_for_target);
-			}
-
-			// 4th Priority -> Any units that are not structures
-			if (!target) {
-				for (const auto& enemy_unit :
-					Observation()->GetUnits(Unit::Alliance::Enemy)) {
-					const UnitTypeData& unit_type_data =
-						Observation()->GetUnitTypeData().at(
-							enemy_unit->unit_type);
-					if (!std::any_of(unit_type_data.attributes.begin(),
-						unit_type_data.attributes.end(),
-						[](Attribute attr) {
-							return attr == Attribute::Structure;
-						}) &&
-						enemy_unit->unit_type != UNIT_TYPEID::ZERG_LARVA &&
-							enemy_unit->unit_type != UNIT_TYPEID::ZERG_EGG) {
-						UpdateTarget(enemy_unit, max_distace_for_target);
-					}
-				}
-			}
-
-			// 5th Priority -> Supply structures
-			if (!target) {
-				PrioritizeTargets(resource_units, max_distace_for_target);
-			}
-
-			// 6th Priority -> Any structures
-			if (!target) {
-				for (const auto& enemy_unit :
-					Observation()->GetUnits(Unit::Alliance::Enemy)) {
-					const UnitTypeData& unit_type_data =
-						Observation()->GetUnitTypeData().at(
-							enemy_unit->unit_type);
-					if (std::any_of(unit_type_data.attributes.begin(),
-						unit_type_data.attributes.end(),
-						[](Attribute attr) {
-							return attr == Attribute::Structure;
-						})) {
-						UpdateTarget(enemy_unit, max_distace_for_target);
-					}
-				}
-			}
+			// Turrets are only attacked once they are the only threat
+			bool avoid_turrets =
+				num_turrets >= 2 * num_battlecruisers_in_combat ||
+				total_threat - (3 * num_turrets) != 0;
+			const Unit* target = GetBattlecruiserTarget(battlecruiser,
+				avoid_turrets, max_distace_for_target);
 
 			// Attack the selected target
 			if (target && target->NotCloaked) {
 				// No turret nearby or turret is the target or there are only
 				// turrets in threat radius -> Attack
-				Actions()->UnitCommand(battlecruiser, ABILITY_ID::ATTACK_ATTACK,
+				Commands().UnitCommand(battlecruiser, ABILITY_ID::ATTACK_ATTACK,
 					target);
 			}
 		}
@@ -397,12 +353,12 @@ void BasicSc2Bot::RetreatCheck() {
 	for (const auto& battlecruiser : Observation()->GetUnits(
 		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BATTLECRUISER))) {
 		// Check if the Battlecruiser has reached the retreat location
-		if (battlecruiser_retreating[battlecruiser] &&
+		if (battlecruiser_retreating.Get(battlecruiser->tag) &&
 			Distance2D(battlecruiser->pos, retreat_location) <=
 			arrival_threshold &&
 			battlecruiser->health >= 550.0f) {
-			battlecruiser_retreat_location.erase(battlecruiser);
-			battlecruiser_retreating[battlecruiser] = false;
+			battlecruiser_retreat_location.Erase(battlecruiser->tag);
+			battlecruiser_retreating.Erase(battlecruiser->tag);
 		}
 	}
 }
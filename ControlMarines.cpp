@@ -58,28 +58,10 @@ const Unit* BasicSc2Bot::GetClosestTarget(const Unit* unit) {
 		return nullptr;
 	}
 
-	const Unit* target = nullptr;
-	float min_distance = std::numeric_limits<float>::max();
-
-	// Find the closest enemy
-	for (const auto& enemy_unit :
-		Observation()->GetUnits(Unit::Alliance::Enemy)) {
-		// Skip invalid or dead units
-		if (!enemy_unit || !enemy_unit->is_alive) {
-			continue;
-		}
-
-		// Calculate distance to the enemy unit
-		float distance_to_enemy = Distance2D(unit->pos, enemy_unit->pos);
-
-		// Find the closest unit
-		if (distance_to_enemy < min_distance && distance_to_enemy < 13.0f) {
-			min_distance = distance_to_enemy;
-			target = enemy_unit;
-		}
-	}
-
-	return target;
+	// Find the closest enemy within 13, skip dead units
+	const EnemyArrays& enemies = Enemies();
+	int nearest = enemies.Nearest(unit->pos, 13.0f, EnemyArrays::Alive);
+	return nearest < 0 ? nullptr : enemies.UnitAt(nearest);
 }
 
 // Move Marine to a new position to perform kite
@@ -97,13 +79,14 @@ void BasicSc2Bot::KiteMarine(const Unit* marine, const Unit* target,
 
 	// Move the Marine to the new position
 	Point2D new_position = marine->pos + direction * distance;
-	Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE, new_position);
+	Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE, new_position);
 }
 
 // ------------------ Main Functions ------------------
 
 // Main function to control Marines
 void BasicSc2Bot::ControlMarines() {
+	PROFILE_SCOPE("ControlMarines");
 	KillScouts();
 	TargetMarines();
 }
@@ -128,7 +111,7 @@ void BasicSc2Bot::KillScouts() {
 			Distance2D(enemy_unit->pos, start_location) <= 15.0f) {
 			for (const auto& marine : marines) {
 				if (marine->orders.empty()) {
-					Actions()->UnitCommand(marine, ABILITY_ID::ATTACK_ATTACK,
+					Commands().UnitCommand(marine, ABILITY_ID::ATTACK_ATTACK,
 						enemy_unit);
 				}
 			}
@@ -159,7 +142,7 @@ void BasicSc2Bot::TargetMarines() {
 		if (target) {
 			// Check if the target is a melee unit
 			bool is_melee =
-				melee_units.find(target->unit_type) != melee_units.end();
+				unit_traits.Has(target->unit_type, UnitTraits::Melee);
 
 			if (IsNearRamp(marine)) {
 				marine_vision = 8.0f;
@@ -175,7 +158,7 @@ void BasicSc2Bot::TargetMarines() {
 
 			// Attack whenever possible
 			if (marine->weapon_cooldown == 0.0f) {
-				Actions()->UnitCommand(marine, ABILITY_ID::ATTACK_ATTACK,
+				Commands().UnitCommand(marine, ABILITY_ID::ATTACK_ATTACK,
 					target);
 			}
 			// Do not Kite if the ramp is intact and the Marine is near the ramp
@@ -189,16 +172,8 @@ void BasicSc2Bot::TargetMarines() {
 				}
 				else {
 					// Check if the target is ranged but not a structure
-					const UnitTypeData& target_type_data =
-						Observation()->GetUnitTypeData().at(target->unit_type);
-					bool is_structure = false;
-
-					for (const auto& attribute : target_type_data.attributes) {
-						if (attribute == Attribute::Structure) {
-							is_structure = true;
-							break;
-						}
-					}
+					bool is_structure = unit_traits.Has(target->unit_type,
+						UnitTraits::Structure);
 
 					// Advance if the target is ranged and not a structure
 					if (!is_structure &&
@@ -2,15 +2,13 @@
 
 // Main function to control SCVs
 void BasicSc2Bot::ControlSCVs() {
+	PROFILE_SCOPE("ControlSCVs");
 	SCVScoutEnemySpawn();
 	RetreatFromDanger();
 	UpdateRepairingSCVs();
 	RepairUnits();
 	RepairStructures();
 	UpdateRepairingSCVs();
-	if (current_gameloop % 23 == 0) {
-		SCVAttackEmergency();
-	}
 }
 
 // SCVs scout the map to find enemy bases
@@ -90,12 +88,13 @@ void BasicSc2Bot::SCVScoutEnemySpawn() {
 
 					// harvest mineral if a mineral patch is found
 					if (closest_mineral && scv_scout) {
-						Actions()->UnitCommand(scv_scout,
+						Commands().UnitCommand(scv_scout,
 							ABILITY_ID::HARVEST_GATHER,
 							closest_mineral);
 					}
 
 					// Mark scouting as complete
+					worker_roles.ReleaseAll(WorkerRoles::Scout);
 					scv_scout = nullptr;
 					is_scouting = false;
 					scout_complete = true;
@@ -108,13 +107,14 @@ void BasicSc2Bot::SCVScoutEnemySpawn() {
 			current_scout_location_index++;
 			// All locations have been checked. Mark scouting as complete
 			if (current_scout_location_index >= enemy_start_locations.size()) {
+				worker_roles.ReleaseAll(WorkerRoles::Scout);
 				scv_scout = nullptr;
 				is_scouting = false;
 				scout_complete = true;
 				return;
 			}
 			// Scout to the next location
-			Actions()->UnitCommand(
+			Commands().UnitCommand(
 				scv_scout, sc2::ABILITY_ID::MOVE_MOVE,
 				enemy_start_locations[current_scout_location_index]);
 		}
@@ -122,10 +122,10 @@ void BasicSc2Bot::SCVScoutEnemySpawn() {
 	else {
 		// Assign an SCV to scout when no SCVs are scouting
 		for (const auto& scv : scvs) {
-			Units gas_scvs = GetAllSCVsGettingGas();
-			auto it = FindInVector(gas_scvs, scv);
-			if (scv->orders.empty() && it == gas_scvs.end()) {
+			if (scv->orders.empty() &&
+				!worker_roles.Has(scv->tag, WorkerRoles::Gas)) {
 				scv_scout = scv;
+				worker_roles.Assign(scv, WorkerRoles::Scout);
 				is_scouting = true;
 				current_scout_location_index =
 					0; // Start from the first location
@@ -134,7 +134,7 @@ void BasicSc2Bot::SCVScoutEnemySpawn() {
 				scout_location = scv->pos;
 
 				// Command SCV to move to the initial possible enemy location
-				Actions()->UnitCommand(
+				Commands().UnitCommand(
 					scv_scout, sc2::ABILITY_ID::MOVE_MOVE,
 					enemy_start_locations[current_scout_location_index]);
 				break;
@@ -160,7 +160,7 @@ void BasicSc2Bot::RetreatFromDanger() {
 				}
 			}
 			if (scv_is_attacking || unit->health == unit->health_max ||
-				scvs_repairing.find(unit->tag) != scvs_repairing.end()) {
+				worker_roles.Has(unit->tag, WorkerRoles::RepairCrew)) {
 				continue; // Skip SCVs that are currently attacking, are full
 				// hp, or reparing
 			}
@@ -170,7 +170,7 @@ void BasicSc2Bot::RetreatFromDanger() {
 				/*if (current_gameloop % 24 == 0)
 					std::cout << "Retreating SCV" << std::endl;*/
 				Point2D safe_position = GetNearestSafePosition(unit->pos);
-				Actions()->UnitCommand(unit, ABILITY_ID::MOVE_MOVE,
+				Commands().UnitCommand(unit, ABILITY_ID::MOVE_MOVE,
 					safe_position);
 			}
 		}
@@ -185,9 +185,7 @@ void BasicSc2Bot::RepairUnits() {
 	const Unit* target = FindDamagedUnit();
 
 	if (target) {
-		for (const auto& scv_tag : scvs_repairing) {
-			const Unit* scv = Observation()->GetUnit(scv_tag);
-
+		for (const auto& scv : worker_roles.Get(WorkerRoles::RepairCrew)) {
 			// Skip if the SCV is invalid
 			if (!scv || !scv->is_alive) {
 				continue;
@@ -207,7 +205,7 @@ void BasicSc2Bot::RepairUnits() {
 			bool is_at_base =
 				sc2::Distance2D(target->pos, start_location) <= base_radius;
 			if (is_at_base && !is_repairing) {
-				Actions()->UnitCommand(scv, ABILITY_ID::EFFECT_REPAIR, target);
+				Commands().UnitCommand(scv, ABILITY_ID::EFFECT_REPAIR, target);
 			}
 		}
 	}
@@ -219,9 +217,7 @@ void BasicSc2Bot::RepairStructures() {
 
 	// Repair the target if it is at the base
 	if (target) {
-		for (const auto& scv_tag : scvs_repairing) {
-			const Unit* scv = Observation()->GetUnit(scv_tag);
-
+		for (const auto& scv : worker_roles.Get(WorkerRoles::RepairCrew)) {
 			// Skip if the SCV is invalid
 			if (!scv || !scv->is_alive) {
 				continue;
@@ -239,7 +235,7 @@ void BasicSc2Bot::RepairStructures() {
 
 			// Skip SCV if it is already repairing
 			if (!is_repairing) {
-				Actions()->UnitCommand(scv, ABILITY_ID::EFFECT_REPAIR, target);
+				Commands().UnitCommand(scv, ABILITY_ID::EFFECT_REPAIR, target);
 			}
 		}
 	}
@@ -252,25 +248,22 @@ void BasicSc2Bot::UpdateRepairingSCVs() {
 
 	Units scvs =
 		obs->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV));
-	Units scvs_gas = GetAllSCVsGettingGas();
 
 	// Add SCVs to the repairing set
 	for (const auto& scv : scvs) {
-		if (scvs_repairing.size() < 6) {
+		if (worker_roles.Count(WorkerRoles::RepairCrew) < 6) {
 			// Make sure it's not a gathering SCV
-			auto it = FindInVector(scvs_gas, scv);
-			if (it != scvs_gas.end()) {
+			if (worker_roles.Has(scv->tag, WorkerRoles::Gas)) {
 				continue;
 			}
 			else {
-				scvs_repairing.insert(scv->tag);
+				worker_roles.Assign(scv, WorkerRoles::RepairCrew);
 			}
 		}
 	}
 
 	// Make repairing SCVs gather if there are no damaged units
-	for (const auto& scv_tag : scvs_repairing) {
-		const Unit* scv = obs->GetUnit(scv_tag);
+	for (const auto& scv : worker_roles.Get(WorkerRoles::RepairCrew)) {
 		// Skip dead or invalid SCVs
 		if (!scv || !scv->is_alive) {
 			continue;
@@ -291,7 +284,7 @@ void BasicSc2Bot::UpdateRepairingSCVs() {
 					if (closest_mineral) {
 						/*std::cout << "Returning SCV to close mineral" <<
 						 * std::endl;*/
-						Actions()->UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
+						Commands().UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
 							closest_mineral);
 					}
 				}
@@ -319,7 +312,7 @@ void BasicSc2Bot::SCVAttackEmergency() {
 				Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV));
 			for (const auto& scv : scvs) {
 				// Only use SCVs that have the repair tag
-				if (scvs_repairing.find(scv->tag) != scvs_repairing.end()) {
+				if (worker_roles.Has(scv->tag, WorkerRoles::RepairCrew)) {
 					// Ensure SCV does not move too far from the main base
 					if (Distance2D(scv->pos, main_base->pos) >
 						max_distance_from_base) {
@@ -335,7 +328,7 @@ void BasicSc2Bot::SCVAttackEmergency() {
 						if (scvs_sent > max_scvs_to_send) {
 							break;
 						}
-						Actions()->UnitCommand(scv, ABILITY_ID::ATTACK, target);
+						Commands().UnitCommand(scv, ABILITY_ID::ATTACK, target);
 					}
 				}
 			}
@@ -11,32 +11,21 @@ bool BasicSc2Bot::SiegeTankInCombat(const Unit* unit) {
 	}
 	// Detect radius of the Siege Tank
 	const float enemy_detection_radius = 13.5f;
-	bool enemy_nearby = false;
 	// Check for nearby enemies within the detection radius
-	for (const auto& enemy_unit :
-		Observation()->GetUnits(Unit::Alliance::Enemy)) {
-
-		// Skip trivial and worker units
-		if (IsTrivialUnit(enemy_unit) || IsWorkerUnit(enemy_unit)) {
-			continue;
-		}
-
-		// Calculate distance to enemy
-		float distance_to_enemy = Distance2D(unit->pos, enemy_unit->pos);
-		if (distance_to_enemy <= enemy_detection_radius) {
-			enemy_nearby = true;
-			break;
-		}
-	}
-	return enemy_nearby;
+	// Skip trivial and worker units
+	return EnemyGrid().AnyInRadius(unit->pos, enemy_detection_radius,
+		[this](const Unit* enemy_unit) {
+			return !IsTrivialUnit(enemy_unit) && !IsWorkerUnit(enemy_unit);
+		}, true);
 }
 
 // ------------------ Main Functions ------------------
 
 // Main function to control Siege Tanks
 void BasicSc2Bot::ControlSiegeTanks() {
+	PROFILE_SCOPE("ControlSiegeTanks");
 	SiegeMode();
-	TargetSiegeTank();
+	scheduler.RunIfDue(target_siege_tank_task, current_gameloop);
 }
 
 // Transform Siege Tanks to Siege Mode or Unsiege
@@ -54,24 +43,21 @@ void BasicSc2Bot::SiegeMode() {
 	// Siege Tanks in combat should be in Siege Mode
 	for (const auto& tank : siege_tanks) {
 		if (SiegeTankInCombat(tank)) {
-			Actions()->UnitCommand(tank, ABILITY_ID::MORPH_SIEGEMODE);
+			Commands().UnitCommand(tank, ABILITY_ID::MORPH_SIEGEMODE);
 		}
 	}
 	// Siege Tanks not in combat should be Unsieged
 	for (const auto& tank : siege_tanks_sieged) {
 		if (!SiegeTankInCombat(tank)) {
-			Actions()->UnitCommand(tank, ABILITY_ID::MORPH_UNSIEGE);
+			Commands().UnitCommand(tank, ABILITY_ID::MORPH_UNSIEGE);
 		}
 	}
 }
 
 // Target mechanics for Siege Tanks
 void BasicSc2Bot::TargetSiegeTank() {
+	PROFILE_SCOPE("TargetSiegeTank");
 
-	if (current_gameloop % 10 != 0)
-	{
-		return;
-	}
 	// Get all Siege Tanks
 	const Units siege_tanks_sieged = Observation()->GetUnits(
 		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SIEGETANKSIEGED));
@@ -80,15 +66,21 @@ void BasicSc2Bot::TargetSiegeTank() {
 		return;
 	}
 
+	// Get all enemy units
+	const SpatialGrid& enemies = EnemyGrid();
+	const Units& enemy_units = enemies.AllUnits();
+
+	// Enemies within 1.25 of each enemy, computed once for all the tanks
+	const std::vector<uint32_t> packed_counts = enemies.NeighborCounts(1.25f);
+
 	for (const auto& siege_tank : siege_tanks_sieged) {
 
 		// Initialize variables to find the best target
 		const Unit* best_target = nullptr;
 		float best_score = -1.0f;
 
-		// Get all enemy units
-		for (const auto& enemy_unit :
-			Observation()->GetUnits(Unit::Alliance::Enemy)) {
+		for (size_t i = 0; i < enemy_units.size(); ++i) {
+			const Unit* enemy_unit = enemy_units[i];
 			// Skip invalid or dead units
 
 			if (!enemy_unit || !enemy_unit->is_alive) {
@@ -99,21 +91,13 @@ void BasicSc2Bot::TargetSiegeTank() {
 			float score = 0.0f;
 
 			// 1. Priority: Heavy Armor (e.g., Stalkers, Marauiders...etc)
-			if (std::find(heavy_armor_units.begin(), heavy_armor_units.end(),
-				enemy_unit->unit_type) != heavy_armor_units.end()) {
+			if (unit_traits.Has(enemy_unit->unit_type, UnitTraits::HeavyArmor)) {
 				score += 200.0f;
 			}
 
 			// 2. Priority: Packed Enemies (AOE Potential)
-			int packed_count = 0;
-
-			for (const auto& nearby_enemy :
-				Observation()->GetUnits(Unit::Alliance::Enemy)) {
-				if (nearby_enemy != enemy_unit &&
-					Distance2D(enemy_unit->pos, nearby_enemy->pos) < 1.25f) {
-					packed_count++;
-				}
-			}
+			int packed_count = static_cast<int>(packed_counts[i]);
+
 			// Add 10 points for each nearby enemy
 			score += packed_count * 10.0f;
 
@@ -121,8 +105,7 @@ void BasicSc2Bot::TargetSiegeTank() {
 			// Tank damage is 40(Light) or 70(Armored) in Siege Mode
 			float health_difference = 0.0f;
 
-			if (std::find(heavy_armor_units.begin(), heavy_armor_units.end(),
-				enemy_unit->unit_type) != heavy_armor_units.end()) {
+			if (unit_traits.Has(enemy_unit->unit_type, UnitTraits::HeavyArmor)) {
 				health_difference =
 					std::abs((enemy_unit->health + enemy_unit->shield) - 70.0f);
 			}
@@ -146,7 +129,7 @@ void BasicSc2Bot::TargetSiegeTank() {
 
 		// Issue attack command if a valid target is found
 		if (best_target) {
-			Actions()->UnitCommand(siege_tank, ABILITY_ID::ATTACK, best_target);
+			Commands().UnitCommand(siege_tank, ABILITY_ID::ATTACK, best_target);
 		}
 	}
 }
\ No newline at end of file
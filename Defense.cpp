@@ -2,10 +2,9 @@
 
 // Defense Management
 void BasicSc2Bot::Defense() {
+	PROFILE_SCOPE("Defense");
 	EarlyDefense();
-	if (current_gameloop % 42 == 0) {
-		LateDefense();
-	}
+	scheduler.RunIfDue(late_defense_task, current_gameloop);
 }
 
 void BasicSc2Bot::EarlyDefense() {
@@ -49,7 +48,7 @@ void BasicSc2Bot::EarlyDefense() {
 	for (const auto& marine : marines) {
 		if (marine->orders.empty() ||
 			marine->orders.front().ability_id != ABILITY_ID::ATTACK) {
-			Actions()->UnitCommand(marine, ABILITY_ID::ATTACK,
+			Commands().UnitCommand(marine, ABILITY_ID::ATTACK,
 				primary_target ? primary_target->pos
 				: enemy_units.front()->pos);
 		}
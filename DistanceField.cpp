@@ -0,0 +1,108 @@
+#include "DistanceField.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace sc2;
+
+namespace {
+const float far_away = 1e20f;
+}
+
+DistanceField::DistanceField(float cell_size)
+	: cell_size(cell_size), inv_cell_size(1.0f / cell_size),
+	// Half a cell diagonal at each end, plus room for float rounding
+	max_error(cell_size * 1.4143f + 0.01f), width(0), height(0),
+	any_units(false), built_loop(0), built(false) {}
+
+void DistanceField::Build(const Units& units, int map_width, int map_height,
+	uint32_t game_loop) {
+	built_loop = game_loop;
+	built = true;
+
+	width = std::max(1, static_cast<int>(std::ceil(map_width * inv_cell_size)));
+	height =
+		std::max(1, static_cast<int>(std::ceil(map_height * inv_cell_size)));
+	squared.assign(static_cast<size_t>(width) * height, far_away);
+	any_units = false;
+	for (const auto& unit : units) {
+		if (!unit) {
+			continue;
+		}
+		int cx = std::min(std::max(static_cast<int>(unit->pos.x *
+			inv_cell_size), 0), width - 1);
+		int cy = std::min(std::max(static_cast<int>(unit->pos.y *
+			inv_cell_size), 0), height - 1);
+		squared[static_cast<size_t>(cy) * width + cx] = 0.0f;
+		any_units = true;
+	}
+	if (!any_units) {
+		return;
+	}
+
+	// Columns, then rows; the result is exact in cell units
+	for (int x = 0; x < width; ++x) {
+		Transform(&squared[x], height, width);
+	}
+	for (int y = 0; y < height; ++y) {
+		Transform(&squared[static_cast<size_t>(y) * width], width, 1);
+	}
+}
+
+void DistanceField::Transform(float* values, int n, int stride) {
+	line.resize(n);
+	hull.resize(n);
+	bounds.resize(n + 1);
+	for (int i = 0; i < n; ++i) {
+		line[i] = values[i * stride];
+	}
+
+	// Lower envelope of the parabolas rooted at the cells that have a unit
+	// in reach; the others add nothing
+	int k = -1;
+	for (int q = 0; q < n; ++q) {
+		if (line[q] >= far_away) {
+			continue;
+		}
+		float s = 0.0f;
+		while (k >= 0) {
+			int p = hull[k];
+			s = ((line[q] + q * q) - (line[p] + p * p)) / (2.0f * (q - p));
+			if (s > bounds[k]) {
+				break;
+			}
+			--k;
+		}
+		++k;
+		hull[k] = q;
+		bounds[k] = k == 0 ? -std::numeric_limits<float>::max() : s;
+		bounds[k + 1] = std::numeric_limits<float>::max();
+	}
+	if (k < 0) {
+		return;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; ++q) {
+		while (bounds[k + 1] < q) {
+			++k;
+		}
+		int p = hull[k];
+		values[q * stride] = static_cast<float>((q - p) * (q - p)) + line[p];
+	}
+}
+
+bool DistanceField::Distance(const Point2D& pos, float& distance) const {
+	if (!any_units || pos.x < 0.0f || pos.y < 0.0f) {
+		return false;
+	}
+	int cx = static_cast<int>(pos.x * inv_cell_size);
+	int cy = static_cast<int>(pos.y * inv_cell_size);
+	if (cx >= width || cy >= height) {
+		return false;
+	}
+	distance = std::sqrt(squared[static_cast<size_t>(cy) * width + cx]) *
+		cell_size;
+	return true;
+}
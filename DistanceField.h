@@ -0,0 +1,60 @@
+#ifndef DISTANCE_FIELD_H_
+#define DISTANCE_FIELD_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <vector>
+
+// Distance from every cell of a coarse grid over the map to the nearest of a
+// set of units, rebuilt once per game loop by an exact Euclidean distance
+// transform (two passes of the lower envelope of parabolas).
+//
+// Units and lookups are snapped to cell centers, so a lookup is off from the
+// true distance by at most MaxError(). Callers that need the exact answer
+// only have to check points whose distance is that close to their limit.
+class DistanceField {
+public:
+	explicit DistanceField(float cell_size = 2.0f);
+
+	// Rebuilds the field over a map of the given size
+	void Build(const sc2::Units& units, int map_width, int map_height,
+		uint32_t game_loop);
+
+	// True if the field was built for the given game loop
+	bool IsBuiltFor(uint32_t game_loop) const {
+		return built && game_loop == built_loop;
+	}
+
+	// Distance from pos to the nearest unit, within MaxError(). False if pos
+	// is off the map or there are no units.
+	bool Distance(const sc2::Point2D& pos, float& distance) const;
+
+	float MaxError() const { return max_error; }
+
+private:
+	// One pass of the 1D squared distance transform over n values spaced
+	// stride apart
+	void Transform(float* values, int n, int stride);
+
+	float cell_size;
+	float inv_cell_size;
+	float max_error;
+	int width;
+	int height;
+	bool any_units;
+
+	// Squared distances in cells, x + y * width
+	std::vector<float> squared;
+
+	// Scratch space of Transform
+	std::vector<float> line;
+	std::vector<int> hull;
+	std::vector<float> bounds;
+
+	uint32_t built_loop;
+	bool built;
+};
+
+#endif
@@ -3,14 +3,11 @@
 using namespace sc2;
 
 void BasicSc2Bot::ManageEconomy() {
+	PROFILE_SCOPE("ManageEconomy");
 	TrainSCVs();
 	AssignWorkers();
 	TryBuildSupplyDepot();
 	BuildRefineries();
-	if (current_gameloop % 25 == 0) {
-		IsBuilderGettingDamaged();
-		IsBuildingProgress();
-	}
 	BuildExpansion();
 	ReassignWorkers();
 	UseMULE();
@@ -18,10 +15,12 @@ void BasicSc2Bot::ManageEconomy() {
 }
 
 void BasicSc2Bot::TrainSCVs() {
+	PROFILE_SCOPE("TrainSCVs");
 	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Get all bases
-	Units command_centers = obs->GetUnits(Unit::Alliance::Self, IsTownHall());
+	const Units& command_centers = units.TownHalls(Unit::Alliance::Self);
 	if (command_centers.empty())
 		return;
 
@@ -35,15 +34,13 @@ void BasicSc2Bot::TrainSCVs() {
 	desired_scv_count += 5; // Additional SCVs for building and contingency
 
 	// If we have enough SCVs, return
-	Units scvs =
-		obs->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV));
-	if (scvs.size() >= desired_scv_count)
+	if (unit_registry.Count(UNIT_TYPEID::TERRAN_SCV) >= desired_scv_count)
 		return;
 
 	// Get all completed Supply Depots
-	Units dps = obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOT &&
-			!(unit.build_progress < 0.5f);
+	Units dps = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_SUPPLYDEPOT, [](const Unit& unit) {
+			return !(unit.build_progress < 0.5f);
 		});
 
 	// Ensure we have enough supply
@@ -66,17 +63,17 @@ void BasicSc2Bot::TrainSCVs() {
 			}
 		}
 		if (!is_training_scv && obs->GetMinerals() >= 50) {
-			Actions()->UnitCommand(cc, ABILITY_ID::TRAIN_SCV);
+			Commands().UnitCommand(cc, ABILITY_ID::TRAIN_SCV);
 		}
 	}
 }
 
 void BasicSc2Bot::UseMULE() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Find all Orbital Commands
-	Units orbital_commands = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_ORBITALCOMMAND));
+	const Units& orbital_commands = units.OfType(
+		Unit::Alliance::Self, UNIT_TYPEID::TERRAN_ORBITALCOMMAND);
 
 	// No Orbital Commands found
 	if (orbital_commands.empty()) {
@@ -96,8 +93,8 @@ void BasicSc2Bot::UseMULE() {
 	for (const auto& orbital : orbital_commands) {
 		if (orbital->energy >= energy_cost) {
 			// Find the nearest mineral patch to the Orbital Command
-			Units mineral_patches = observation->GetUnits(
-				Unit::Alliance::Neutral, IsMineralPatch());
+			Units mineral_patches =
+				units.Select(Unit::Alliance::Neutral, IsMineralPatch());
 			const Unit* closest_mineral = nullptr;
 			float min_distance = std::numeric_limits<float>::max();
 
@@ -111,7 +108,7 @@ void BasicSc2Bot::UseMULE() {
 
 			// use MULE on nearest mineral patch
 			if (closest_mineral) {
-				Actions()->UnitCommand(orbital, ABILITY_ID::EFFECT_CALLDOWNMULE,
+				Commands().UnitCommand(orbital, ABILITY_ID::EFFECT_CALLDOWNMULE,
 					closest_mineral);
 				return;
 			}
@@ -120,11 +117,11 @@ void BasicSc2Bot::UseMULE() {
 }
 
 void BasicSc2Bot::UseScan() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Find all Orbital Commands
-	Units orbital_commands = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_ORBITALCOMMAND));
+	const Units& orbital_commands = units.OfType(
+		Unit::Alliance::Self, UNIT_TYPEID::TERRAN_ORBITALCOMMAND);
 
 	// No Orbital Commands found
 	if (orbital_commands.empty()) {
@@ -132,7 +129,7 @@ void BasicSc2Bot::UseScan() {
 	}
 
 	// Find all cloacked enemies
-	Units enemies = observation->GetUnits(Unit::Alliance::Enemy);
+	const Units& enemies = units.All(Unit::Alliance::Enemy);
 	const Unit* cloacked_enemy = nullptr;
 	for (const auto& enemy : enemies) {
 		if (enemy->cloak == 1) {
@@ -146,7 +143,7 @@ void BasicSc2Bot::UseScan() {
 		// Loop Orbital Command to check if it has enough energy
 		for (const auto& orbital : orbital_commands) {
 			if (orbital->energy >= energy_cost) {
-				Actions()->UnitCommand(orbital, ABILITY_ID::EFFECT_SCAN,
+				Commands().UnitCommand(orbital, ABILITY_ID::EFFECT_SCAN,
 					cloacked_enemy->pos);
 			}
 		}
@@ -155,7 +152,7 @@ void BasicSc2Bot::UseScan() {
 
 bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 	UNIT_TYPEID unit_type) {
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 	if (!CanBuild(100)) {
 		return false; // Not enough minerals to build
 	}
@@ -167,9 +164,8 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 	const float distance_from_minerals = 10.0f;
 
 	// Find an SCV to build with
-	Units scvs =
-		obs->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV));
-	Units scvs_gas = GetAllSCVsGettingGas();
+	const Units& scvs =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SCV);
 
 	// Check if we have a builder
 	const Unit* builder = nullptr;
@@ -181,9 +177,8 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 		// Check if the SCV is scv_scout
 		// Check if the SCV is a gas harvester
 		// Check if the SCV is already repairing
-		auto it = FindInVector(scvs_gas, scv);
-		if (scv == scv_scout || it != scvs_gas.end() ||
-			scvs_repairing.find(scv->tag) != scvs_repairing.end() ||
+		if (worker_roles.Has(scv->tag, WorkerRoles::Scout | WorkerRoles::Gas |
+			WorkerRoles::RepairCrew) ||
 			IsHoldingGas) {
 			continue;
 		}
@@ -231,10 +226,11 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 					continue;
 				}
 				if (!EnemyNearby(mainBase_depot_points[i], false) &&
-					Query()->Placement(ABILITY_ID::BUILD_SUPPLYDEPOT,
+					placement_planner.CanPlace(Query(), current_gameloop,
+						ABILITY_ID::BUILD_SUPPLYDEPOT,
 						mainBase_depot_points[i])) {
 					scv_building = builder;
-					Actions()->UnitCommand(builder, ability_type_for_structure,
+					Commands().UnitCommand(builder, ability_type_for_structure,
 						mainBase_depot_points[i], true);
 					return true;
 				}
@@ -245,18 +241,17 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 		}
 
 		else if (ability_type_for_structure == ABILITY_ID::BUILD_BARRACKS) {
-			Units barracks =
-				obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-				return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKS &&
-					ALLBuildingsFilter(unit);
-					});
+			Units barracks = units.Select(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_BARRACKS, [this](const Unit& unit) {
+					return ALLBuildingsFilter(unit);
+				});
 
 			if (barracks.size() < 2) {
 				// check if ramp is blocked
 				if (phase == 0) {
-					if (Query()->Placement(ABILITY_ID::BUILD_BARRACKS,
-						mainBase_barrack_point)) {
-						Actions()->UnitCommand(scv_building,
+					if (placement_planner.CanPlace(Query(), current_gameloop,
+						ABILITY_ID::BUILD_BARRACKS, mainBase_barrack_point)) {
+						Commands().UnitCommand(scv_building,
 							ability_type_for_structure,
 							mainBase_barrack_point, true);
 						return true;
@@ -269,7 +264,7 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 						ramp_mid_destroyed->unit_type ==
 						UNIT_TYPEID::TERRAN_BARRACKS &&
 						!EnemyNearby(mainBase_barrack_point, false)) {
-						Actions()->UnitCommand(scv_building,
+						Commands().UnitCommand(scv_building,
 							ability_type_for_structure,
 							mainBase_barrack_point, true);
 						return true;
@@ -278,16 +273,10 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 					// possibly
 					else {
 						// if addons are still there, build around the addons
-						Units addons_t = obs->GetUnits(
-							Unit::Alliance::Self, [](const Unit& unit) {
-								return unit.unit_type ==
-									UNIT_TYPEID::TERRAN_TECHLAB;
-							});
-						Units addons_r = obs->GetUnits(
-							Unit::Alliance::Self, [](const Unit& unit) {
-								return unit.unit_type ==
-									UNIT_TYPEID::TERRAN_REACTOR;
-							});
+						Units addons_t = units.OfType(
+							Unit::Alliance::Self, UNIT_TYPEID::TERRAN_TECHLAB);
+						const Units& addons_r = units.OfType(
+							Unit::Alliance::Self, UNIT_TYPEID::TERRAN_REACTOR);
 						addons_t.insert(addons_t.end(), addons_r.begin(),
 							addons_r.end());
 
@@ -297,9 +286,10 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 							Point2D tl_p = Point2D(tl->pos);
 							tl_p = Point2D(tl_p.x - 2.5f, tl_p.y + 0.5f);
 							if (!EnemyNearby(tl_p, false) &&
-								Query()->Placement(ability_type_for_structure,
+								placement_planner.CanPlace(Query(),
+									current_gameloop, ability_type_for_structure,
 									tl_p)) {
-								Actions()->UnitCommand(
+								Commands().UnitCommand(
 									builder, ability_type_for_structure, tl_p);
 								return true;
 							}
@@ -312,11 +302,10 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 			}
 		}
 		else if (ability_type_for_structure == ABILITY_ID::BUILD_FACTORY) {
-			Units factory =
-				obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-				return unit.unit_type == UNIT_TYPEID::TERRAN_FACTORY &&
-					ALLBuildingsFilter(unit);
-					});
+			Units factory = units.Select(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_FACTORY, [this](const Unit& unit) {
+					return ALLBuildingsFilter(unit);
+				});
 			if (factory.empty()) {
 				// check if ramp is blocked
 				if (phase < 2) {
@@ -328,7 +317,7 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 					ramp_mid_destroyed->unit_type ==
 					UNIT_TYPEID::TERRAN_FACTORY &&
 					!EnemyNearby(mainBase_barrack_point)) {
-					Actions()->UnitCommand(scv_building,
+					Commands().UnitCommand(scv_building,
 						ability_type_for_structure,
 						mainBase_barrack_point, true);
 					return true;
@@ -336,20 +325,18 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 				// this factory is not a ramp building but it was destroyed
 				// possibly
 				else {
-					Units addons_t = obs->GetUnits(
-						Unit::Alliance::Self, [](const Unit& unit) {
-							return unit.unit_type ==
-								UNIT_TYPEID::TERRAN_TECHLAB;
-						});
+					const Units& addons_t = units.OfType(
+						Unit::Alliance::Self, UNIT_TYPEID::TERRAN_TECHLAB);
 					const Unit* tl;
 					if (!addons_t.empty()) {
 						tl = addons_t.front();
 						Point2D tl_p = Point2D(tl->pos);
 						tl_p = Point2D(tl_p.x - 2.5f, tl_p.y + 0.5f);
 						if (!EnemyNearby(tl_p, false) &&
-							Query()->Placement(ability_type_for_structure,
+							placement_planner.CanPlace(Query(),
+								current_gameloop, ability_type_for_structure,
 								tl_p)) {
-							Actions()->UnitCommand(
+							Commands().UnitCommand(
 								builder, ability_type_for_structure, tl_p);
 							return true;
 						}
@@ -360,11 +347,10 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 			}
 		}
 		else if (ability_type_for_structure == ABILITY_ID::BUILD_STARPORT) {
-			Units starport =
-				obs->GetUnits(Unit::Alliance::Self, [this](const Unit& unit) {
-				return unit.unit_type == UNIT_TYPEID::TERRAN_STARPORT &&
-					ALLBuildingsFilter(unit);
-					});
+			Units starport = units.Select(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_STARPORT, [this](const Unit& unit) {
+					return ALLBuildingsFilter(unit);
+				});
 			if (starport.empty()) {
 				// check if ramp is blocked
 				if (phase == 2) {
@@ -375,20 +361,18 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 
 				// after phase 2, this means possibly starport is destroyed
 				else {
-					Units addons_t = obs->GetUnits(
-						Unit::Alliance::Self, [](const Unit& unit) {
-							return unit.unit_type ==
-								UNIT_TYPEID::TERRAN_TECHLAB;
-						});
+					const Units& addons_t = units.OfType(
+						Unit::Alliance::Self, UNIT_TYPEID::TERRAN_TECHLAB);
 					const Unit* tl;
 					if (!addons_t.empty()) {
 						tl = addons_t.front();
 						Point2D tl_p = Point2D(tl->pos);
 						tl_p = Point2D(tl_p.x - 2.5f, tl_p.y + 0.5f);
 						if (!EnemyNearby(tl_p, false) &&
-							Query()->Placement(ability_type_for_structure,
+							placement_planner.CanPlace(Query(),
+								current_gameloop, ability_type_for_structure,
 								tl_p)) {
-							Actions()->UnitCommand(
+							Commands().UnitCommand(
 								builder, ability_type_for_structure, tl_p);
 							return true;
 						}
@@ -409,6 +393,7 @@ bool BasicSc2Bot::TryBuildStructure(ABILITY_ID ability_type_for_structure,
 }
 
 bool BasicSc2Bot::TryBuildSupplyDepot() {
+	PROFILE_SCOPE("TryBuildSupplyDepot");
 	// Get supply used and supply cap
 	const ObservationInterface* obs = Observation();
 	int32_t supply_used = obs->GetFoodUsed();
@@ -425,8 +410,9 @@ bool BasicSc2Bot::TryBuildSupplyDepot() {
 	}
 
 	// block ramp right while building barracks
-	Units barracks = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_BARRACKS));
+	const UnitSnapshot& units = Snapshot();
+	const Units& barracks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BARRACKS);
 	if (ramp_depots[0] && phase == 0 && !barracks.empty()) {
 		if (!ramp_depots[1]) {
 			return TryBuildStructure(ABILITY_ID::BUILD_SUPPLYDEPOT,
@@ -447,12 +433,11 @@ bool BasicSc2Bot::TryBuildSupplyDepot() {
 	// Build a supply depot when supply used reaches the threshold
 	if (supply_used >= supply_cap - supply_surplus) {
 		// Check if a supply depot is already under construction
-		Units supply_depots_building =
-			obs->GetUnits(Unit::Self, [this](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOT &&
-				(!unit.tag || unit.build_progress < 1.0f ||
-					unit.display_type == 4);
-				});
+		Units supply_depots_building = units.Select(Unit::Self,
+			UNIT_TYPEID::TERRAN_SUPPLYDEPOT, [](const Unit& unit) {
+				return !unit.tag || unit.build_progress < 1.0f ||
+					unit.display_type == 4;
+			});
 
 		if (phase != 3) {
 			if (supply_depots_building.empty()) {
@@ -463,7 +448,7 @@ bool BasicSc2Bot::TryBuildSupplyDepot() {
 		}
 		else if (phase == 3) {
 			if (supply_depots_building.size() < 2 &&
-				current_gameloop % 50 == 0) {
+				scheduler.Due(late_depot_slot, current_gameloop)) {
 				return TryBuildStructure(ABILITY_ID::BUILD_SUPPLYDEPOT,
 					UNIT_TYPEID::TERRAN_SCV);
 			}
@@ -473,29 +458,25 @@ bool BasicSc2Bot::TryBuildSupplyDepot() {
 }
 
 void BasicSc2Bot::AssignWorkers() {
-	const ObservationInterface* obs = Observation();
+	PROFILE_SCOPE("AssignWorkers");
+	const UnitSnapshot& units = Snapshot();
 
 	// Get idle SCVs
-	Units idle_scvs = obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_SCV && unit.orders.empty();
+	Units idle_scvs = units.OfType(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_SCV, UnitSnapshot::Idle);
+
+	Units scvs_not_holding = units.Select(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_SCV, [](const Unit& unit) {
+			return !unit.orders.empty() &&
+				unit.orders.front().ability_id ==
+				ABILITY_ID::HARVEST_GATHER &&
+				unit.buffs.empty();
 		});
 
-	Units scvs_not_holding =
-		obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_SCV &&
-			!unit.orders.empty() &&
-			unit.orders.front().ability_id ==
-			ABILITY_ID::HARVEST_GATHER &&
-			unit.buffs.empty();
-			});
-
 	// Get bases and refineries
-	Units bases = obs->GetUnits(Unit::Alliance::Self, IsTownHall());
-	Units refineries =
-		obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-		return unit.unit_type == UNIT_TYPEID::TERRAN_REFINERY &&
-			unit.build_progress == 1.0f;
-			});
+	const Units& bases = units.TownHalls(Unit::Alliance::Self);
+	Units refineries = units.OfType(Unit::Alliance::Self,
+		UNIT_TYPEID::TERRAN_REFINERY, UnitSnapshot::Completed);
 
 	// Keep track of workers per refinery
 	std::map<const Unit*, int> refinery_worker_count;
@@ -508,7 +489,7 @@ void BasicSc2Bot::AssignWorkers() {
 	std::map<const Unit*, Units> base_minerals_map;
 	for (const auto& base : bases) {
 		Units nearby_minerals =
-			obs->GetUnits(Unit::Alliance::Neutral, [base](const Unit& unit) {
+			units.Select(Unit::Alliance::Neutral, [base](const Unit& unit) {
 			return IsMineralPatch()(unit) &&
 				Distance2D(unit.pos, base->pos) < 10.0f;
 				});
@@ -518,8 +499,8 @@ void BasicSc2Bot::AssignWorkers() {
 		// Assign idle SCVs to tasks
 		for (const auto& scv : idle_scvs) {
 			// Skip SCVs that are scouting or repairing
-			if (scv == scv_scout ||
-				scvs_repairing.find(scv->tag) != scvs_repairing.end()) {
+			if (worker_roles.Has(scv->tag,
+				WorkerRoles::Scout | WorkerRoles::RepairCrew)) {
 				continue;
 			}
 
@@ -534,7 +515,7 @@ void BasicSc2Bot::AssignWorkers() {
 				}
 			}
 			if (target_refinery) {
-				Actions()->UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
+				Commands().UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
 					target_refinery);
 				continue;
 			}
@@ -542,7 +523,7 @@ void BasicSc2Bot::AssignWorkers() {
 			// Assign SCV to the nearest mineral patch
 			const Unit* closest_mineral = FindNearestMineralPatch();
 			if (closest_mineral) {
-				Actions()->UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
+				Commands().UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
 					closest_mineral);
 			}
 		}
@@ -550,8 +531,8 @@ void BasicSc2Bot::AssignWorkers() {
 	else if (!refineries.empty() && idle_scvs.empty()) {
 		for (const auto& scv : scvs_not_holding) {
 			// Skip SCVs that are scouting or repairing
-			if (scv == scv_scout ||
-				scvs_repairing.find(scv->tag) != scvs_repairing.end()) {
+			if (worker_roles.Has(scv->tag,
+				WorkerRoles::Scout | WorkerRoles::RepairCrew)) {
 				continue;
 			}
 
@@ -567,7 +548,7 @@ void BasicSc2Bot::AssignWorkers() {
 			}
 			if (target_refinery) {
 				if (Distance2D(scv->pos, target_refinery->pos) < 15.0f) {
-					Actions()->UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
+					Commands().UnitCommand(scv, ABILITY_ID::HARVEST_GATHER,
 						target_refinery);
 				}
 				continue;
@@ -577,11 +558,12 @@ void BasicSc2Bot::AssignWorkers() {
 }
 
 void BasicSc2Bot::ReassignWorkers() {
-	const ObservationInterface* obs = Observation();
+	PROFILE_SCOPE("ReassignWorkers");
+	const UnitSnapshot& units = Snapshot();
 
-	Units bases = obs->GetUnits(Unit::Alliance::Self, IsTownHall());
-	Units refineries = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_REFINERY));
+	const Units& bases = units.TownHalls(Unit::Alliance::Self);
+	const Units& refineries =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_REFINERY);
 
 	// Collect under-saturated and over-saturated bases
 	std::vector<const Unit*> under_saturated_bases;
@@ -606,12 +588,11 @@ void BasicSc2Bot::ReassignWorkers() {
 		int excess_workers =
 			over_base->assigned_harvesters - over_base->ideal_harvesters;
 
-		Units workers_at_base =
-			obs->GetUnits(Unit::Alliance::Self, [over_base](const Unit& unit) {
-			return unit.unit_type == UNIT_TYPEID::TERRAN_SCV &&
-				!unit.orders.empty() &&
-				Distance2D(unit.pos, over_base->pos) < 10.0f;
-				});
+		Units workers_at_base = units.Select(Unit::Alliance::Self,
+			UNIT_TYPEID::TERRAN_SCV, [over_base](const Unit& unit) {
+				return !unit.orders.empty() &&
+					Distance2D(unit.pos, over_base->pos) < 10.0f;
+			});
 
 		for (int i = 0; i < excess_workers && i < workers_at_base.size(); ++i) {
 			const Unit* worker = workers_at_base[i];
@@ -631,7 +612,7 @@ void BasicSc2Bot::ReassignWorkers() {
 			if (closest_base) {
 				// Assign worker to a mineral patch near the under-saturated
 				// base
-				Units minerals = obs->GetUnits(
+				Units minerals = units.Select(
 					Unit::Alliance::Neutral, [closest_base](const Unit& unit) {
 						return IsMineralPatch()(unit) &&
 							Distance2D(unit.pos, closest_base->pos) < 10.0f;
@@ -645,7 +626,7 @@ void BasicSc2Bot::ReassignWorkers() {
 								Distance2D(worker->pos, b->pos);
 						});
 
-					Actions()->UnitCommand(worker, ABILITY_ID::HARVEST_GATHER,
+					Commands().UnitCommand(worker, ABILITY_ID::HARVEST_GATHER,
 						closest_mineral);
 				}
 			}
@@ -658,10 +639,9 @@ void BasicSc2Bot::ReassignWorkers() {
 			refinery->assigned_harvesters - refinery->ideal_harvesters;
 
 		if (excess_workers > 0) {
-			Units gas_workers = obs->GetUnits(
-				Unit::Alliance::Self, [refinery](const Unit& unit) {
-					return unit.unit_type == UNIT_TYPEID::TERRAN_SCV &&
-						!unit.orders.empty() &&
+			Units gas_workers = units.Select(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_SCV, [refinery](const Unit& unit) {
+					return !unit.orders.empty() &&
 						unit.orders.front().target_unit_tag == refinery->tag;
 				});
 
@@ -669,10 +649,8 @@ void BasicSc2Bot::ReassignWorkers() {
 				const Unit* worker = gas_workers[i];
 
 				// Assign worker to the closest mineral patch
-				Units minerals = obs->GetUnits(
-					Unit::Alliance::Neutral, [worker](const Unit& unit) {
-						return IsMineralPatch()(unit);
-					});
+				Units minerals =
+					units.Select(Unit::Alliance::Neutral, IsMineralPatch());
 
 				if (!minerals.empty()) {
 					const Unit* closest_mineral = *std::min_element(
@@ -682,7 +660,7 @@ void BasicSc2Bot::ReassignWorkers() {
 								Distance2D(worker->pos, b->pos);
 						});
 
-					Actions()->UnitCommand(worker, ABILITY_ID::HARVEST_GATHER,
+					Commands().UnitCommand(worker, ABILITY_ID::HARVEST_GATHER,
 						closest_mineral);
 				}
 			}
@@ -691,44 +669,40 @@ void BasicSc2Bot::ReassignWorkers() {
 }
 
 void BasicSc2Bot::BuildRefineries() {
+	PROFILE_SCOPE("BuildRefineries");
 
 	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 	Units cc = bases;
 
 	// Build refineries near each base
 	for (const auto& base : cc) {
 		Units geysers =
-			obs->GetUnits(Unit::Alliance::Neutral, [base](const Unit& unit) {
+			units.Select(Unit::Alliance::Neutral, [base](const Unit& unit) {
 			return IsGeyser()(unit) &&
 				Distance2D(unit.pos, base->pos) < 15.0f;
 				});
 
 		// Build a refinery on top of each geyser
 		for (const auto& geyser : geysers) {
-			Units refineries =
-				obs->GetUnits(Unit::Alliance::Self, [geyser](const Unit& unit) {
-				return unit.unit_type == UNIT_TYPEID::TERRAN_REFINERY &&
-					Distance2D(unit.pos, geyser->pos) < 1.0f;
-					});
-			Units barracks =
-				obs->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
-				return unit.unit_type == UNIT_TYPEID::TERRAN_BARRACKS &&
-					unit.build_progress < 1.0f;
-					});
+			Units refineries = units.Select(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_REFINERY, [geyser](const Unit& unit) {
+					return Distance2D(unit.pos, geyser->pos) < 1.0f;
+				});
+			size_t barracks = units.Count(Unit::Alliance::Self,
+				UNIT_TYPEID::TERRAN_BARRACKS, 0, UnitSnapshot::Completed);
 
 			// Check if a refinery is already being built
 			if (refineries.empty() && obs->GetMinerals() >= 75 &&
-				(!barracks.empty() || phase)) {
-				Units scvs = obs->GetUnits(Unit::Alliance::Self,
-					IsUnit(UNIT_TYPEID::TERRAN_SCV));
-				Units scvs_gas = GetAllSCVsGettingGas();
+				(barracks || phase)) {
+				const Units& scvs = units.OfType(Unit::Alliance::Self,
+					UNIT_TYPEID::TERRAN_SCV);
 				const Unit* builder = nullptr;
 
 				// Find an idle SCV to build the refinery
 				for (const auto& scv : scvs) {
-					auto it = FindInVector(scvs_gas, scv);
-					if (scvs_repairing.find(scv->tag) != scvs_repairing.end() ||
-						it != scvs_gas.end()) {
+					if (worker_roles.Has(scv->tag,
+						WorkerRoles::RepairCrew | WorkerRoles::Gas)) {
 						continue;
 					}
 					bool is_constructing = false;
@@ -744,8 +718,8 @@ void BasicSc2Bot::BuildRefineries() {
 					}
 
 					// Check if the SCV is idle (has no orders)
-					if (!is_constructing && scv != scv_scout &&
-						scvs_repairing.find(scv->tag) == scvs_repairing.end()) {
+					if (!is_constructing &&
+						!worker_roles.Has(scv->tag, WorkerRoles::Scout)) {
 						builder = scv;
 						break;
 					}
@@ -755,7 +729,7 @@ void BasicSc2Bot::BuildRefineries() {
 				if (builder) {
 					if (Query()->Placement(ABILITY_ID::BUILD_REFINERY,
 						geyser->pos)) {
-						Actions()->UnitCommand(
+						Commands().UnitCommand(
 							builder, ABILITY_ID::BUILD_REFINERY, geyser);
 					}
 				}
@@ -765,7 +739,8 @@ void BasicSc2Bot::BuildRefineries() {
 }
 
 void BasicSc2Bot::BuildExpansion() {
-	const ObservationInterface* observation = Observation();
+	PROFILE_SCOPE("BuildExpansion");
+	const UnitSnapshot& units = Snapshot();
 
 	// Check if the first battlecruiser is in production
 	if (!first_battlecruiser) {
@@ -784,7 +759,7 @@ void BasicSc2Bot::BuildExpansion() {
 
 	// Check if a Command Center is already being built
 	Units command_centers_building =
-		observation->GetUnits(Unit::Self, [](const Unit& unit) {
+		units.Select(Unit::Self, [](const Unit& unit) {
 		return (unit.unit_type == UNIT_TYPEID::TERRAN_COMMANDCENTER ||
 			unit.unit_type == UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING ||
 			unit.unit_type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND ||
@@ -808,18 +783,16 @@ void BasicSc2Bot::BuildExpansion() {
 		return; // Don't expand to a location that's under threat
 	}
 
-	Units scvs = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_SCV));
-	Units scvs_gas = GetAllSCVsGettingGas();
+	const Units& scvs =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SCV);
 	const Unit* builder = nullptr;
 
 	// Find an idle SCV to build the expansion
 	for (const auto& scv : scvs) {
-		// Skip SCVs that are in the scvs_repairing set
+		// Skip SCVs that are in the repair crew
 		// Check if the SCV is a gatherer
-		auto it = FindInVector(scvs_gas, scv);
-		if (scvs_repairing.find(scv->tag) != scvs_repairing.end() ||
-			it != scvs_gas.end()) {
+		if (worker_roles.Has(scv->tag,
+			WorkerRoles::RepairCrew | WorkerRoles::Gas)) {
 			continue;
 		}
 
@@ -834,7 +807,7 @@ void BasicSc2Bot::BuildExpansion() {
 		if (!EnemyNearby(next_expansion, false, 20) &&
 			Query()->Placement(ABILITY_ID::BUILD_COMMANDCENTER,
 				next_expansion)) {
-			Actions()->UnitCommand(builder, ABILITY_ID::BUILD_COMMANDCENTER,
+			Commands().UnitCommand(builder, ABILITY_ID::BUILD_COMMANDCENTER,
 				next_expansion);
 		}
 		return;
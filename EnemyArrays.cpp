@@ -0,0 +1,242 @@
+#include "EnemyArrays.h"
+#include "TypeTables.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ENEMY_ARRAYS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENEMY_ARRAYS_SSE2
+#endif
+
+using namespace sc2;
+
+namespace {
+
+// Padding coordinate, its squared distance to any map point overflows to
+// infinity so it is never in range
+const float far_away = 1e30f;
+
+#if defined(ENEMY_ARRAYS_SSE2)
+// Keeps the entries of four lanes that are strictly closer than best. SSE2
+// has no blend, so the selects are done with masks.
+inline void NearestStep(const float* x, const float* y, const uint32_t* flags,
+	__m128 px, __m128 py, __m128i want, __m128i index, __m128& best,
+	__m128i& best_index) {
+	__m128 dx = _mm_sub_ps(_mm_loadu_ps(x), px);
+	__m128 dy = _mm_sub_ps(_mm_loadu_ps(y), py);
+	__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+	__m128i has = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(
+		reinterpret_cast<const __m128i*>(flags)), want), want);
+	__m128 closer = _mm_and_ps(_mm_cmplt_ps(d2, best), _mm_castsi128_ps(has));
+	__m128i closer_index = _mm_castps_si128(closer);
+	best = _mm_or_ps(_mm_and_ps(closer, d2), _mm_andnot_ps(closer, best));
+	best_index = _mm_or_si128(_mm_and_si128(closer_index, index),
+		_mm_andnot_si128(closer_index, best_index));
+}
+#endif
+
+int CountBits(unsigned mask) {
+	int count = 0;
+	while (mask) {
+		mask &= mask - 1;
+		++count;
+	}
+	return count;
+}
+
+}
+
+void EnemyArrays::Build(const Units& source, uint32_t game_loop) {
+	built_loop = game_loop;
+	built = true;
+
+	units.assign(source.begin(), source.end());
+	size_t padded = (units.size() + block - 1) / block * block;
+	x.assign(padded, far_away);
+	y.assign(padded, far_away);
+	health.assign(padded, 0.0f);
+	shield.assign(padded, 0.0f);
+	type.assign(padded, 0);
+	flags.assign(padded, 0);
+
+	for (size_t i = 0; i < units.size(); ++i) {
+		const Unit* unit = units[i];
+		x[i] = unit->pos.x;
+		y[i] = unit->pos.y;
+		health[i] = unit->health;
+		shield[i] = unit->shield;
+		type[i] = static_cast<uint32_t>(unit->unit_type);
+		uint32_t unit_flags = 0;
+		if (unit->is_alive) {
+			unit_flags |= Alive;
+		}
+		if (!trivial_types.Has(unit->unit_type)) {
+			unit_flags |= NonTrivial;
+		}
+		if (threat_levels[unit->unit_type] != 0) {
+			unit_flags |= AntiAir;
+		}
+		flags[i] = unit_flags;
+	}
+}
+
+unsigned EnemyArrays::BlockMask(size_t start, float px, float py,
+	float radius_sq, uint32_t wanted) const {
+#if defined(ENEMY_ARRAYS_AVX2)
+	__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&x[start]), _mm256_set1_ps(px));
+	__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&y[start]), _mm256_set1_ps(py));
+	__m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+	__m256 in_range = _mm256_cmp_ps(d2, _mm256_set1_ps(radius_sq), _CMP_LE_OQ);
+	__m256i want = _mm256_set1_epi32(static_cast<int>(wanted));
+	__m256i has = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(
+		reinterpret_cast<const __m256i*>(&flags[start])), want), want);
+	return static_cast<unsigned>(_mm256_movemask_ps(
+		_mm256_and_ps(in_range, _mm256_castsi256_ps(has))));
+#elif defined(ENEMY_ARRAYS_SSE2)
+	unsigned mask = 0;
+	for (size_t half = 0; half < block; half += 4) {
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(&x[start + half]), _mm_set1_ps(px));
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(&y[start + half]), _mm_set1_ps(py));
+		__m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		__m128 in_range = _mm_cmple_ps(d2, _mm_set1_ps(radius_sq));
+		__m128i want = _mm_set1_epi32(static_cast<int>(wanted));
+		__m128i has = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(&flags[start + half])), want), want);
+		mask |= static_cast<unsigned>(_mm_movemask_ps(
+			_mm_and_ps(in_range, _mm_castsi128_ps(has)))) << half;
+	}
+	return mask;
+#else
+	unsigned mask = 0;
+	for (size_t lane = 0; lane < block; ++lane) {
+		float dx = x[start + lane] - px;
+		float dy = y[start + lane] - py;
+		if (dx * dx + dy * dy <= radius_sq &&
+			(flags[start + lane] & wanted) == wanted) {
+			mask |= 1u << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+size_t EnemyArrays::CountInRadius(const Point2D& pos, float radius,
+	uint32_t wanted) const {
+	size_t count = 0;
+	float radius_sq = radius * radius;
+	for (size_t start = 0; start < x.size(); start += block) {
+		count += CountBits(BlockMask(start, pos.x, pos.y, radius_sq, wanted));
+	}
+	return count;
+}
+
+bool EnemyArrays::AnyInRadius(const Point2D& pos, float radius,
+	uint32_t wanted) const {
+	float radius_sq = radius * radius;
+	for (size_t start = 0; start < x.size(); start += block) {
+		if (BlockMask(start, pos.x, pos.y, radius_sq, wanted)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void EnemyArrays::InRadius(const Point2D& pos, float radius, uint32_t wanted,
+	std::vector<uint32_t>& out) const {
+	float radius_sq = radius * radius;
+	for (size_t start = 0; start < x.size(); start += block) {
+		unsigned mask = BlockMask(start, pos.x, pos.y, radius_sq, wanted);
+		for (uint32_t lane = 0; mask; ++lane, mask >>= 1) {
+			if (mask & 1) {
+				out.push_back(static_cast<uint32_t>(start) + lane);
+			}
+		}
+	}
+}
+
+int EnemyArrays::Nearest(const Point2D& pos, float max_distance,
+	uint32_t wanted) const {
+	// Closest distance and index seen by each lane. A lane only takes
+	// strictly closer units, so it keeps the first of equal ones.
+	float best[block];
+	int32_t best_index[block];
+	float max_sq = max_distance * max_distance;
+#if defined(ENEMY_ARRAYS_AVX2)
+	__m256 px = _mm256_set1_ps(pos.x);
+	__m256 py = _mm256_set1_ps(pos.y);
+	__m256i want = _mm256_set1_epi32(static_cast<int>(wanted));
+	__m256 lane_best = _mm256_set1_ps(max_sq);
+	__m256i lane_index = _mm256_set1_epi32(-1);
+	__m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i step = _mm256_set1_epi32(static_cast<int>(block));
+	for (size_t start = 0; start < x.size(); start += block) {
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&x[start]), px);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&y[start]), py);
+		__m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+		__m256i has = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(&flags[start])), want), want);
+		__m256 closer = _mm256_and_ps(_mm256_cmp_ps(d2, lane_best, _CMP_LT_OQ),
+			_mm256_castsi256_ps(has));
+		lane_best = _mm256_blendv_ps(lane_best, d2, closer);
+		lane_index = _mm256_castps_si256(_mm256_blendv_ps(
+			_mm256_castsi256_ps(lane_index), _mm256_castsi256_ps(index), closer));
+		index = _mm256_add_epi32(index, step);
+	}
+	_mm256_storeu_ps(best, lane_best);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(best_index), lane_index);
+#elif defined(ENEMY_ARRAYS_SSE2)
+	__m128 px = _mm_set1_ps(pos.x);
+	__m128 py = _mm_set1_ps(pos.y);
+	__m128i want = _mm_set1_epi32(static_cast<int>(wanted));
+	__m128 best_low = _mm_set1_ps(max_sq);
+	__m128 best_high = best_low;
+	__m128i index_low = _mm_set1_epi32(-1);
+	__m128i index_high = index_low;
+	__m128i index = _mm_setr_epi32(0, 1, 2, 3);
+	__m128i step = _mm_set1_epi32(4);
+	for (size_t start = 0; start < x.size(); start += block) {
+		NearestStep(&x[start], &y[start], &flags[start], px, py, want, index,
+			best_low, index_low);
+		index = _mm_add_epi32(index, step);
+		NearestStep(&x[start + 4], &y[start + 4], &flags[start + 4], px, py,
+			want, index, best_high, index_high);
+		index = _mm_add_epi32(index, step);
+	}
+	_mm_storeu_ps(best, best_low);
+	_mm_storeu_ps(best + 4, best_high);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(best_index), index_low);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(best_index + 4), index_high);
+#else
+	for (size_t lane = 0; lane < block; ++lane) {
+		best[lane] = max_sq;
+		best_index[lane] = -1;
+	}
+	for (size_t start = 0; start < x.size(); start += block) {
+		for (size_t lane = 0; lane < block; ++lane) {
+			float dx = x[start + lane] - pos.x;
+			float dy = y[start + lane] - pos.y;
+			float d2 = dx * dx + dy * dy;
+			if (d2 < best[lane] && (flags[start + lane] & wanted) == wanted) {
+				best[lane] = d2;
+				best_index[lane] = static_cast<int32_t>(start + lane);
+			}
+		}
+	}
+#endif
+	// Closest over the lanes, the lowest index on ties
+	int nearest = -1;
+	float nearest_sq = max_sq;
+	for (size_t lane = 0; lane < block; ++lane) {
+		if (best_index[lane] < 0) {
+			continue;
+		}
+		if (nearest < 0 || best[lane] < nearest_sq ||
+			(best[lane] == nearest_sq && best_index[lane] < nearest)) {
+			nearest = best_index[lane];
+			nearest_sq = best[lane];
+		}
+	}
+	return nearest;
+}
@@ -0,0 +1,79 @@
+#ifndef ENEMY_ARRAYS_H_
+#define ENEMY_ARRAYS_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Enemy units of one game loop as parallel arrays (x, y, health, shield,
+// type, flags) so the distance kernels can test 8 units at a time with AVX2,
+// 4 with SSE2, or one at a time where neither is available. The arrays are
+// padded to a whole block with entries that are never in range and have no
+// flags. Indices are positions in the unit list the arrays were built from.
+class EnemyArrays {
+public:
+	// Derived per unit flags, kernels only look at units with all the
+	// requested flags set
+	enum Flag : uint32_t {
+		Alive = 1 << 0,      // is_alive
+		NonTrivial = 1 << 1, // not in trivial_types
+		AntiAir = 1 << 2,    // has a threat level against Battlecruisers
+	};
+
+	// Rebuilds the arrays from the enemy units of the game loop
+	void Build(const sc2::Units& units, uint32_t game_loop);
+
+	// True if the arrays were built for the given game loop
+	bool IsBuiltFor(uint32_t game_loop) const {
+		return built && game_loop == built_loop;
+	}
+
+	size_t Size() const { return units.size(); }
+	const sc2::Unit* UnitAt(size_t index) const { return units[index]; }
+	float Health(size_t index) const { return health[index]; }
+	float Shield(size_t index) const { return shield[index]; }
+	uint32_t Type(size_t index) const { return type[index]; }
+
+	// Number of units with the flags within radius of pos (inclusive)
+	size_t CountInRadius(const sc2::Point2D& pos, float radius,
+		uint32_t wanted) const;
+
+	// True if any unit with the flags is within radius of pos (inclusive)
+	bool AnyInRadius(const sc2::Point2D& pos, float radius,
+		uint32_t wanted) const;
+
+	// Index of the closest unit with the flags strictly closer than
+	// max_distance, the lowest index on ties. -1 if there is none.
+	int Nearest(const sc2::Point2D& pos, float max_distance,
+		uint32_t wanted) const;
+
+	// Appends the indices of the units with the flags within radius of pos
+	// (inclusive), in increasing order
+	void InRadius(const sc2::Point2D& pos, float radius, uint32_t wanted,
+		std::vector<uint32_t>& out) const;
+
+private:
+	// Entries the arrays are padded to a multiple of
+	static const size_t block = 8;
+
+	// Bit i set if entry start + i has the flags and is within the radius
+	unsigned BlockMask(size_t start, float px, float py, float radius_sq,
+		uint32_t wanted) const;
+
+	sc2::Units units;
+	// Padded, loaded unaligned
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> health;
+	std::vector<float> shield;
+	std::vector<uint32_t> type;
+	std::vector<uint32_t> flags;
+
+	uint32_t built_loop = 0;
+	bool built = false;
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef FLAT_TAG_MAP_H_
+#define FLAT_TAG_MAP_H_
+
+#include "sc2api/sc2_unit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Per unit state keyed by tag, in one open-addressing array with linear
+// probing. Erase shifts the following entries of the run back instead of
+// leaving tombstones, so lookups never walk over dead slots and the table
+// only grows with the number of live entries. Reads don't insert.
+// NullTag marks an empty slot and can't be a key.
+template <typename T>
+class FlatTagMap {
+public:
+	// Value of the tag, nullptr if there is none
+	T* Find(sc2::Tag tag) {
+		size_t slot = SlotOf(tag);
+		return slot == npos ? nullptr : &slots[slot].value;
+	}
+	const T* Find(sc2::Tag tag) const {
+		size_t slot = SlotOf(tag);
+		return slot == npos ? nullptr : &slots[slot].value;
+	}
+
+	// Value of the tag, or fallback if there is none
+	T Get(sc2::Tag tag, const T& fallback = T()) const {
+		const T* value = Find(tag);
+		return value ? *value : fallback;
+	}
+
+	void Set(sc2::Tag tag, const T& value) {
+		if (tag == sc2::NullTag) {
+			return;
+		}
+		if ((count + 1) * 4 > slots.size() * 3) {
+			Grow();
+		}
+		size_t slot = Home(tag);
+		while (slots[slot].tag != sc2::NullTag) {
+			if (slots[slot].tag == tag) {
+				slots[slot].value = value;
+				return;
+			}
+			slot = (slot + 1) & mask;
+		}
+		slots[slot].tag = tag;
+		slots[slot].value = value;
+		++count;
+	}
+
+	// Removes the tag, false if it wasn't there
+	bool Erase(sc2::Tag tag) {
+		size_t hole = SlotOf(tag);
+		if (hole == npos) {
+			return false;
+		}
+		// Move back every entry of the run that may take the hole, that is
+		// whose home slot isn't between the hole and where it sits
+		size_t slot = hole;
+		while (true) {
+			slot = (slot + 1) & mask;
+			if (slots[slot].tag == sc2::NullTag) {
+				break;
+			}
+			size_t home = Home(slots[slot].tag);
+			if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+				slots[hole] = std::move(slots[slot]);
+				hole = slot;
+			}
+		}
+		slots[hole].tag = sc2::NullTag;
+		slots[hole].value = T();
+		--count;
+		return true;
+	}
+
+	void Clear() {
+		slots.clear();
+		mask = 0;
+		count = 0;
+	}
+
+	size_t Size() const { return count; }
+	// Slots allocated, a power of two
+	size_t Capacity() const { return slots.size(); }
+
+	// Calls f(tag, value) for every entry, in slot order
+	template <typename Function>
+	void ForEach(Function f) const {
+		for (const auto& slot : slots) {
+			if (slot.tag != sc2::NullTag) {
+				f(slot.tag, slot.value);
+			}
+		}
+	}
+
+private:
+	struct Slot {
+		sc2::Tag tag = sc2::NullTag;
+		T value = T();
+	};
+
+	static const size_t npos = static_cast<size_t>(-1);
+	static const size_t min_capacity = 16;
+
+	size_t Home(sc2::Tag tag) const {
+		// Tags are an index in the low bits and a recycle count above, mix
+		// them so that neighbouring indices spread over the table
+		uint64_t hash = tag * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(hash ^ (hash >> 32)) & mask;
+	}
+
+	size_t SlotOf(sc2::Tag tag) const {
+		if (slots.empty() || tag == sc2::NullTag) {
+			return npos;
+		}
+		size_t slot = Home(tag);
+		while (slots[slot].tag != sc2::NullTag) {
+			if (slots[slot].tag == tag) {
+				return slot;
+			}
+			slot = (slot + 1) & mask;
+		}
+		return npos;
+	}
+
+	void Grow() {
+		std::vector<Slot> old;
+		old.swap(slots);
+		slots.resize(old.empty() ? static_cast<size_t>(min_capacity)
+			: old.size() * 2);
+		mask = slots.size() - 1;
+		count = 0;
+		for (auto& slot : old) {
+			if (slot.tag != sc2::NullTag) {
+				Set(slot.tag, slot.value);
+			}
+		}
+	}
+
+	std::vector<Slot> slots;
+	size_t mask = 0;
+	size_t count = 0;
+};
+
+#endif
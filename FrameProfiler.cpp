@@ -0,0 +1,47 @@
+#include "FrameProfiler.h"
+
+#ifdef UEDBOT_PROFILE
+
+#include <cstdio>
+
+FrameProfiler& FrameProfiler::Instance() {
+	static FrameProfiler profiler;
+	return profiler;
+}
+
+size_t FrameProfiler::Register(const char* name) {
+	for (size_t i = 0; i < stages.size(); ++i) {
+		if (stages[i].name == name) {
+			return i;
+		}
+	}
+	stages.emplace_back();
+	stages.back().name = name;
+	return stages.size() - 1;
+}
+
+void FrameProfiler::Record(size_t stage, double microseconds) {
+	stages[stage].times.Record(microseconds);
+}
+
+void FrameProfiler::Report(std::ostream& out) const {
+	char line[160];
+	std::snprintf(line, sizeof(line), "%-28s %10s %10s %10s %10s %10s %10s",
+		"stage (us)", "calls", "mean", "p50", "p95", "p99", "max");
+	out << line << std::endl;
+	for (const auto& s : stages) {
+		const LatencyHistogram& times = s.times;
+		if (!times.Count()) {
+			continue;
+		}
+		std::snprintf(line, sizeof(line),
+			"%-28s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f", s.name.c_str(),
+			static_cast<unsigned long long>(times.Count()),
+			times.Total() / static_cast<double>(times.Count()),
+			times.Percentile(0.50), times.Percentile(0.95),
+			times.Percentile(0.99), times.Max());
+		out << line << std::endl;
+	}
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FRAME_PROFILER_H_
+#define FRAME_PROFILER_H_
+
+// Scoped timers for the stages of OnStep, with a latency histogram per stage.
+//
+// Only built with UEDBOT_PROFILE defined (cmake -DUEDBOT_PROFILE=ON). Without
+// it PROFILE_SCOPE and PROFILE_REPORT expand to nothing.
+//
+//   void BasicSc2Bot::TrainSCVs() {
+//       PROFILE_SCOPE("TrainSCVs");
+//       ...
+//   }
+
+#ifdef UEDBOT_PROFILE
+
+#include "LatencyHistogram.h"
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class FrameProfiler {
+public:
+	static FrameProfiler& Instance();
+
+	// Id of the stage with this name (added on first use)
+	size_t Register(const char* name);
+
+	void Record(size_t stage, double microseconds);
+
+	// p50/p95/p99/max for every stage, in the order they were registered
+	void Report(std::ostream& out) const;
+
+private:
+	struct Stage {
+		std::string name;
+		LatencyHistogram times;
+	};
+
+	std::vector<Stage> stages;
+};
+
+// Records the time from construction to destruction under a stage
+class ProfileTimer {
+public:
+	explicit ProfileTimer(size_t stage_id)
+		: stage(stage_id), start(std::chrono::steady_clock::now()) {}
+
+	~ProfileTimer() {
+		std::chrono::duration<double, std::micro> elapsed =
+			std::chrono::steady_clock::now() - start;
+		FrameProfiler::Instance().Record(stage, elapsed.count());
+	}
+
+	ProfileTimer(const ProfileTimer&) = delete;
+	ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+private:
+	size_t stage;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name)                                                  \
+	static const size_t PROFILE_CONCAT(profile_stage_, __LINE__) =           \
+		FrameProfiler::Instance().Register(name);                            \
+	ProfileTimer PROFILE_CONCAT(profile_timer_, __LINE__)(                   \
+		PROFILE_CONCAT(profile_stage_, __LINE__))
+
+#define PROFILE_REPORT(out) FrameProfiler::Instance().Report(out)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_REPORT(out) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,1211 @@
+#include "GameRecording.h"
+
+#include "s2clientprotocol/sc2api.pb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+
+using namespace sc2;
+
+namespace {
+// Bump when the layout changes
+const uint32_t recording_version = 2;
+const char recording_magic[8] = { 'U', 'E', 'D', 'R', 'E', 'C', 'D', '\0' };
+const char recording_end_magic[4] = { 'U', 'E', 'D', 'X' };
+const uint32_t keyframe_interval = 256;
+// Floats are stored as multiples of 1/4096
+const double float_scale = 4096.0;
+
+// Unit field groups, one bit each in a unit's change mask
+enum UnitField : uint32_t {
+	FieldType = 1u << 0,
+	FieldState = 1u << 1,
+	FieldPos = 1u << 2,
+	FieldFacing = 1u << 3,
+	FieldRadius = 1u << 4,
+	FieldProgress = 1u << 5,
+	FieldHealth = 1u << 6,
+	FieldMax = 1u << 7,
+	FieldShield = 1u << 8,
+	FieldEnergy = 1u << 9,
+	FieldContents = 1u << 10,
+	FieldCooldown = 1u << 11,
+	FieldOrders = 1u << 12,
+	FieldAddOn = 1u << 13,
+	FieldCargo = 1u << 14,
+	FieldHarvesters = 1u << 15,
+	FieldEngaged = 1u << 16,
+	FieldBuffs = 1u << 17,
+	FieldRanges = 1u << 18,
+	FieldUpgrades = 1u << 19,
+	FieldSeen = 1u << 20,
+	FieldAll = (1u << 21) - 1
+};
+
+// Runs in the unit list of a frame, against the previous frame's list
+enum UnitRun : uint64_t {
+	// Units equal to the next ones of the previous frame
+	RunCopy = 0,
+	// Changed versions of the next units of the previous frame
+	RunChanged = 1,
+	// Skips units of the previous frame that are gone
+	RunSkip = 2,
+	// Units not in the previous frame
+	RunNew = 3,
+	// Moves to a unit earlier in the previous frame, for reordered lists
+	RunJump = 4
+};
+const int run_bits = 3;
+
+int64_t Quantize(float value) {
+	return static_cast<int64_t>(std::llround(value * float_scale));
+}
+
+float Dequantize(int64_t value) {
+	return static_cast<float>(value / float_scale);
+}
+
+// The value a reader gets back
+float Rounded(float value) {
+	return Dequantize(Quantize(value));
+}
+
+uint64_t ZigZag(int64_t value) {
+	return (static_cast<uint64_t>(value) << 1) ^
+		static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class Writer {
+public:
+	explicit Writer(std::string& output) : buffer(output) {}
+
+	template <typename T>
+	void Put(const T& value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void Put(const std::string& value) {
+		PutVarint(value.size());
+		buffer.append(value);
+	}
+
+	void Put(const Point2D& p) {
+		Put(p.x);
+		Put(p.y);
+	}
+
+	void Put(const Point3D& p) {
+		Put(p.x);
+		Put(p.y);
+		Put(p.z);
+	}
+
+	void Put(const ImageData& image) {
+		PutSigned(image.width);
+		PutSigned(image.height);
+		PutSigned(image.bits_per_pixel);
+		Put(image.data);
+	}
+
+	void PutVarint(uint64_t value) {
+		while (value >= 0x80) {
+			buffer.push_back(static_cast<char>(value | 0x80));
+			value >>= 7;
+		}
+		buffer.push_back(static_cast<char>(value));
+	}
+
+	void PutSigned(int64_t value) {
+		PutVarint(ZigZag(value));
+	}
+
+	void PutDelta(float value, float previous) {
+		PutSigned(Quantize(value) - Quantize(previous));
+	}
+
+private:
+	std::string& buffer;
+};
+
+// Bounds checked reads from the mapped file
+class Reader {
+public:
+	Reader(const uint8_t* data, size_t size) : at(data), end(data + size) {}
+
+	template <typename T>
+	bool Get(T& value) {
+		if (static_cast<size_t>(end - at) < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, at, sizeof(T));
+		at += sizeof(T);
+		return true;
+	}
+
+	bool Get(std::string& value) {
+		uint64_t size;
+		if (!GetVarint(size) || static_cast<uint64_t>(end - at) < size) {
+			return false;
+		}
+		value.assign(reinterpret_cast<const char*>(at),
+			static_cast<size_t>(size));
+		at += size;
+		return true;
+	}
+
+	bool Get(Point2D& p) {
+		return Get(p.x) && Get(p.y);
+	}
+
+	bool Get(Point3D& p) {
+		return Get(p.x) && Get(p.y) && Get(p.z);
+	}
+
+	bool Get(ImageData& image) {
+		return GetSigned(image.width) && GetSigned(image.height) &&
+			GetSigned(image.bits_per_pixel) && Get(image.data);
+	}
+
+	bool GetVarint(uint64_t& value) {
+		value = 0;
+		for (int shift = 0; shift < 64 && at != end; shift += 7) {
+			uint8_t byte = *at++;
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template <typename T>
+	bool GetVarint(T& value) {
+		uint64_t raw;
+		if (!GetVarint(raw)) {
+			return false;
+		}
+		value = static_cast<T>(raw);
+		return true;
+	}
+
+	template <typename T>
+	bool GetSigned(T& value) {
+		uint64_t raw;
+		if (!GetVarint(raw)) {
+			return false;
+		}
+		value = static_cast<T>(UnZigZag(raw));
+		return true;
+	}
+
+	// Applies a delta written by Writer::PutDelta
+	bool GetDelta(float& value) {
+		uint64_t raw;
+		if (!GetVarint(raw)) {
+			return false;
+		}
+		value = Dequantize(Quantize(value) + UnZigZag(raw));
+		return true;
+	}
+
+	// Counts are checked against the bytes left, each element takes one
+	bool GetCount(uint64_t& count) {
+		return GetVarint(count) && count <= static_cast<uint64_t>(end - at);
+	}
+
+	const uint8_t* At() const { return at; }
+	bool AtEnd() const { return at == end; }
+
+private:
+	const uint8_t* at;
+	const uint8_t* end;
+};
+
+// What the reader starts a unit it hasn't seen from
+Unit NewUnit(uint32_t game_loop) {
+	Unit unit;
+	unit.display_type = Unit::DisplayType::Visible;
+	unit.alliance = Unit::Alliance::Self;
+	unit.tag = NullTag;
+	unit.unit_type = UnitTypeID(0);
+	unit.owner = 0;
+	unit.pos = Point3D(0.0f, 0.0f, 0.0f);
+	unit.facing = 0.0f;
+	unit.radius = 0.0f;
+	unit.build_progress = 1.0f;
+	unit.cloak = Unit::CloakState::NotCloaked;
+	unit.buffs.clear();
+	unit.detect_range = 0.0f;
+	unit.radar_range = 0.0f;
+	unit.is_selected = false;
+	unit.is_on_screen = false;
+	unit.is_blip = false;
+	unit.is_powered = false;
+	unit.is_active = false;
+	unit.attack_upgrade_level = 0;
+	unit.armor_upgrade_level = 0;
+	unit.shield_upgrade_level = 0;
+	unit.health = 0.0f;
+	unit.health_max = 0.0f;
+	unit.shield = 0.0f;
+	unit.shield_max = 0.0f;
+	unit.energy = 0.0f;
+	unit.energy_max = 0.0f;
+	unit.mineral_contents = 0;
+	unit.vespene_contents = 0;
+	unit.is_flying = false;
+	unit.is_burrowed = false;
+	unit.is_hallucination = false;
+	unit.weapon_cooldown = 0.0f;
+	unit.orders.clear();
+	unit.add_on_tag = NullTag;
+	unit.passengers.clear();
+	unit.cargo_space_taken = 0;
+	unit.cargo_space_max = 0;
+	unit.assigned_harvesters = 0;
+	unit.ideal_harvesters = 0;
+	unit.engaged_target_tag = NullTag;
+	unit.last_seen_game_loop = game_loop;
+	unit.is_alive = true;
+	return unit;
+}
+
+// The unit as the reader will get it back
+Unit RoundedUnit(const Unit& source) {
+	Unit unit = source;
+	unit.pos = Point3D(Rounded(unit.pos.x), Rounded(unit.pos.y),
+		Rounded(unit.pos.z));
+	for (float* value : { &unit.facing, &unit.radius, &unit.build_progress,
+		&unit.detect_range, &unit.radar_range, &unit.health, &unit.health_max,
+		&unit.shield, &unit.shield_max, &unit.energy, &unit.energy_max,
+		&unit.weapon_cooldown }) {
+		*value = Rounded(*value);
+	}
+	for (auto& order : unit.orders) {
+		order.target_pos = Point2D(Rounded(order.target_pos.x),
+			Rounded(order.target_pos.y));
+		order.progress = Rounded(order.progress);
+	}
+	unit.passengers.clear();
+	unit.is_alive = true;
+	return unit;
+}
+
+uint32_t StateBits(const Unit& unit) {
+	return (unit.is_selected ? 1u : 0u) | (unit.is_on_screen ? 2u : 0u) |
+		(unit.is_blip ? 4u : 0u) | (unit.is_powered ? 8u : 0u) |
+		(unit.is_active ? 16u : 0u) | (unit.is_flying ? 32u : 0u) |
+		(unit.is_burrowed ? 64u : 0u) | (unit.is_hallucination ? 128u : 0u);
+}
+
+bool SameOrders(const std::vector<UnitOrder>& a,
+	const std::vector<UnitOrder>& b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (a[i].ability_id != b[i].ability_id ||
+			a[i].target_unit_tag != b[i].target_unit_tag ||
+			a[i].target_pos.x != b[i].target_pos.x ||
+			a[i].target_pos.y != b[i].target_pos.y ||
+			a[i].progress != b[i].progress) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Field groups that differ between two rounded units. last_seen_game_loop is
+// compared as the age in loops, which stays 0 while a unit is in sight.
+uint32_t Changes(const Unit& before, uint32_t before_loop, const Unit& unit,
+	uint32_t game_loop) {
+	uint32_t mask = 0;
+	if (unit.unit_type != before.unit_type || unit.owner != before.owner) {
+		mask |= FieldType;
+	}
+	if (unit.display_type != before.display_type ||
+		unit.alliance != before.alliance || unit.cloak != before.cloak ||
+		StateBits(unit) != StateBits(before)) {
+		mask |= FieldState;
+	}
+	if (unit.pos.x != before.pos.x || unit.pos.y != before.pos.y ||
+		unit.pos.z != before.pos.z) {
+		mask |= FieldPos;
+	}
+	if (unit.facing != before.facing) {
+		mask |= FieldFacing;
+	}
+	if (unit.radius != before.radius) {
+		mask |= FieldRadius;
+	}
+	if (unit.build_progress != before.build_progress) {
+		mask |= FieldProgress;
+	}
+	if (unit.health != before.health) {
+		mask |= FieldHealth;
+	}
+	if (unit.health_max != before.health_max ||
+		unit.shield_max != before.shield_max ||
+		unit.energy_max != before.energy_max) {
+		mask |= FieldMax;
+	}
+	if (unit.shield != before.shield) {
+		mask |= FieldShield;
+	}
+	if (unit.energy != before.energy) {
+		mask |= FieldEnergy;
+	}
+	if (unit.mineral_contents != before.mineral_contents ||
+		unit.vespene_contents != before.vespene_contents) {
+		mask |= FieldContents;
+	}
+	if (unit.weapon_cooldown != before.weapon_cooldown) {
+		mask |= FieldCooldown;
+	}
+	if (!SameOrders(unit.orders, before.orders)) {
+		mask |= FieldOrders;
+	}
+	if (unit.add_on_tag != before.add_on_tag) {
+		mask |= FieldAddOn;
+	}
+	if (unit.cargo_space_taken != before.cargo_space_taken ||
+		unit.cargo_space_max != before.cargo_space_max) {
+		mask |= FieldCargo;
+	}
+	if (unit.assigned_harvesters != before.assigned_harvesters ||
+		unit.ideal_harvesters != before.ideal_harvesters) {
+		mask |= FieldHarvesters;
+	}
+	if (unit.engaged_target_tag != before.engaged_target_tag) {
+		mask |= FieldEngaged;
+	}
+	if (unit.buffs != before.buffs) {
+		mask |= FieldBuffs;
+	}
+	if (unit.detect_range != before.detect_range ||
+		unit.radar_range != before.radar_range) {
+		mask |= FieldRanges;
+	}
+	if (unit.attack_upgrade_level != before.attack_upgrade_level ||
+		unit.armor_upgrade_level != before.armor_upgrade_level ||
+		unit.shield_upgrade_level != before.shield_upgrade_level) {
+		mask |= FieldUpgrades;
+	}
+	if (game_loop - unit.last_seen_game_loop !=
+		before_loop - before.last_seen_game_loop) {
+		mask |= FieldSeen;
+	}
+	return mask;
+}
+
+void EncodeUnit(Writer& writer, const Unit& before, const Unit& unit,
+	uint32_t mask, uint32_t game_loop) {
+	writer.PutVarint(mask);
+	if (mask & FieldType) {
+		writer.PutVarint(static_cast<uint32_t>(unit.unit_type));
+		writer.PutSigned(unit.owner);
+	}
+	if (mask & FieldState) {
+		writer.PutVarint(static_cast<uint32_t>(unit.display_type));
+		writer.PutVarint(static_cast<uint32_t>(unit.alliance));
+		writer.PutVarint(static_cast<uint32_t>(unit.cloak));
+		writer.PutVarint(StateBits(unit));
+	}
+	if (mask & FieldPos) {
+		writer.PutDelta(unit.pos.x, before.pos.x);
+		writer.PutDelta(unit.pos.y, before.pos.y);
+		writer.PutDelta(unit.pos.z, before.pos.z);
+	}
+	if (mask & FieldFacing) {
+		writer.PutDelta(unit.facing, before.facing);
+	}
+	if (mask & FieldRadius) {
+		writer.PutDelta(unit.radius, before.radius);
+	}
+	if (mask & FieldProgress) {
+		writer.PutDelta(unit.build_progress, before.build_progress);
+	}
+	if (mask & FieldHealth) {
+		writer.PutDelta(unit.health, before.health);
+	}
+	if (mask & FieldMax) {
+		writer.PutDelta(unit.health_max, before.health_max);
+		writer.PutDelta(unit.shield_max, before.shield_max);
+		writer.PutDelta(unit.energy_max, before.energy_max);
+	}
+	if (mask & FieldShield) {
+		writer.PutDelta(unit.shield, before.shield);
+	}
+	if (mask & FieldEnergy) {
+		writer.PutDelta(unit.energy, before.energy);
+	}
+	if (mask & FieldContents) {
+		writer.PutSigned(unit.mineral_contents - before.mineral_contents);
+		writer.PutSigned(unit.vespene_contents - before.vespene_contents);
+	}
+	if (mask & FieldCooldown) {
+		writer.PutDelta(unit.weapon_cooldown, before.weapon_cooldown);
+	}
+	if (mask & FieldOrders) {
+		writer.PutVarint(unit.orders.size());
+		for (const auto& order : unit.orders) {
+			writer.PutVarint(static_cast<uint32_t>(order.ability_id));
+			writer.PutVarint(order.target_unit_tag);
+			writer.PutDelta(order.target_pos.x, 0.0f);
+			writer.PutDelta(order.target_pos.y, 0.0f);
+			writer.PutDelta(order.progress, 0.0f);
+		}
+	}
+	if (mask & FieldAddOn) {
+		writer.PutVarint(unit.add_on_tag);
+	}
+	if (mask & FieldCargo) {
+		writer.PutSigned(unit.cargo_space_taken);
+		writer.PutSigned(unit.cargo_space_max);
+	}
+	if (mask & FieldHarvesters) {
+		writer.PutSigned(unit.assigned_harvesters);
+		writer.PutSigned(unit.ideal_harvesters);
+	}
+	if (mask & FieldEngaged) {
+		writer.PutVarint(unit.engaged_target_tag);
+	}
+	if (mask & FieldBuffs) {
+		writer.PutVarint(unit.buffs.size());
+		for (BuffID buff : unit.buffs) {
+			writer.PutVarint(static_cast<uint32_t>(buff));
+		}
+	}
+	if (mask & FieldRanges) {
+		writer.PutDelta(unit.detect_range, before.detect_range);
+		writer.PutDelta(unit.radar_range, before.radar_range);
+	}
+	if (mask & FieldUpgrades) {
+		writer.PutSigned(unit.attack_upgrade_level);
+		writer.PutSigned(unit.armor_upgrade_level);
+		writer.PutSigned(unit.shield_upgrade_level);
+	}
+	if (mask & FieldSeen) {
+		writer.PutVarint(game_loop - unit.last_seen_game_loop);
+	}
+}
+
+// Reads a unit written by EncodeUnit over its previous state
+bool DecodeUnit(Reader& reader, Unit& unit, uint32_t before_loop,
+	uint32_t game_loop) {
+	uint32_t age = before_loop - unit.last_seen_game_loop;
+	uint32_t mask;
+	if (!reader.GetVarint(mask) || (mask & ~FieldAll)) {
+		return false;
+	}
+	if (mask & FieldType) {
+		uint32_t type;
+		if (!reader.GetVarint(type) || !reader.GetSigned(unit.owner)) {
+			return false;
+		}
+		unit.unit_type = UnitTypeID(type);
+	}
+	if (mask & FieldState) {
+		uint32_t display_type;
+		uint32_t alliance;
+		uint32_t cloak;
+		uint32_t bits;
+		if (!reader.GetVarint(display_type) || !reader.GetVarint(alliance) ||
+			!reader.GetVarint(cloak) || !reader.GetVarint(bits)) {
+			return false;
+		}
+		unit.display_type = static_cast<Unit::DisplayType>(display_type);
+		unit.alliance = static_cast<Unit::Alliance>(alliance);
+		unit.cloak = static_cast<Unit::CloakState>(cloak);
+		unit.is_selected = (bits & 1) != 0;
+		unit.is_on_screen = (bits & 2) != 0;
+		unit.is_blip = (bits & 4) != 0;
+		unit.is_powered = (bits & 8) != 0;
+		unit.is_active = (bits & 16) != 0;
+		unit.is_flying = (bits & 32) != 0;
+		unit.is_burrowed = (bits & 64) != 0;
+		unit.is_hallucination = (bits & 128) != 0;
+	}
+	if ((mask & FieldPos) && !(reader.GetDelta(unit.pos.x) &&
+		reader.GetDelta(unit.pos.y) && reader.GetDelta(unit.pos.z))) {
+		return false;
+	}
+	if ((mask & FieldFacing) && !reader.GetDelta(unit.facing)) {
+		return false;
+	}
+	if ((mask & FieldRadius) && !reader.GetDelta(unit.radius)) {
+		return false;
+	}
+	if ((mask & FieldProgress) && !reader.GetDelta(unit.build_progress)) {
+		return false;
+	}
+	if ((mask & FieldHealth) && !reader.GetDelta(unit.health)) {
+		return false;
+	}
+	if ((mask & FieldMax) && !(reader.GetDelta(unit.health_max) &&
+		reader.GetDelta(unit.shield_max) && reader.GetDelta(unit.energy_max))) {
+		return false;
+	}
+	if ((mask & FieldShield) && !reader.GetDelta(unit.shield)) {
+		return false;
+	}
+	if ((mask & FieldEnergy) && !reader.GetDelta(unit.energy)) {
+		return false;
+	}
+	if (mask & FieldContents) {
+		int mineral_delta;
+		int vespene_delta;
+		if (!reader.GetSigned(mineral_delta) ||
+			!reader.GetSigned(vespene_delta)) {
+			return false;
+		}
+		unit.mineral_contents += mineral_delta;
+		unit.vespene_contents += vespene_delta;
+	}
+	if ((mask & FieldCooldown) && !reader.GetDelta(unit.weapon_cooldown)) {
+		return false;
+	}
+	if (mask & FieldOrders) {
+		uint64_t count;
+		if (!reader.GetCount(count)) {
+			return false;
+		}
+		unit.orders.resize(static_cast<size_t>(count));
+		for (auto& order : unit.orders) {
+			uint32_t ability;
+			order.target_pos = Point2D(0.0f, 0.0f);
+			order.progress = 0.0f;
+			if (!reader.GetVarint(ability) ||
+				!reader.GetVarint(order.target_unit_tag) ||
+				!reader.GetDelta(order.target_pos.x) ||
+				!reader.GetDelta(order.target_pos.y) ||
+				!reader.GetDelta(order.progress)) {
+				return false;
+			}
+			order.ability_id = AbilityID(ability);
+		}
+	}
+	if ((mask & FieldAddOn) && !reader.GetVarint(unit.add_on_tag)) {
+		return false;
+	}
+	if ((mask & FieldCargo) && !(reader.GetSigned(unit.cargo_space_taken) &&
+		reader.GetSigned(unit.cargo_space_max))) {
+		return false;
+	}
+	if ((mask & FieldHarvesters) &&
+		!(reader.GetSigned(unit.assigned_harvesters) &&
+		reader.GetSigned(unit.ideal_harvesters))) {
+		return false;
+	}
+	if ((mask & FieldEngaged) && !reader.GetVarint(unit.engaged_target_tag)) {
+		return false;
+	}
+	if (mask & FieldBuffs) {
+		uint64_t count;
+		if (!reader.GetCount(count)) {
+			return false;
+		}
+		unit.buffs.resize(static_cast<size_t>(count));
+		for (auto& buff : unit.buffs) {
+			uint32_t id;
+			if (!reader.GetVarint(id)) {
+				return false;
+			}
+			buff = BuffID(id);
+		}
+	}
+	if ((mask & FieldRanges) && !(reader.GetDelta(unit.detect_range) &&
+		reader.GetDelta(unit.radar_range))) {
+		return false;
+	}
+	if ((mask & FieldUpgrades) &&
+		!(reader.GetSigned(unit.attack_upgrade_level) &&
+		reader.GetSigned(unit.armor_upgrade_level) &&
+		reader.GetSigned(unit.shield_upgrade_level))) {
+		return false;
+	}
+	if ((mask & FieldSeen) && !reader.GetVarint(age)) {
+		return false;
+	}
+	unit.last_seen_game_loop = game_loop - age;
+	return true;
+}
+
+// Encodes a frame against the one before it, or against an empty frame for
+// a keyframe
+void EncodeFrame(Writer& writer, const RecordedFrame& before,
+	const RecordedFrame& frame) {
+	writer.PutVarint(frame.game_loop - before.game_loop);
+	writer.PutSigned(frame.minerals - before.minerals);
+	writer.PutSigned(frame.vespene - before.vespene);
+	writer.PutSigned(frame.food_used - before.food_used);
+	writer.PutSigned(frame.food_cap - before.food_cap);
+
+	// Upgrades only ever get added, so usually only the new ones are written
+	bool appended = frame.upgrades.size() >= before.upgrades.size() &&
+		std::equal(before.upgrades.begin(), before.upgrades.end(),
+			frame.upgrades.begin());
+	size_t first_upgrade = appended ? before.upgrades.size() : 0;
+	writer.PutVarint(((frame.upgrades.size() - first_upgrade) << 1) |
+		(appended ? 0 : 1));
+	for (size_t i = first_upgrade; i < frame.upgrades.size(); ++i) {
+		writer.PutVarint(static_cast<uint32_t>(frame.upgrades[i]));
+	}
+
+	writer.PutVarint(frame.results.size());
+	for (const auto& result : frame.results) {
+		writer.PutVarint(result.player_id);
+		writer.PutVarint(static_cast<uint32_t>(result.result));
+	}
+
+	// Deaths belong to their frame alone, so they aren't deltas
+	writer.PutVarint(frame.dead_units.size());
+	for (Tag tag : frame.dead_units) {
+		writer.PutVarint(tag);
+	}
+
+	std::unordered_map<Tag, size_t> before_index;
+	before_index.reserve(before.units.size());
+	for (size_t i = 0; i < before.units.size(); ++i) {
+		before_index[before.units[i].tag] = i;
+	}
+
+	// Units go out in runs of the same kind
+	writer.PutVarint(frame.units.size());
+	size_t cursor = 0;
+	std::vector<std::pair<const Unit*, uint32_t>> run;
+	uint64_t run_kind = RunCopy;
+	auto flush = [&]() {
+		if (run.empty()) {
+			return;
+		}
+		writer.PutVarint((run.size() << run_bits) | run_kind);
+		for (const auto& entry : run) {
+			const Unit& unit = *entry.first;
+			if (run_kind == RunNew) {
+				writer.PutVarint(unit.tag);
+				EncodeUnit(writer, NewUnit(frame.game_loop), unit, entry.second,
+					frame.game_loop);
+			}
+			else if (run_kind == RunChanged) {
+				EncodeUnit(writer, before.units[cursor], unit, entry.second,
+					frame.game_loop);
+			}
+			if (run_kind != RunNew) {
+				++cursor;
+			}
+		}
+		run.clear();
+	};
+	for (const auto& unit : frame.units) {
+		auto found = before_index.find(unit.tag);
+		uint64_t kind;
+		uint32_t mask;
+		if (found == before_index.end()) {
+			kind = RunNew;
+			mask = Changes(NewUnit(frame.game_loop), frame.game_loop, unit,
+				frame.game_loop);
+		}
+		else {
+			size_t index = found->second;
+			if (index != cursor + (run_kind == RunNew ? 0 : run.size())) {
+				flush();
+				if (index > cursor) {
+					writer.PutVarint(((index - cursor) << run_bits) | RunSkip);
+				}
+				else {
+					writer.PutVarint((index << run_bits) | RunJump);
+				}
+				cursor = index;
+			}
+			mask = Changes(before.units[index], before.game_loop, unit,
+				frame.game_loop);
+			kind = mask ? RunChanged : RunCopy;
+		}
+		if (kind != run_kind) {
+			flush();
+			run_kind = kind;
+		}
+		run.emplace_back(&unit, mask);
+	}
+	flush();
+
+	writer.PutVarint(frame.actions.size());
+	for (const auto& action : frame.actions) {
+		writer.PutVarint(static_cast<uint32_t>(action.ability_id));
+		writer.PutVarint(action.unit_tags.size());
+		for (Tag tag : action.unit_tags) {
+			writer.PutVarint(tag);
+		}
+		writer.PutVarint(static_cast<uint32_t>(action.target_type));
+		if (action.target_type == ActionRaw::TargetUnitTag) {
+			writer.PutVarint(action.target_tag);
+		}
+		else if (action.target_type == ActionRaw::TargetPosition) {
+			writer.PutDelta(action.target_point.x, 0.0f);
+			writer.PutDelta(action.target_point.y, 0.0f);
+		}
+	}
+}
+
+bool DecodeFrame(Reader& reader, const RecordedFrame& before,
+	RecordedFrame& frame) {
+	uint32_t loop_delta;
+	int32_t minerals_delta;
+	int32_t vespene_delta;
+	int32_t food_used_delta;
+	int32_t food_cap_delta;
+	if (!reader.GetVarint(loop_delta) || !reader.GetSigned(minerals_delta) ||
+		!reader.GetSigned(vespene_delta) ||
+		!reader.GetSigned(food_used_delta) ||
+		!reader.GetSigned(food_cap_delta)) {
+		return false;
+	}
+	frame.game_loop = before.game_loop + loop_delta;
+	frame.minerals = before.minerals + minerals_delta;
+	frame.vespene = before.vespene + vespene_delta;
+	frame.food_used = before.food_used + food_used_delta;
+	frame.food_cap = before.food_cap + food_cap_delta;
+
+	uint64_t upgrades;
+	if (!reader.GetVarint(upgrades) || (upgrades >> 1) > (1u << 20)) {
+		return false;
+	}
+	if (upgrades & 1) {
+		frame.upgrades.clear();
+	}
+	else {
+		frame.upgrades = before.upgrades;
+	}
+	for (uint64_t i = 0; i < (upgrades >> 1); ++i) {
+		uint32_t id;
+		if (!reader.GetVarint(id)) {
+			return false;
+		}
+		frame.upgrades.push_back(UpgradeID(id));
+	}
+
+	uint64_t results;
+	if (!reader.GetCount(results)) {
+		return false;
+	}
+	frame.results.resize(static_cast<size_t>(results));
+	for (auto& result : frame.results) {
+		uint32_t value;
+		if (!reader.GetVarint(result.player_id) || !reader.GetVarint(value)) {
+			return false;
+		}
+		result.result = static_cast<GameResult>(value);
+	}
+
+	uint64_t dead_units;
+	if (!reader.GetCount(dead_units)) {
+		return false;
+	}
+	frame.dead_units.resize(static_cast<size_t>(dead_units));
+	for (Tag& tag : frame.dead_units) {
+		if (!reader.GetVarint(tag)) {
+			return false;
+		}
+	}
+
+	// Copied units take no bytes of their own, so only sanity check the count
+	uint64_t unit_count;
+	if (!reader.GetVarint(unit_count) || unit_count > (1u << 20)) {
+		return false;
+	}
+	frame.units.clear();
+	frame.units.reserve(static_cast<size_t>(unit_count));
+	size_t cursor = 0;
+	while (frame.units.size() < unit_count) {
+		uint64_t run;
+		if (!reader.GetVarint(run)) {
+			return false;
+		}
+		uint64_t kind = run & ((1u << run_bits) - 1);
+		uint64_t count = run >> run_bits;
+		if (kind == RunSkip || kind == RunJump) {
+			size_t target = static_cast<size_t>(kind == RunSkip
+				? cursor + count : count);
+			if (target > before.units.size()) {
+				return false;
+			}
+			cursor = target;
+			continue;
+		}
+		if (count == 0 || count > unit_count - frame.units.size() ||
+			(kind != RunNew && count > before.units.size() - cursor)) {
+			return false;
+		}
+		for (uint64_t i = 0; i < count; ++i) {
+			if (kind == RunNew) {
+				Unit unit = NewUnit(frame.game_loop);
+				if (!reader.GetVarint(unit.tag) ||
+					!DecodeUnit(reader, unit, frame.game_loop, frame.game_loop)) {
+					return false;
+				}
+				frame.units.push_back(std::move(unit));
+				continue;
+			}
+			frame.units.push_back(before.units[cursor++]);
+			Unit& unit = frame.units.back();
+			if (kind == RunCopy) {
+				unit.last_seen_game_loop += loop_delta;
+			}
+			else if (kind != RunChanged ||
+				!DecodeUnit(reader, unit, before.game_loop, frame.game_loop)) {
+				return false;
+			}
+		}
+	}
+
+	uint64_t actions;
+	if (!reader.GetCount(actions)) {
+		return false;
+	}
+	frame.actions.resize(static_cast<size_t>(actions));
+	for (auto& action : frame.actions) {
+		uint32_t ability;
+		uint64_t tags;
+		uint32_t target_type;
+		if (!reader.GetVarint(ability) || !reader.GetCount(tags)) {
+			return false;
+		}
+		action.ability_id = AbilityID(ability);
+		action.unit_tags.resize(static_cast<size_t>(tags));
+		for (Tag& tag : action.unit_tags) {
+			if (!reader.GetVarint(tag)) {
+				return false;
+			}
+		}
+		if (!reader.GetVarint(target_type)) {
+			return false;
+		}
+		action.target_type = static_cast<ActionRaw::TargetType>(target_type);
+		action.target_tag = NullTag;
+		action.target_point = Point2D(0.0f, 0.0f);
+		if (action.target_type == ActionRaw::TargetUnitTag) {
+			if (!reader.GetVarint(action.target_tag)) {
+				return false;
+			}
+		}
+		else if (action.target_type == ActionRaw::TargetPosition) {
+			if (!reader.GetDelta(action.target_point.x) ||
+				!reader.GetDelta(action.target_point.y)) {
+				return false;
+			}
+		}
+	}
+	return reader.AtEnd();
+}
+}
+
+GameRecorder::~GameRecorder() {
+	Close();
+}
+
+bool GameRecorder::Open(const std::string& path) {
+	Close();
+	file = std::fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	written = 0;
+	header_written = false;
+	offsets.clear();
+	previous = RecordedFrame();
+	return true;
+}
+
+void GameRecorder::Close() {
+	if (!file) {
+		return;
+	}
+	// An empty frame ends the frames for readers that scan them. Then the
+	// frame offsets and where they start, so a reader can seek without
+	// scanning the whole file.
+	buffer.clear();
+	Writer writer(buffer);
+	writer.PutVarint(0);
+	written += buffer.size();
+	for (uint64_t offset : offsets) {
+		writer.Put(offset);
+	}
+	writer.Put(written);
+	writer.Put(static_cast<uint32_t>(offsets.size()));
+	writer.Put(recording_end_magic);
+	std::fwrite(buffer.data(), 1, buffer.size(), file);
+	std::fclose(file);
+	file = nullptr;
+}
+
+void GameRecorder::WriteHeader(const ObservationInterface* observation) {
+	const GameInfo& game_info = observation->GetGameInfo();
+	buffer.clear();
+	Writer writer(buffer);
+	writer.Put(recording_magic);
+	writer.Put(recording_version);
+	writer.Put(keyframe_interval);
+	writer.Put(observation->GetPlayerID());
+	writer.Put(observation->GetStartLocation());
+
+	writer.PutSigned(game_info.width);
+	writer.PutSigned(game_info.height);
+	writer.Put(game_info.map_name);
+	writer.Put(game_info.local_map_path);
+	writer.Put(game_info.playable_min);
+	writer.Put(game_info.playable_max);
+	for (const auto* locations : { &game_info.start_locations,
+		&game_info.enemy_start_locations }) {
+		writer.PutVarint(locations->size());
+		for (const auto& location : *locations) {
+			writer.Put(location);
+		}
+	}
+	writer.PutVarint(game_info.player_info.size());
+	for (const auto& player : game_info.player_info) {
+		writer.PutVarint(player.player_id);
+		writer.PutVarint(static_cast<uint32_t>(player.player_type));
+		writer.PutVarint(static_cast<uint32_t>(player.race_requested));
+		writer.PutVarint(static_cast<uint32_t>(player.race_actual));
+		writer.PutVarint(static_cast<uint32_t>(player.difficulty));
+		writer.Put(player.player_name);
+	}
+	writer.Put(game_info.pathing_grid);
+	writer.Put(game_info.placement_grid);
+	writer.Put(game_info.terrain_height);
+
+	std::fwrite(buffer.data(), 1, buffer.size(), file);
+	written += buffer.size();
+	header_written = true;
+}
+
+void GameRecorder::Record(const ObservationInterface* observation) {
+	if (!file) {
+		return;
+	}
+	if (!header_written) {
+		WriteHeader(observation);
+	}
+
+	RecordedFrame frame;
+	frame.game_loop = observation->GetGameLoop();
+	frame.minerals = observation->GetMinerals();
+	frame.vespene = observation->GetVespene();
+	frame.food_used = observation->GetFoodUsed();
+	frame.food_cap = observation->GetFoodCap();
+	Units units = observation->GetUnits();
+	frame.units.reserve(units.size());
+	for (const Unit* unit : units) {
+		frame.units.push_back(RoundedUnit(*unit));
+	}
+	frame.upgrades = observation->GetUpgrades();
+	frame.results = observation->GetResults();
+	const SC2APIProtocol::Observation* raw = observation->GetRawObservation();
+	if (raw && raw->has_raw_data() && raw->raw_data().has_event()) {
+		for (uint64_t tag : raw->raw_data().event().dead_units()) {
+			frame.dead_units.push_back(tag);
+		}
+	}
+	frame.actions = observation->GetRawActions();
+
+	if (offsets.size() % keyframe_interval == 0) {
+		previous = RecordedFrame();
+	}
+	std::string payload;
+	Writer payload_writer(payload);
+	EncodeFrame(payload_writer, previous, frame);
+
+	// Each frame is prefixed with its size, so a recording that was never
+	// closed can still be read
+	buffer.clear();
+	Writer writer(buffer);
+	writer.PutVarint(payload.size());
+	buffer += payload;
+	offsets.push_back(written);
+	std::fwrite(buffer.data(), 1, buffer.size(), file);
+	written += buffer.size();
+	previous = std::move(frame);
+}
+
+bool RecordingReader::Open(const std::string& path) {
+	Close();
+	if (!mapped.Open(path)) {
+		return false;
+	}
+	Reader reader(mapped.Data(), mapped.Size());
+
+	char magic[sizeof(recording_magic)];
+	uint32_t version;
+	uint64_t count;
+	if (!reader.Get(magic) ||
+		std::memcmp(magic, recording_magic, sizeof(magic)) != 0 ||
+		!reader.Get(version) || version != recording_version ||
+		!reader.Get(keyframe_interval) || keyframe_interval == 0 ||
+		!reader.Get(player_id) || !reader.Get(start_location) ||
+		!reader.GetSigned(game_info.width) ||
+		!reader.GetSigned(game_info.height) ||
+		!reader.Get(game_info.map_name) ||
+		!reader.Get(game_info.local_map_path) ||
+		!reader.Get(game_info.playable_min) ||
+		!reader.Get(game_info.playable_max)) {
+		Close();
+		return false;
+	}
+	for (auto* locations : { &game_info.start_locations,
+		&game_info.enemy_start_locations }) {
+		if (!reader.GetCount(count)) {
+			Close();
+			return false;
+		}
+		locations->resize(static_cast<size_t>(count));
+		for (auto& location : *locations) {
+			if (!reader.Get(location)) {
+				Close();
+				return false;
+			}
+		}
+	}
+	if (!reader.GetCount(count)) {
+		Close();
+		return false;
+	}
+	game_info.player_info.resize(static_cast<size_t>(count));
+	for (auto& player : game_info.player_info) {
+		uint32_t player_type;
+		uint32_t race_requested;
+		uint32_t race_actual;
+		uint32_t difficulty;
+		if (!reader.GetVarint(player.player_id) ||
+			!reader.GetVarint(player_type) ||
+			!reader.GetVarint(race_requested) ||
+			!reader.GetVarint(race_actual) || !reader.GetVarint(difficulty) ||
+			!reader.Get(player.player_name)) {
+			Close();
+			return false;
+		}
+		player.player_type = static_cast<PlayerType>(player_type);
+		player.race_requested = static_cast<Race>(race_requested);
+		player.race_actual = static_cast<Race>(race_actual);
+		player.difficulty = static_cast<Difficulty>(difficulty);
+	}
+	if (!reader.Get(game_info.pathing_grid) ||
+		!reader.Get(game_info.placement_grid) ||
+		!reader.Get(game_info.terrain_height)) {
+		Close();
+		return false;
+	}
+	size_t frames_start = static_cast<size_t>(reader.At() - mapped.Data());
+
+	// Use the index if the recording was closed, otherwise find the frames
+	// by their size prefixes
+	const size_t trailer_size = sizeof(uint64_t) + sizeof(uint32_t) +
+		sizeof(recording_end_magic);
+	bool indexed = false;
+	if (mapped.Size() >= frames_start + trailer_size) {
+		Reader trailer(mapped.Data() + mapped.Size() - trailer_size,
+			trailer_size);
+		uint64_t index_start;
+		uint32_t frames;
+		char end_magic[sizeof(recording_end_magic)];
+		if (trailer.Get(index_start) && trailer.Get(frames) &&
+			trailer.Get(end_magic) &&
+			std::memcmp(end_magic, recording_end_magic,
+			sizeof(end_magic)) == 0 && index_start >= frames_start &&
+			index_start + frames * sizeof(uint64_t) + trailer_size ==
+			mapped.Size()) {
+			Reader index(mapped.Data() + index_start,
+				frames * sizeof(uint64_t));
+			offsets.resize(frames);
+			for (auto& offset : offsets) {
+				index.Get(offset);
+			}
+			indexed = true;
+		}
+	}
+	if (!indexed) {
+		size_t at = frames_start;
+		while (at < mapped.Size()) {
+			Reader frame_reader(mapped.Data() + at, mapped.Size() - at);
+			uint64_t size;
+			if (!frame_reader.GetVarint(size) || size == 0 ||
+				size > mapped.Size() - at) {
+				break;
+			}
+			size_t payload_start =
+				static_cast<size_t>(frame_reader.At() - mapped.Data());
+			if (size > mapped.Size() - payload_start) {
+				break;
+			}
+			offsets.push_back(at);
+			at = payload_start + static_cast<size_t>(size);
+		}
+	}
+	next_frame = 0;
+	return true;
+}
+
+void RecordingReader::Close() {
+	mapped.Close();
+	game_info = GameInfo();
+	start_location = Point3D(0.0f, 0.0f, 0.0f);
+	player_id = 0;
+	keyframe_interval = 1;
+	offsets.clear();
+	next_frame = 0;
+	frame = RecordedFrame();
+}
+
+bool RecordingReader::Seek(uint32_t frame_index) {
+	if (frame_index > offsets.size()) {
+		return false;
+	}
+	// Decode forward from the keyframe before it, or from where we are if
+	// that is closer
+	uint32_t keyframe = frame_index - frame_index % keyframe_interval;
+	if (next_frame < keyframe || next_frame > frame_index) {
+		next_frame = keyframe;
+	}
+	while (next_frame < frame_index) {
+		if (!Next()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool RecordingReader::Next() {
+	if (next_frame >= offsets.size()) {
+		return false;
+	}
+	uint64_t offset = offsets[next_frame];
+	if (offset >= mapped.Size()) {
+		return false;
+	}
+	Reader reader(mapped.Data() + offset,
+		mapped.Size() - static_cast<size_t>(offset));
+	uint64_t size;
+	if (!reader.GetVarint(size) ||
+		size > static_cast<uint64_t>(mapped.Data() + mapped.Size() -
+			reader.At())) {
+		return false;
+	}
+	Reader payload(reader.At(), static_cast<size_t>(size));
+	bool keyframe = next_frame % keyframe_interval == 0;
+	if (keyframe) {
+		frame = RecordedFrame();
+	}
+	if (!DecodeFrame(payload, frame, decoded)) {
+		return false;
+	}
+	std::swap(frame, decoded);
+	++next_frame;
+	return true;
+}
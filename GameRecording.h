@@ -0,0 +1,108 @@
+#ifndef GAME_RECORDING_H_
+#define GAME_RECORDING_H_
+
+#include "MappedFile.h"
+
+#include "sc2api/sc2_action.h"
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_gametypes.h"
+#include "sc2api/sc2_interfaces.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Recordings of what the client saw each game loop, for replaying real games
+// through the offline harness.
+//
+// A recording starts with the game info. Each frame holds the raw units,
+// resources, upgrades, results and dead units of one observation plus the
+// actions the bot sent before it. Frames are varint deltas against the frame before
+// them: units that didn't change cost a few bits, moved ones only their
+// changed fields. Every keyframe_interval frames one is stored whole so a
+// reader can seek. Floats are kept to 1/4096, about the precision the game
+// sends. Unit passengers and rally targets aren't recorded.
+//
+// The reader decodes straight from a read-only mapping of the file.
+
+// One recorded game loop
+struct RecordedFrame {
+	uint32_t game_loop = 0;
+	int32_t minerals = 0;
+	int32_t vespene = 0;
+	int32_t food_used = 0;
+	int32_t food_cap = 0;
+	std::vector<sc2::Unit> units;
+	std::vector<sc2::UpgradeID> upgrades;
+	std::vector<sc2::PlayerResult> results;
+	// Units that died since the previous observation, from the raw events.
+	// Units missing from units are only out of sight.
+	std::vector<sc2::Tag> dead_units;
+	// Sent by the bot during the previous step
+	sc2::RawActions actions;
+};
+
+class GameRecorder {
+public:
+	GameRecorder() = default;
+	~GameRecorder();
+
+	GameRecorder(const GameRecorder&) = delete;
+	GameRecorder& operator=(const GameRecorder&) = delete;
+
+	// Creates the file. The header is written with the first frame, once the
+	// game info is known.
+	bool Open(const std::string& path);
+	// Writes the frame index and closes the file
+	void Close();
+	bool IsOpen() const { return file != nullptr; }
+
+	// Appends the observation's current state
+	void Record(const sc2::ObservationInterface* observation);
+
+	uint32_t Frames() const { return static_cast<uint32_t>(offsets.size()); }
+
+private:
+	void WriteHeader(const sc2::ObservationInterface* observation);
+
+	std::FILE* file = nullptr;
+	uint64_t written = 0;
+	bool header_written = false;
+	std::vector<uint64_t> offsets;
+	RecordedFrame previous;
+	std::string buffer;
+};
+
+class RecordingReader {
+public:
+	// Maps the file and reads the header, false if it isn't a recording.
+	// Recordings cut off before Close() are read up to the last whole frame.
+	bool Open(const std::string& path);
+	void Close();
+
+	const sc2::GameInfo& Info() const { return game_info; }
+	sc2::Point3D StartLocation() const { return start_location; }
+	uint32_t PlayerID() const { return player_id; }
+	uint32_t FrameCount() const { return static_cast<uint32_t>(offsets.size()); }
+
+	// Positions the reader so the next call to Next() returns this frame
+	bool Seek(uint32_t frame_index);
+	// Decodes the next frame, false at the end or on a damaged frame
+	bool Next();
+	const RecordedFrame& Frame() const { return frame; }
+
+private:
+	MappedFile mapped;
+	sc2::GameInfo game_info;
+	sc2::Point3D start_location;
+	uint32_t player_id = 0;
+	uint32_t keyframe_interval = 1;
+	std::vector<uint64_t> offsets;
+	uint32_t next_frame = 0;
+	RecordedFrame frame;
+	RecordedFrame decoded;
+};
+
+#endif
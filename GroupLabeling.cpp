@@ -0,0 +1,54 @@
+#include "GroupLabeling.h"
+
+using namespace sc2;
+
+std::vector<std::vector<Point2D>> LabelGroups(
+	const std::vector<Point2D>& points, int width, int height,
+	const std::vector<Point2DI>& offsets) {
+	const int NOT_INTERESTED = -2;
+	const int NOT_COLORED_YET = -1;
+
+	std::vector<int> label(static_cast<size_t>(width) * height, NOT_INTERESTED);
+	auto index = [width](int x, int y) {
+		return static_cast<size_t>(y) * width + x;
+		};
+	for (const auto& point : points) {
+		label[index(static_cast<int>(point.x), static_cast<int>(point.y))] =
+			NOT_COLORED_YET;
+	}
+
+	std::vector<std::vector<Point2D>> groups;
+	int current_color = NOT_COLORED_YET;
+	for (size_t next = points.size(); next-- > 0;) {
+		const Point2D& start = points[next];
+		size_t start_index =
+			index(static_cast<int>(start.x), static_cast<int>(start.y));
+		if (label[start_index] != NOT_COLORED_YET) {
+			continue;
+		}
+		++current_color;
+		label[start_index] = current_color;
+
+		// The group doubles as the queue: points are visited in the order
+		// they were added
+		std::vector<Point2D> group{ start };
+		for (size_t head = 0; head < group.size(); ++head) {
+			int x = static_cast<int>(group[head].x);
+			int y = static_cast<int>(group[head].y);
+			for (const auto& offset : offsets) {
+				int px = x + offset.x;
+				int py = y + offset.y;
+				if (px < 0 || py < 0 || px >= width || py >= height) {
+					continue;
+				}
+				int& cell = label[index(px, py)];
+				if (cell == NOT_COLORED_YET) {
+					cell = current_color;
+					group.emplace_back(float(px), float(py));
+				}
+			}
+		}
+		groups.emplace_back(std::move(group));
+	}
+	return groups;
+}
@@ -0,0 +1,23 @@
+#ifndef GROUP_LABELING_H_
+#define GROUP_LABELING_H_
+
+#include "sc2api/sc2_common.h"
+
+#include <vector>
+
+// Connected groups of map cells, found by a breadth-first search over a label
+// image of the map. Runs in O(cells * neighbors).
+//
+// points are whole cells inside [0, width) x [0, height). Two points are
+// connected if one is another plus one of the offsets.
+//
+// The groups and the order of points inside them match the flood fill
+// find_groups used before:
+// - every group starts at the last point (in input order) not yet grouped
+// - points are listed in the order they are reached, with the offsets tried
+//   in the given order
+std::vector<std::vector<sc2::Point2D>> LabelGroups(
+	const std::vector<sc2::Point2D>& points, int width, int height,
+	const std::vector<sc2::Point2DI>& offsets);
+
+#endif
@@ -1,9 +1,104 @@
 #include "BasicSc2Bot.h"
 
+const ObservationInterface* BasicSc2Bot::Observation() const {
+	return observation_interface ? observation_interface
+		: Agent::Observation();
+}
+
+QueryInterface* BasicSc2Bot::Query() {
+	return query_interface ? query_interface : Agent::Query();
+}
+
+ActionInterface* BasicSc2Bot::Actions() {
+	return action_interface ? action_interface : Agent::Actions();
+}
+
+void BasicSc2Bot::UseInterfaces(const ObservationInterface* observation,
+	QueryInterface* query, ActionInterface* actions) {
+	observation_interface = observation;
+	query_interface = query;
+	action_interface = actions;
+}
+
+// Returns the unit snapshot of the current game loop
+const UnitSnapshot& BasicSc2Bot::Snapshot() const {
+	unit_snapshot.Update(Observation());
+	return unit_snapshot;
+}
+
+// Returns the enemy grid of the current game loop
+const SpatialGrid& BasicSc2Bot::EnemyGrid() const {
+	const UnitSnapshot& units = Snapshot();
+	if (!enemy_grid.IsBuiltFor(units.GameLoop())) {
+		enemy_grid.Build(units.All(Unit::Alliance::Enemy), units.GameLoop());
+	}
+	return enemy_grid;
+}
+
+// Returns the enemy arrays of the current game loop
+const EnemyArrays& BasicSc2Bot::Enemies() const {
+	const UnitSnapshot& units = Snapshot();
+	if (!enemy_arrays.IsBuiltFor(units.GameLoop())) {
+		enemy_arrays.Build(units.All(Unit::Alliance::Enemy), units.GameLoop());
+	}
+	return enemy_arrays;
+}
+
+// Returns the enemy distances of the current game loop
+const DistanceField& BasicSc2Bot::EnemyDistances() const {
+	const UnitSnapshot& units = Snapshot();
+	if (!enemy_distances.IsBuiltFor(units.GameLoop())) {
+		const GameInfo& game_info = Observation()->GetGameInfo();
+		enemy_distances.Build(units.All(Unit::Alliance::Enemy),
+			game_info.width, game_info.height, units.GameLoop());
+	}
+	return enemy_distances;
+}
+
+// Returns the anti-air threat of the current game loop
+const InfluenceMap& BasicSc2Bot::AntiAirThreat() const {
+	const UnitSnapshot& units = Snapshot();
+	if (!anti_air_threat.IsBuiltFor(units.GameLoop())) {
+		const GameInfo& game_info = Observation()->GetGameInfo();
+		anti_air_threat.Reset(game_info.width, game_info.height,
+			units.GameLoop());
+
+		// Same radius the Battlecruisers check for threats
+		const float defense_check_radius = 14.0f;
+		// Snapshots of units count for less the longer ago they were seen.
+		// Structures can't move away, so they keep their full weight.
+		const float snapshot_half_life = 1344.0f;
+		for (const auto& enemy_unit : units.All(Unit::Alliance::Enemy)) {
+			float weight =
+				static_cast<float>(threat_levels[enemy_unit->unit_type]);
+			if (weight == 0.0f) {
+				continue;
+			}
+			if (enemy_unit->display_type == Unit::DisplayType::Snapshot &&
+				units.GameLoop() > enemy_unit->last_seen_game_loop &&
+				!unit_traits.Has(enemy_unit->unit_type, UnitTraits::Structure)) {
+				float age = static_cast<float>(
+					units.GameLoop() - enemy_unit->last_seen_game_loop);
+				weight *= std::exp2(-age / snapshot_half_life);
+			}
+			anti_air_threat.Splat(enemy_unit->pos, defense_check_radius,
+				weight);
+		}
+	}
+	return anti_air_threat;
+}
+
+// Returns the action gateway, bound to this game loop's actions
+ActionGateway& BasicSc2Bot::Commands() {
+	const ObservationInterface* observation = Observation();
+	return action_gateway.Bind(Actions(), observation,
+		observation->GetGameLoop());
+}
+
 // Returns the starting base location
 const Unit* BasicSc2Bot::GetMainBase() const {
 	// Get the main Command Center, Orbital Command, or Planetary Fortress
-	Units command_centers = Observation()->GetUnits(Unit::Self, IsTownHall());
+	const Units& command_centers = Snapshot().TownHalls(Unit::Self);
 	if (!command_centers.empty()) {
 		return command_centers.front();
 	}
@@ -22,18 +117,10 @@ bool BasicSc2Bot::CanBuild(const int32_t mineral, const int32_t gas,
 bool BasicSc2Bot::EnemyNearby(const Point2D& pos, const bool worker,
 	const int32_t distance) {
 	// if enemy units are within a certain radius (run!!!!)
-	const ObservationInterface* obs = Observation();
-	Units enemy_units = obs->GetUnits(Unit::Alliance::Enemy);
-	bool enemy_nearby = false;
-	for (const auto& e : enemy_units) {
-		if (IsTrivialUnit(e) || (worker * IsWorkerUnit(e)))
-			continue;
-		if (Distance2D(e->pos, pos) < 15) {
-			enemy_nearby = true;
-			break;
-		}
-	}
-	return enemy_nearby;
+	return EnemyGrid().AnyInRadius(pos, static_cast<float>(distance),
+		[this, worker](const Unit* e) {
+			return !IsTrivialUnit(e) && !(worker && IsWorkerUnit(e));
+		});
 }
 
 // Returns how close the current resources are to the resource goal
@@ -51,9 +138,8 @@ float BasicSc2Bot::HowClosetoFinishCurrentJob(const Unit* b) const {
 
 // Check if the building is still under construction
 void BasicSc2Bot::IsBuildingProgress() {
-	const ObservationInterface* obs = Observation();
 	Units buildings =
-		obs->GetUnits(Unit::Alliance::Self, [this](const Unit& b) {
+		Snapshot().Select(Unit::Alliance::Self, [this](const Unit& b) {
 		return BuildingsBeingBuiltFilter(b);
 			});
 
@@ -68,7 +154,7 @@ void BasicSc2Bot::IsBuildingProgress() {
 			else {
 				if (b->build_progress != 1.0f &&
 					b->build_progress == it->second) {
-					Actions()->UnitCommand(b,
+					Commands().UnitCommand(b,
 						ABILITY_ID::CANCEL_BUILDINPROGRESS);
 				}
 				else {
@@ -85,8 +171,7 @@ void BasicSc2Bot::IsBuildingProgress() {
 
 // Check if the builder is getting damaged
 void BasicSc2Bot::IsBuilderGettingDamaged() {
-	const ObservationInterface* obs = Observation();
-	Units scvs = obs->GetUnits(Unit::Alliance::Self, [this](const Unit& u) {
+	Units scvs = Snapshot().Select(Unit::Alliance::Self, [this](const Unit& u) {
 		return !u.orders.empty() && IsBuildingOrder(u.orders.front());
 		});
 	for (const auto& scv : scvs) {
@@ -97,7 +182,7 @@ void BasicSc2Bot::IsBuilderGettingDamaged() {
 			}
 			else if (scv->health < it->second) {
 				it->second = scv->health;
-				Actions()->UnitCommand(scv, ABILITY_ID::HALT);
+				Commands().UnitCommand(scv, ABILITY_ID::HALT);
 			}
 		}
 		else {
@@ -109,17 +194,16 @@ void BasicSc2Bot::IsBuilderGettingDamaged() {
 
 // Main base is complete and need expanding
 bool BasicSc2Bot::NeedExpansion() const {
-	const ObservationInterface* observation = Observation();
-
-	// Check if we have any bases
-	Units all_bases = observation->GetUnits(Unit::Self, IsTownHall());
+	// Completed bases, landed or flying
 	Units bases;
-
-	// Filter out completed bases
-	for (const auto& base : all_bases) {
-		if (base->build_progress == 1.0f) {
-			bases.emplace_back(base);
-		}
+	for (UNIT_TYPEID type : { UNIT_TYPEID::TERRAN_COMMANDCENTER,
+		UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING,
+		UNIT_TYPEID::TERRAN_ORBITALCOMMAND,
+		UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING,
+		UNIT_TYPEID::TERRAN_PLANETARYFORTRESS }) {
+		Units of_type = unit_registry.Get(type,
+			UnitRegistry::Complete | UnitRegistry::Flying);
+		bases.insert(bases.end(), of_type.begin(), of_type.end());
 	}
 
 	if (bases.empty()) {
@@ -139,10 +223,7 @@ bool BasicSc2Bot::NeedExpansion() const {
 	}
 
 	// Get current number of SCVs
-	size_t num_scvs =
-		observation
-		->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV))
-		.size();
+	size_t num_scvs = unit_registry.Count(UNIT_TYPEID::TERRAN_SCV);
 
 	// Expand when we have enough SCVs to saturate our current bases
 	return num_scvs >= 0.95f * total_ideal_workers;
@@ -157,7 +238,7 @@ Point3D BasicSc2Bot::GetNextExpansion() const {
 	}
 
 	const std::vector<Point3D>& expansions = expansion_locations;
-	Units townhalls = observation->GetUnits(Unit::Alliance::Self, IsTownHall());
+	const Units& townhalls = Snapshot().TownHalls(Unit::Alliance::Self);
 
 	if (townhalls.empty() || GetMainBase() == nullptr) {
 		return Point3D(0.0f, 0.0f, 0.0f);
@@ -204,7 +285,7 @@ Point2D BasicSc2Bot::GetSafePosition() {
 // Find the closest damaged unit for repair
 const Unit* BasicSc2Bot::FindDamagedUnit() {
 	Units damaged_units =
-		Observation()->GetUnits(Unit::Alliance::Self, [](const Unit& unit) {
+		Snapshot().Select(Unit::Alliance::Self, [](const Unit& unit) {
 		return unit.health < unit.health_max &&
 			(unit.unit_type == UNIT_TYPEID::TERRAN_BATTLECRUISER ||
 				unit.unit_type == UNIT_TYPEID::TERRAN_SIEGETANK ||
@@ -215,7 +296,7 @@ const Unit* BasicSc2Bot::FindDamagedUnit() {
 
 // Find the closest damaged structure for repair
 const Unit* BasicSc2Bot::FindDamagedStructure() {
-	const auto& units = Observation()->GetUnits(Unit::Alliance::Self);
+	const auto& units = Snapshot().All(Unit::Alliance::Self);
 
 	const Unit* highest_priority_target = nullptr;
 	int highest_priority = std::numeric_limits<int>::max();
@@ -266,36 +347,20 @@ const Unit* BasicSc2Bot::FindDamagedStructure() {
 
 // Check if the main base is under attack
 bool BasicSc2Bot::IsWorkerUnit(const Unit* unit) {
-	return unit->unit_type == UNIT_TYPEID::TERRAN_SCV ||
-		unit->unit_type == UNIT_TYPEID::PROTOSS_PROBE ||
-		unit->unit_type == UNIT_TYPEID::ZERG_DRONE ||
-		unit->unit_type == UNIT_TYPEID::TERRAN_MULE;
+	return worker_types.Has(unit->unit_type);
 }
 
 bool BasicSc2Bot::IsTrivialUnit(const Unit* unit) const {
-	return unit->unit_type == UNIT_TYPEID::ZERG_OVERLORD ||
-		unit->unit_type == UNIT_TYPEID::ZERG_OVERSEER ||
-		unit->unit_type == UNIT_TYPEID::ZERG_OVERSEERSIEGEMODE ||
-		unit->unit_type == UNIT_TYPEID::ZERG_CHANGELING ||
-		unit->unit_type == UNIT_TYPEID::ZERG_CHANGELINGMARINE ||
-		unit->unit_type == UNIT_TYPEID::ZERG_CHANGELINGMARINESHIELD ||
-		unit->unit_type == UNIT_TYPEID::PROTOSS_OBSERVER ||
-		unit->unit_type == UNIT_TYPEID::PROTOSS_OBSERVERSIEGEMODE;
+	return trivial_types.Has(unit->unit_type);
+}
+
+// Unit type flags for the hot paths
+void BasicSc2Bot::BuildUnitTraits() {
+	unit_traits.Build(Observation()->GetUnitTypeData());
 }
 
 bool BasicSc2Bot::IsBuildingOrder(const UnitOrder& order) const {
-	return order.ability_id == ABILITY_ID::BUILD_ARMORY ||
-		order.ability_id == ABILITY_ID::BUILD_BARRACKS ||
-		order.ability_id == ABILITY_ID::BUILD_BUNKER ||
-		order.ability_id == ABILITY_ID::BUILD_COMMANDCENTER ||
-		order.ability_id == ABILITY_ID::BUILD_ENGINEERINGBAY ||
-		order.ability_id == ABILITY_ID::BUILD_FACTORY ||
-		order.ability_id == ABILITY_ID::BUILD_FUSIONCORE ||
-		order.ability_id == ABILITY_ID::BUILD_GHOSTACADEMY ||
-		order.ability_id == ABILITY_ID::BUILD_MISSILETURRET ||
-		order.ability_id == ABILITY_ID::BUILD_REFINERY ||
-		order.ability_id == ABILITY_ID::BUILD_STARPORT ||
-		order.ability_id == ABILITY_ID::BUILD_SUPPLYDEPOT;
+	return build_abilities.Has(order.ability_id);
 }
 
 bool BasicSc2Bot::ALLBuildingsFilter(const Unit& unit) const {
@@ -315,39 +380,20 @@ bool BasicSc2Bot::IsMainBaseUnderAttack() {
 	}
 
 	// Check if there are enemy combat units near our main base
-	Units enemy_units_near_base = Observation()->GetUnits(
-		Unit::Alliance::Enemy, [this, main_base](const Unit& unit) {
-			float distance = Distance2D(unit.pos, main_base->pos);
-			if (distance < 25.0f && !IsWorkerUnit(&unit) &&
-				!IsTrivialUnit(&unit)) {
-				return true;
-			}
-			return false;
+	return EnemyGrid().AnyInRadius(main_base->pos, 25.0f,
+		[this](const Unit* unit) {
+			return !IsWorkerUnit(unit) && !IsTrivialUnit(unit);
 		});
-
-	return !enemy_units_near_base.empty();
 }
 
 // Find the closest enemy unit to a given position
 const Unit* BasicSc2Bot::FindClosestEnemy(const Point2D& pos) {
-	const Unit* closest_enemy = nullptr;
-	float closest_distance = std::numeric_limits<float>::max();
-
-	for (const auto& unit : Observation()->GetUnits(Unit::Alliance::Enemy)) {
-		float distance = Distance2D(pos, unit->pos);
-		if (distance < closest_distance) {
-			closest_distance = distance;
-			closest_enemy = unit;
-		}
-	}
-	return closest_enemy;
+	return EnemyGrid().Nearest(pos, [](const Unit*) { return true; });
 }
 
 // Check if the unit has a specific ability
 const Unit* BasicSc2Bot::FindUnit(sc2::UnitTypeID unit_type) const {
-	const ObservationInterface* observation = Observation();
-	Units units =
-		observation->GetUnits(Unit::Alliance::Self, IsUnit(unit_type));
+	const Units& units = Snapshot().OfType(Unit::Alliance::Self, unit_type);
 	for (const auto& unit : units) {
 		// Exclude SCVs that are currently constructing
 		if (unit->orders.empty() ||
@@ -363,13 +409,12 @@ bool BasicSc2Bot::TryBuildStructureAtLocation(
 	ABILITY_ID ability_type_for_structure, UNIT_TYPEID unit_type,
 	const Point2D& location) {
 	const Unit* builder = FindUnit(unit_type);
-	Units gas_scvs = GetAllSCVsGettingGas();
-	auto it = FindInVector(gas_scvs, builder);
 
-	if (builder && it == gas_scvs.end() &&
-		scvs_repairing.find(builder->tag) == scvs_repairing.end()) {
-		if (Query()->Placement(ability_type_for_structure, location, builder)) {
-			Actions()->UnitCommand(builder, ability_type_for_structure,
+	if (builder && !worker_roles.Has(builder->tag,
+		WorkerRoles::Gas | WorkerRoles::RepairCrew)) {
+		if (placement_planner.CanPlace(Query(), current_gameloop,
+			ability_type_for_structure, location, builder)) {
+			Commands().UnitCommand(builder, ability_type_for_structure,
 				location);
 			return true;
 		}
@@ -389,13 +434,12 @@ Point2D BasicSc2Bot::GetRallyPoint() {
 }
 
 void BasicSc2Bot::SetRallyPoint(const Unit* b, const Point2D& p) {
-	Actions()->UnitCommand(b, ABILITY_ID::RALLY_BUILDING, p);
+	Commands().UnitCommand(b, ABILITY_ID::RALLY_BUILDING, p);
 	return;
 }
 
 const Unit* BasicSc2Bot::GetLeastSaturatedBase() const {
-	const ObservationInterface* observation = Observation();
-	Units bases = observation->GetUnits(Unit::Alliance::Self, IsTownHall());
+	const Units& bases = Snapshot().TownHalls(Unit::Alliance::Self);
 	const Unit* least_saturated_base = nullptr;
 	int max_worker_need = 0;
 
@@ -422,30 +466,62 @@ Point2D BasicSc2Bot::GetNearestSafePosition(const Point2D& pos) {
 	const int grid_steps = 5;          // Granularity of the search grid
 
 	// Get all enemy units
-	Units enemy_units = Observation()->GetUnits(Unit::Alliance::Enemy);
+	const Units& enemy_units = Snapshot().All(Unit::Alliance::Enemy);
 	if (enemy_units.empty()) {
 		return pos; // Return the original position if there are no enemies
 	}
 
-	// Check if a position is safe
-	auto is_safe = [&enemy_units, safe_radius](const Point2D& candidate) {
-		for (const auto& enemy : enemy_units) {
-			if (enemy && Distance2D(enemy->pos, candidate) <
-				safe_radius) { // Ensure enemy is not null
-				return false; // Unsafe if an enemy is within the safe_radius
+	// Offsets of the search grid, grouped by distance from the position and
+	// nearest first. Offsets in a group keep the grid's order (dx, then dy).
+	static const std::vector<std::vector<Point2D>> search_rings = [&]() {
+		std::vector<Point2D> offsets;
+		for (float dx = -search_radius; dx <= search_radius; dx += grid_steps) {
+			for (float dy = -search_radius; dy <= search_radius;
+				dy += grid_steps) {
+				offsets.emplace_back(dx, dy);
+			}
+		}
+		auto length = [](const Point2D& p) { return p.x * p.x + p.y * p.y; };
+		std::stable_sort(offsets.begin(), offsets.end(),
+			[&length](const Point2D& a, const Point2D& b) {
+				return length(a) < length(b);
+			});
+		std::vector<std::vector<Point2D>> rings;
+		for (const auto& offset : offsets) {
+			if (rings.empty() || length(rings.back().front()) != length(offset)) {
+				rings.emplace_back();
 			}
+			rings.back().push_back(offset);
 		}
-		return true; // Safe if no enemies are within the safe_radius
+		return rings;
+	}();
+
+	// Check if a position is safe. The distance field settles most positions;
+	// the ones near the edge of the safe radius check the enemies around them.
+	const DistanceField& enemy_distance = EnemyDistances();
+	const SpatialGrid& enemies = EnemyGrid();
+	auto is_safe = [&](const Point2D& candidate) {
+		float distance;
+		if (enemy_distance.Distance(candidate, distance)) {
+			if (distance >= safe_radius + enemy_distance.MaxError()) {
+				return true;
+			}
+			if (distance + enemy_distance.MaxError() < safe_radius) {
+				return false;
+			}
+		}
+		return !enemies.AnyInRadius(candidate, safe_radius,
+			[](const Unit*) { return true; });
 		};
 
-	// Start searching for the nearest safe position
-	Point2D nearest_safe_position = pos;
-	float min_distance = std::numeric_limits<float>::max();
-
-	// Search within a grid around the position
-	for (float dx = -search_radius; dx <= search_radius; dx += grid_steps) {
-		for (float dy = -search_radius; dy <= search_radius; dy += grid_steps) {
-			Point2D candidate = pos + Point2D(dx, dy);
+	// The first ring with a safe position has the nearest one. Distances in a
+	// ring differ only by float rounding, so the closest by Distance2D wins
+	// there and ties go to grid order, as in a scan of the whole grid.
+	for (const auto& ring : search_rings) {
+		Point2D nearest_safe_position = pos;
+		float min_distance = std::numeric_limits<float>::max();
+		for (const auto& offset : ring) {
+			Point2D candidate = pos + offset;
 			if (is_safe(candidate)) {
 				float distance = Distance2D(pos, candidate);
 				if (distance < min_distance) {
@@ -454,17 +530,18 @@ Point2D BasicSc2Bot::GetNearestSafePosition(const Point2D& pos) {
 				}
 			}
 		}
+		if (min_distance != std::numeric_limits<float>::max()) {
+			return nearest_safe_position;
+		}
 	}
 
-	// Return the nearest safe position (defaults to the original position if no
-	// safe position is found)
-	return nearest_safe_position;
+	// Return the original position if no safe position is found
+	return pos;
 }
 
 // Returns true if any base is not full hp
 bool BasicSc2Bot::IsAnyBaseUnderAttack() {
-	const ObservationInterface* observation = Observation();
-	Units bases = observation->GetUnits(Unit::Alliance::Self, IsTownHall());
+	const Units& bases = Snapshot().TownHalls(Unit::Alliance::Self);
 	for (const auto& base : bases) {
 		if (base->health < base->health_max) {
 			return true;
@@ -475,7 +552,7 @@ bool BasicSc2Bot::IsAnyBaseUnderAttack() {
 
 // Move our units to the enemy
 void BasicSc2Bot::MoveToEnemy(const Units& marines, const Units& siege_tanks) {
-	Units enemy_units = Observation()->GetUnits(Unit::Alliance::Enemy);
+	const Units& enemy_units = Snapshot().All(Unit::Alliance::Enemy);
 
 	// Find the closest enemy unit to the first marine
 	if (marines.empty()) {
@@ -499,11 +576,11 @@ void BasicSc2Bot::MoveToEnemy(const Units& marines, const Units& siege_tanks) {
 
 	// Move all units to the closest enemy
 	for (const auto& marine : marines) {
-		Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
+		Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
 			closest_enemy->pos);
 	}
 	for (const auto& tank : siege_tanks) {
-		Actions()->UnitCommand(tank, ABILITY_ID::MOVE_MOVE, closest_enemy->pos);
+		Commands().UnitCommand(tank, ABILITY_ID::MOVE_MOVE, closest_enemy->pos);
 	}
 }
 
@@ -526,29 +603,14 @@ bool BasicSc2Bot::HasAbility(const Unit* unit, AbilityID ability_id) {
 // How many units of a given type are in combat
 int BasicSc2Bot::UnitsInCombat(UNIT_TYPEID unit_type) {
 	int num_unit = 0;
+	const EnemyArrays& enemies = Enemies();
 
 	// Get all units of the specified type
-	for (const auto& unit :
-		Observation()->GetUnits(Unit::Alliance::Self, IsUnit(unit_type))) {
+	for (const auto& unit : Snapshot().OfType(Unit::Alliance::Self, unit_type)) {
 
-		bool is_near_enemy = false;
-
-		// Check proximity to enemy units
-		for (const auto& enemy_unit :
-			Observation()->GetUnits(Unit::Alliance::Enemy)) {
-
-			// Do not count trivial units
-			if (IsTrivialUnit(enemy_unit)) {
-				continue;
-			}
-
-			// Check if the unit is near an enemy
-			float distance_to_enemy = Distance2D(unit->pos, enemy_unit->pos);
-			if (distance_to_enemy <= 15.0f) {
-				is_near_enemy = true;
-				break;
-			}
-		}
+		// Check proximity to enemy units (do not count trivial units)
+		bool is_near_enemy = enemies.AnyInRadius(unit->pos, 15.0f,
+			EnemyArrays::NonTrivial);
 
 		// Count unit if it is near at least one enemy
 		if (is_near_enemy) {
@@ -561,8 +623,8 @@ int BasicSc2Bot::UnitsInCombat(UNIT_TYPEID unit_type) {
 
 const Unit* BasicSc2Bot::FindNearestMineralPatch() {
 	// Find closest mineral patches
-	Units mineral_patches = Observation()->GetUnits(
-		Unit::Alliance::Neutral, IsUnit(UNIT_TYPEID::NEUTRAL_MINERALFIELD));
+	const Units& mineral_patches = Snapshot().OfType(
+		Unit::Alliance::Neutral, UNIT_TYPEID::NEUTRAL_MINERALFIELD);
 	const Unit* closest_mineral = nullptr;
 	float min_distance = std::numeric_limits<float>::max();
 
@@ -582,8 +644,8 @@ const Unit* BasicSc2Bot::FindNearestMineralPatch() {
 
 const Unit* BasicSc2Bot::FindRefinery() {
 	// Find all refineries
-	Units refineries = Observation()->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_REFINERY));
+	const Units& refineries = Snapshot().OfType(
+		Unit::Alliance::Self, UNIT_TYPEID::TERRAN_REFINERY);
 
 	// Find a refinery with fewer than 3 workers
 	const Unit* target_refinery = nullptr;
@@ -601,8 +663,6 @@ const Unit* BasicSc2Bot::FindRefinery() {
 
 void BasicSc2Bot::HarvestIdleWorkers(const Unit* unit) {
 
-	auto scv_repair = scvs_repairing.find(unit->tag);
-
 	if (!unit || unit == scv_scout || unit == scv_building) {
 		return;
 	}
@@ -612,7 +672,7 @@ void BasicSc2Bot::HarvestIdleWorkers(const Unit* unit) {
 
 	// Assign the SCV to the refinery if found
 	if (target_refinery) {
-		Actions()->UnitCommand(unit, ABILITY_ID::HARVEST_GATHER,
+		Commands().UnitCommand(unit, ABILITY_ID::HARVEST_GATHER,
 			target_refinery);
 		return;
 	}
@@ -621,7 +681,7 @@ void BasicSc2Bot::HarvestIdleWorkers(const Unit* unit) {
 	const Unit* closest_mineral = FindNearestMineralPatch();
 	// Assign the SCV to harvest minerals if a mineral patch is found
 	if (closest_mineral) {
-		Actions()->UnitCommand(unit, ABILITY_ID::HARVEST_GATHER,
+		Commands().UnitCommand(unit, ABILITY_ID::HARVEST_GATHER,
 			closest_mineral);
 		return;
 	}
@@ -629,22 +689,5 @@ void BasicSc2Bot::HarvestIdleWorkers(const Unit* unit) {
 
 // Returns all SCVs that are currently gathering gas
 Units BasicSc2Bot::GetAllSCVsGettingGas() const {
-	const ObservationInterface* obs = Observation();
-	Units gas_buildings = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_REFINERY));
-	Units scvs =
-		obs->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SCV));
-	;
-	// Find all SCVs that are currently gathering gas
-	Units gas_scvs;
-	for (const auto& scv : scvs) {
-		for (const auto& gas_b : gas_buildings) {
-			if (scv->orders.size() >= 1 &&
-				scv->orders.front().ability_id == ABILITY_ID::HARVEST_GATHER &&
-				scv->orders.front().target_unit_tag == gas_b->tag) {
-				gas_scvs.emplace_back(scv);
-			}
-		}
-	}
-	return gas_scvs;
+	return worker_roles.Get(WorkerRoles::Gas);
 }
@@ -0,0 +1,63 @@
+#include "InfluenceMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace sc2;
+
+void InfluenceMap::Reset(int map_width, int map_height, uint32_t game_loop) {
+	width = std::max(map_width, 0);
+	height = std::max(map_height, 0);
+	cells.assign(static_cast<size_t>(width) * height, 0.0f);
+	built_loop = game_loop;
+	built = true;
+}
+
+void InfluenceMap::Splat(const Point2D& pos, float radius, float weight) {
+	if (weight == 0.0f || radius <= 0.0f) {
+		return;
+	}
+	// Rows whose centers are in range, then the span of each row
+	int y0 = std::max(static_cast<int>(std::ceil(pos.y - radius - 0.5f)), 0);
+	int y1 = std::min(static_cast<int>(std::floor(pos.y + radius - 0.5f)),
+		height - 1);
+	for (int y = y0; y <= y1; ++y) {
+		float dy = y + 0.5f - pos.y;
+		float squared = radius * radius - dy * dy;
+		if (squared <= 0.0f) {
+			continue;
+		}
+		float dx = std::sqrt(squared);
+		int x0 = std::max(static_cast<int>(std::ceil(pos.x - dx - 0.5f)), 0);
+		int x1 = std::min(static_cast<int>(std::floor(pos.x + dx - 0.5f)),
+			width - 1);
+		float* row = &cells[static_cast<size_t>(y) * width];
+		for (int x = x0; x <= x1; ++x) {
+			float cx = x + 0.5f - pos.x;
+			// The span is rounded outwards at its ends
+			if (cx * cx + dy * dy < radius * radius) {
+				row[x] += weight;
+			}
+		}
+	}
+}
+
+float InfluenceMap::Sample(const Point2D& pos) const {
+	if (pos.x < 0.0f || pos.y < 0.0f) {
+		return 0.0f;
+	}
+	int x = static_cast<int>(pos.x);
+	int y = static_cast<int>(pos.y);
+	if (x >= width || y >= height) {
+		return 0.0f;
+	}
+	return cells[static_cast<size_t>(y) * width + x];
+}
+
+Point2D InfluenceMap::Gradient(const Point2D& pos, float step) const {
+	float dx = Sample(Point2D(pos.x + step, pos.y)) -
+		Sample(Point2D(pos.x - step, pos.y));
+	float dy = Sample(Point2D(pos.x, pos.y + step)) -
+		Sample(Point2D(pos.x, pos.y - step));
+	return Point2D(dx / (2.0f * step), dy / (2.0f * step));
+}
@@ -0,0 +1,43 @@
+#ifndef INFLUENCE_MAP_H_
+#define INFLUENCE_MAP_H_
+
+#include "sc2api/sc2_common.h"
+
+#include <cstdint>
+#include <vector>
+
+// Weights of units spread over the map, one value per cell. Every unit adds
+// its weight to the cells whose centers are closer than its radius, so a
+// sample is the sum over the units in range of that point, to within half a
+// cell diagonal. Rebuilt once per game loop.
+class InfluenceMap {
+public:
+	// Clears the map and sizes it to the game map
+	void Reset(int map_width, int map_height, uint32_t game_loop);
+
+	// True if the map was built for the given game loop
+	bool IsBuiltFor(uint32_t game_loop) const {
+		return built && game_loop == built_loop;
+	}
+
+	// Adds weight to every cell closer than radius to pos
+	void Splat(const sc2::Point2D& pos, float radius, float weight);
+
+	// The value at pos, 0 off the map
+	float Sample(const sc2::Point2D& pos) const;
+
+	// Direction of increasing influence at pos, from samples step apart on
+	// each axis. (0, 0) where the map is flat.
+	sc2::Point2D Gradient(const sc2::Point2D& pos, float step) const;
+
+private:
+	int width = 0;
+	int height = 0;
+	// x + y * width
+	std::vector<float> cells;
+
+	uint32_t built_loop = 0;
+	bool built = false;
+};
+
+#endif
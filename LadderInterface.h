@@ -74,14 +74,17 @@ static sc2::Race GetRaceFromString(const std::string& RaceIn)
 
 struct ConnectionOptions
 {
-	int32_t GamePort;
-	int32_t StartPort;
+	int32_t GamePort = 0;
+	// Ports from here on are used by the game, 0 for the default ports
+	int32_t StartPort = 0;
 	std::string ServerAddress;
-	bool ComputerOpponent;
-	sc2::Difficulty ComputerDifficulty;
-	sc2::Race ComputerRace;
+	bool ComputerOpponent = false;
+	sc2::Difficulty ComputerDifficulty = sc2::Difficulty::Easy;
+	sc2::Race ComputerRace = sc2::Race::Random;
 	std::string OpponentId;
 	std::string Map;
+	// Where to record the game's frames, empty to not record
+	std::string RecordPath;
 };
 
 static void ParseArguments(int argc, char* argv[], ConnectionOptions& connect_options)
@@ -95,7 +98,8 @@ static void ParseArguments(int argc, char* argv[], ConnectionOptions& connect_op
 		{ "-a", "--ComputerRace", "Race of computer oppent"},
 		{ "-d", "--ComputerDifficulty", "Difficulty of computer oppenent"},
 		{ "-m", "--Map", "Map to play on against computer opponent", },
-		{ "-x", "--OpponentId", "PlayerId of opponent"}
+		{ "-x", "--OpponentId", "PlayerId of opponent"},
+		{ "-r", "--Record", "File to record the game's frames to, for replaying offline"}
 		});
 	arg_parser.Parse(argc, argv);
 	std::string GamePortStr;
@@ -135,13 +139,14 @@ static void ParseArguments(int argc, char* argv[], ConnectionOptions& connect_op
 		connect_options.ComputerOpponent = false;
 	}
 	arg_parser.Get("OpponentId", connect_options.OpponentId);
+	arg_parser.Get("Record", connect_options.RecordPath);
 }
 
-static void RunBot(int argc, char* argv[], sc2::Agent* Agent, sc2::Race race)
+// Plays one game with the options, also used by the evaluation runner
+// (runner/)
+static void RunGame(const ConnectionOptions& Options, char* argv[],
+	sc2::Agent* Agent, sc2::Race race)
 {
-	ConnectionOptions Options;
-	ParseArguments(argc, argv, Options);
-
 	/*class Human : public sc2::Agent {
 	public:
 		void OnGameStart() final {
@@ -160,6 +165,9 @@ static void RunBot(int argc, char* argv[], sc2::Agent* Agent, sc2::Race race)
 			CreateComputer(Options.ComputerRace, Options.ComputerDifficulty)
 			});
 		coordinator.LoadSettings(1, argv);
+		if (Options.StartPort > 0) {
+			coordinator.SetPortStart(Options.StartPort);
+		}
 		// added
 		//coordinator.SetRealtime(true);
 		coordinator.LaunchStarcraft();
@@ -179,7 +187,27 @@ static void RunBot(int argc, char* argv[], sc2::Agent* Agent, sc2::Race race)
 		std::cout << " Successfully joined game" << std::endl;
 	}
 
+	GameRecorder recorder;
+	if (!Options.RecordPath.empty() && !recorder.Open(Options.RecordPath)) {
+		std::cout << "Could not record to " << Options.RecordPath << std::endl;
+	}
+
 	coordinator.SetTimeoutMS(10000);
 	while (coordinator.Update()) {
+		recorder.Record(Agent->Observation());
 	}
+	if (recorder.IsOpen()) {
+		// The last observation has the results
+		recorder.Record(Agent->Observation());
+		std::cout << "Recorded " << recorder.Frames() << " frames to "
+			<< Options.RecordPath << std::endl;
+		recorder.Close();
+	}
+}
+
+static void RunBot(int argc, char* argv[], sc2::Agent* Agent, sc2::Race race)
+{
+	ConnectionOptions Options;
+	ParseArguments(argc, argv, Options);
+	RunGame(Options, argv, Agent, race);
 }
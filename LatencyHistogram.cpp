@@ -0,0 +1,59 @@
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+double LatencyHistogram::BucketLimit(size_t bucket) {
+	return std::pow(1.1, static_cast<double>(bucket));
+}
+
+void LatencyHistogram::Record(double microseconds) {
+	size_t bucket = 0;
+	if (microseconds > 1.0) {
+		bucket = static_cast<size_t>(
+			std::ceil(std::log(microseconds) / std::log(1.1)));
+	}
+	buckets[std::min(bucket, bucket_count - 1)]++;
+	count++;
+	total += microseconds;
+	max = std::max(max, microseconds);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+	for (size_t i = 0; i < bucket_count; ++i) {
+		buckets[i] += other.buckets[i];
+	}
+	count += other.count;
+	total += other.total;
+	max = std::max(max, other.max);
+}
+
+double LatencyHistogram::Percentile(double fraction) const {
+	uint64_t wanted =
+		static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < bucket_count; ++i) {
+		seen += buckets[i];
+		if (seen >= wanted) {
+			// The bucket limit overshoots the slowest time for few times
+			return std::min(BucketLimit(i), max);
+		}
+	}
+	return max;
+}
+
+void LatencyHistogram::Write(std::ostream& out) const {
+	out << count << " " << total << " " << max;
+	for (uint64_t bucket : buckets) {
+		out << " " << bucket;
+	}
+	out << "\n";
+}
+
+bool LatencyHistogram::Read(std::istream& in) {
+	in >> count >> total >> max;
+	for (auto& bucket : buckets) {
+		in >> bucket;
+	}
+	return static_cast<bool>(in);
+}
@@ -0,0 +1,43 @@
+#ifndef LATENCY_HISTOGRAM_H_
+#define LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+// Times in microseconds, counted in fixed buckets. Bucket i holds times up to
+// BucketLimit(i); buckets grow by about 10 % from 1 us, so the last one ends
+// past 100 s. All histograms share the buckets, so merged ones (of many
+// games, say) keep exact bucket counts.
+//
+// Used by FrameProfiler per OnStep stage and by the runner per game.
+class LatencyHistogram {
+public:
+	static const size_t bucket_count = 200;
+
+	static double BucketLimit(size_t bucket);
+
+	void Record(double microseconds);
+	void Merge(const LatencyHistogram& other);
+
+	// Upper limit of the bucket holding the given fraction of the times
+	double Percentile(double fraction) const;
+
+	uint64_t Count() const { return count; }
+	double Total() const { return total; }
+	double Max() const { return max; }
+
+	// One line of text, for passing histograms between processes
+	void Write(std::ostream& out) const;
+	bool Read(std::istream& in);
+
+private:
+	std::array<uint64_t, bucket_count> buckets{};
+	uint64_t count = 0;
+	double total = 0.0;
+	double max = 0.0;
+};
+
+#endif
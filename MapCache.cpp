@@ -0,0 +1,290 @@
+#include "MapCache.h"
+
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace sc2;
+
+namespace {
+// Bump when the layout or the analysis itself changes
+const uint32_t map_cache_version = 1;
+const char map_cache_magic[8] = { 'U', 'E', 'D', 'M', 'A', 'P', 'C', '\0' };
+const char* map_cache_dir = "map_cache";
+
+// FNV-1a
+uint64_t Hash(uint64_t hash, const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+class Writer {
+public:
+	template <typename T>
+	void Put(const T& value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void Put(const std::string& value) {
+		Put(static_cast<uint32_t>(value.size()));
+		buffer.append(value);
+	}
+
+	void Put(const Point2D& p) {
+		Put(p.x);
+		Put(p.y);
+	}
+
+	void Put(const Point3D& p) {
+		Put(p.x);
+		Put(p.y);
+		Put(p.z);
+	}
+
+	template <typename T>
+	void Put(const std::vector<T>& values) {
+		Put(static_cast<uint32_t>(values.size()));
+		for (const auto& value : values) {
+			Put(value);
+		}
+	}
+
+	const std::string& Buffer() const { return buffer; }
+
+private:
+	std::string buffer;
+};
+
+// Size of a saved build map: its rows of 64 bit words, as BuildGrid keeps
+// them
+size_t GridBytes(int width, int height) {
+	return static_cast<size_t>((width + 63) / 64) * height * sizeof(uint64_t);
+}
+
+// Bounds checked reads from the mapped file
+class Reader {
+public:
+	Reader(const uint8_t* data, size_t size) : at(data), end(data + size) {}
+
+	template <typename T>
+	bool Get(T& value) {
+		if (static_cast<size_t>(end - at) < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, at, sizeof(T));
+		at += sizeof(T);
+		return true;
+	}
+
+	bool Get(std::string& value) {
+		uint32_t size;
+		if (!Get(size) || static_cast<size_t>(end - at) < size) {
+			return false;
+		}
+		value.assign(reinterpret_cast<const char*>(at), size);
+		at += size;
+		return true;
+	}
+
+	bool Get(Point2D& p) {
+		return Get(p.x) && Get(p.y);
+	}
+
+	bool Get(Point3D& p) {
+		return Get(p.x) && Get(p.y) && Get(p.z);
+	}
+
+	template <typename T>
+	bool Get(std::vector<T>& values) {
+		uint32_t count;
+		if (!Get(count) || count > static_cast<size_t>(end - at)) {
+			return false;
+		}
+		values.resize(count);
+		for (auto& value : values) {
+			if (!Get(value)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Get(BuildGrid& grid, int width, int height) {
+		size_t bytes = GridBytes(width, height);
+		if (Remaining() < bytes) {
+			return false;
+		}
+		grid = BuildGrid(width, height);
+		std::vector<uint64_t> words(bytes / sizeof(uint64_t));
+		std::memcpy(words.data(), at, bytes);
+		at += bytes;
+		grid.LoadMapWords(words.data());
+		return true;
+	}
+
+	size_t Remaining() const { return static_cast<size_t>(end - at); }
+	bool AtEnd() const { return at == end; }
+
+private:
+	const uint8_t* at;
+	const uint8_t* end;
+};
+
+void MakeDirectory(const char* path) {
+#ifdef _WIN32
+	_mkdir(path);
+#else
+	mkdir(path, 0755);
+#endif
+}
+}
+
+MapCacheKey MapCacheKey::FromGame(const GameInfo& game_info,
+	const Point2D& start_location) {
+	uint64_t hash = 14695981039346656037ull;
+	hash = Hash(hash, &game_info.width, sizeof(game_info.width));
+	hash = Hash(hash, &game_info.height, sizeof(game_info.height));
+	for (const ImageData* image : { &game_info.pathing_grid,
+		&game_info.placement_grid, &game_info.terrain_height }) {
+		hash = Hash(hash, image->data.data(), image->data.size());
+	}
+	return { game_info.map_name, hash, start_location };
+}
+
+std::string MapCachePath(const MapCacheKey& key) {
+	// Keep the file name portable
+	std::string name;
+	for (char c : key.map_name) {
+		bool plain = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9');
+		name += plain ? c : '_';
+	}
+	std::ostringstream path;
+	path << map_cache_dir << "/" << name << "_"
+		<< static_cast<int>(key.start_location.x) << "_"
+		<< static_cast<int>(key.start_location.y) << ".bin";
+	return path.str();
+}
+
+bool LoadMapAnalysis(const MapCacheKey& key, MapAnalysis& analysis) {
+	MappedFile file;
+	if (!file.Open(MapCachePath(key))) {
+		return false;
+	}
+	Reader reader(file.Data(), file.Size());
+
+	char magic[sizeof(map_cache_magic)];
+	uint32_t version;
+	std::string map_name;
+	uint64_t map_hash;
+	Point2D start_location;
+	if (!reader.Get(magic) ||
+		std::memcmp(magic, map_cache_magic, sizeof(magic)) != 0 ||
+		!reader.Get(version) || version != map_cache_version ||
+		!reader.Get(map_name) || map_name != key.map_name ||
+		!reader.Get(map_hash) || map_hash != key.map_hash ||
+		!reader.Get(start_location) ||
+		start_location != key.start_location) {
+		return false;
+	}
+
+	MapAnalysis loaded;
+	uint32_t grids;
+	int32_t width;
+	int32_t height;
+	if (!reader.Get(loaded.expansion_locations) ||
+		!reader.Get(loaded.ramps) ||
+		!reader.Get(loaded.depot_points) ||
+		!reader.Get(loaded.barrack_point) ||
+		!reader.Get(grids) || !reader.Get(width) || !reader.Get(height) ||
+		width < 0 || height < 0 || width > 1024 || height > 1024) {
+		return false;
+	}
+	// The grids must fit in the rest of the file, so a broken count can't
+	// allocate more than that
+	if (grids > reader.Remaining() /
+		std::max(GridBytes(width, height), sizeof(uint64_t))) {
+		return false;
+	}
+	loaded.build_map.resize(grids);
+	for (auto& grid : loaded.build_map) {
+		if (!reader.Get(grid, width, height)) {
+			return false;
+		}
+	}
+	if (!reader.Get(loaded.scout_points) || !reader.AtEnd()) {
+		return false;
+	}
+	analysis = std::move(loaded);
+	return true;
+}
+
+bool SaveMapAnalysis(const MapCacheKey& key, const MapAnalysis& analysis) {
+	Writer writer;
+	writer.Put(map_cache_magic);
+	writer.Put(map_cache_version);
+	writer.Put(key.map_name);
+	writer.Put(key.map_hash);
+	writer.Put(key.start_location);
+	writer.Put(analysis.expansion_locations);
+	writer.Put(analysis.ramps);
+	writer.Put(analysis.depot_points);
+	writer.Put(analysis.barrack_point);
+
+	// All build maps cover the whole map, so they share one size
+	int32_t width = analysis.build_map.empty()
+		? 0 : analysis.build_map.front().Width();
+	int32_t height = analysis.build_map.empty()
+		? 0 : analysis.build_map.front().Height();
+	writer.Put(static_cast<uint32_t>(analysis.build_map.size()));
+	writer.Put(width);
+	writer.Put(height);
+	for (const auto& grid : analysis.build_map) {
+		if (grid.Width() != width || grid.Height() != height) {
+			return false;
+		}
+		for (uint64_t word : grid.MapWords()) {
+			writer.Put(word);
+		}
+	}
+	writer.Put(analysis.scout_points);
+
+	// Write a temporary file and rename it, so games started at the same
+	// time never map a half written file
+	MakeDirectory(map_cache_dir);
+	std::string path = MapCachePath(key);
+	std::string temp_path = path + "." + std::to_string(std::random_device()());
+	FILE* out = std::fopen(temp_path.c_str(), "wb");
+	if (!out) {
+		return false;
+	}
+	const std::string& buffer = writer.Buffer();
+	bool written =
+		std::fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+	written = std::fclose(out) == 0 && written;
+	if (!written) {
+		std::remove(temp_path.c_str());
+		return false;
+	}
+	// rename does not replace an existing file on Windows
+	std::remove(path.c_str());
+	if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+		std::remove(temp_path.c_str());
+		return false;
+	}
+	return true;
+}
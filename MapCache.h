@@ -0,0 +1,45 @@
+#ifndef MAP_CACHE_H_
+#define MAP_CACHE_H_
+
+#include "BuildGrid.h"
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_gametypes.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Map analysis done by on_start. It only depends on the map and our start
+// location, so it is saved to disk and reused in later games.
+struct MapAnalysis {
+	std::vector<sc2::Point3D> expansion_locations;
+	std::vector<std::vector<sc2::Point2D>> ramps;
+	std::vector<sc2::Point2D> depot_points;
+	sc2::Point2D barrack_point;
+	// Build maps before any building is marked on them
+	std::vector<BuildGrid> build_map;
+	std::vector<sc2::Point2D> scout_points;
+};
+
+// What a cache file must match to be used
+struct MapCacheKey {
+	std::string map_name;
+	uint64_t map_hash;  // of the map size, pathing, placement and height grids
+	sc2::Point2D start_location;
+
+	static MapCacheKey FromGame(const sc2::GameInfo& game_info,
+		const sc2::Point2D& start_location);
+};
+
+// File of the key in the cache directory
+std::string MapCachePath(const MapCacheKey& key);
+
+// Reads the analysis with a single mapping of the file. False (and the
+// analysis untouched) if the file is missing, stale or broken.
+bool LoadMapAnalysis(const MapCacheKey& key, MapAnalysis& analysis);
+
+// Writes the analysis to the cache, false if it can't be written
+bool SaveMapAnalysis(const MapCacheKey& key, const MapAnalysis& analysis);
+
+#endif
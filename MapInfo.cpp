@@ -1,4 +1,5 @@
 #include "BasicSc2Bot.h"
+#include "GroupLabeling.h"
 
 // return (A.x - O.x) * (B.y - O.y) - (A.y - O.y) * (B.x - O.x)
 float BasicSc2Bot::cross_product(const Point2D& O, const Point2D& A,
@@ -80,18 +81,6 @@ Point2D BasicSc2Bot::Point2D_mean(const std::vector<Point2D>& points) const {
 	return mean;
 }
 
-// Return mean of map of points
-Point2D BasicSc2Bot::Point2D_mean(
-	const std::map<Point2D, bool, Point2DComparator>& map_points) const {
-	Point2D mean;
-	for (const auto& p : map_points) {
-		mean += p.first;
-	}
-	mean /= map_points.size();
-
-	return mean;
-}
-
 // Find the intersection points of two circles
 std::vector<Point2D> BasicSc2Bot::circle_intersection(const Point2D& p1,
 	const Point2D& p2,
@@ -155,6 +144,18 @@ void BasicSc2Bot::update_build_map(const bool built,
 	// building footprint radius
 	const auto b_bool = built ? false : true;
 
+	// mark the w x h footprint with the lower left cell at corner
+	// buildings off the cell grid never matched a cell of the map
+	auto mark = [&base_build_map, b_bool](const Point2D& corner, int w,
+		int h) {
+			if (corner.x != std::floor(corner.x) ||
+				corner.y != std::floor(corner.y)) {
+				return;
+			}
+			base_build_map.SetArea(static_cast<int>(corner.x),
+				static_cast<int>(corner.y), w, h, b_bool);
+		};
+
 	const ObservationInterface* obs = Observation();
 	Units buildings =
 		destroyed_building
@@ -174,11 +175,7 @@ void BasicSc2Bot::update_build_map(const bool built,
 			// b_radius = 1.0f;
 
 			// I need to check 0,0, 0,-1, -1,0, -1,-1
-			for (int dx = -1; dx <= 0; ++dx) {
-				for (int dy = -1; dy <= 0; ++dy) {
-					base_build_map[building_point + Point2D(dx, dy)] = b_bool;
-				}
-			}
+			mark(building_point - Point2D(1, 1), 2, 2);
 		}
 		// 3x3 + 2x2 (3.5) add_on ->
 		else if (b_type == UNIT_TYPEID::TERRAN_BARRACKS ||
@@ -188,11 +185,7 @@ void BasicSc2Bot::update_build_map(const bool built,
 			// b_radius = 1.5f;
 
 			Point2D center_point = building_point - offset;
-			for (int dx = -1; dx <= 1; ++dx) {
-				for (int dy = -1; dy <= 1; ++dy) {
-					base_build_map[center_point + Point2D(dx, dy)] = b_bool;
-				}
-			}
+			mark(center_point - Point2D(1, 1), 3, 3);
 		}
 		else if (b_type == UNIT_TYPEID::TERRAN_BARRACKSTECHLAB ||
 			b_type == UNIT_TYPEID::TERRAN_BARRACKSREACTOR ||
@@ -205,12 +198,7 @@ void BasicSc2Bot::update_build_map(const bool built,
 			// b_radius = 3.5f;
 
 			// check 6x6
-			for (int dx = -3; dx <= 3; ++dx) {
-				for (int dy = -3; dy <= 3; ++dy) {
-					Point2D grid_point = building_point + Point2D(dx, dy);
-					base_build_map[grid_point] = b_bool;
-				}
-			}
+			mark(building_point - Point2D(3, 3), 7, 7);
 		}
 
 		// 3x3  +2 = 5x3
@@ -222,11 +210,7 @@ void BasicSc2Bot::update_build_map(const bool built,
 			// b_radius = 1.5f;
 
 			Point2D center_point = building_point - offset;
-			for (int dx = -1; dx <= 1; ++dx) {
-				for (int dy = -1; dy <= 1; ++dy) {
-					base_build_map[center_point + Point2D(dx, dy)] = b_bool;
-				}
-			}
+			mark(center_point - Point2D(1, 1), 3, 3);
 		}
 		// 5x5
 		else if (b_type == UNIT_TYPEID::TERRAN_COMMANDCENTER ||
@@ -236,12 +220,7 @@ void BasicSc2Bot::update_build_map(const bool built,
 			// b_radius = 2.5f;
 
 			Point2D center_point = building_point - offset;
-			for (int dx = -2; dx <= 2; ++dx) {
-				for (int dy = -2; dy <= 2; ++dy) {
-					Point2D grid_point = center_point + Point2D(dx, dy);
-					base_build_map[grid_point] = b_bool;
-				}
-			}
+			mark(center_point - Point2D(2, 2), 5, 5);
 		}
 	}
 }
@@ -249,10 +228,9 @@ void BasicSc2Bot::update_build_map(const bool built,
 // With the given point, check if there is a building in the area
 // if addon is true, check 3x3 + 2x2
 bool BasicSc2Bot::area33_check(const Point2D& b, const bool addon) {
-	auto& base_build_map = build_map[0];
+	const BuildGrid& base_build_map = build_map[0];
 	Point2D offset(0.5, 0.5);
 	Point2D b_offset = b - offset;
-	Point2D grid_point;
 	float distance_to_base = Distance2D(b, start_location);
 
 	// in case of the building 3x3, should not be too close or too far
@@ -260,29 +238,20 @@ bool BasicSc2Bot::area33_check(const Point2D& b, const bool addon) {
 		return false;
 	}
 
-	for (int dx = -1; dx <= 1; ++dx) {
-		for (int dy = -1; dy <= 1; ++dy) {
-			grid_point = b_offset + Point2D(dx, dy);
-			if (base_build_map.find(grid_point) != base_build_map.end() &&
-				base_build_map[grid_point]) {
-				continue;
-			}
-			return false;
-		}
+	// only cells on the grid are in the map
+	if (b_offset.x != std::floor(b_offset.x) ||
+		b_offset.y != std::floor(b_offset.y)) {
+		return false;
+	}
+	int x = static_cast<int>(b_offset.x);
+	int y = static_cast<int>(b_offset.y);
+
+	if (!base_build_map.AreaFree(x - 1, y - 1, 3, 3)) {
+		return false;
 	}
 	// if addon is true, check 2x2 more
-	if (addon) {
-		Point2D addon_point = b_offset + Point2D(3, 0);
-		for (int dx = -1; dx <= 0; ++dx) {
-			for (int dy = -1; dy <= 0; ++dy) {
-				grid_point = addon_point + Point2D(dx, dy);
-				if (base_build_map.find(grid_point) != base_build_map.end() &&
-					base_build_map[grid_point]) {
-					continue;
-				}
-				return false;
-			}
-		}
+	if (addon && !base_build_map.AreaFree(x + 2, y - 1, 2, 2)) {
+		return false;
 	}
 	return true;
 }
@@ -314,7 +283,7 @@ bool BasicSc2Bot::build33_after_check(
 						if (EnemyNearby(Point2D(i, k))) {
 							return false;
 						}
-						Actions()->UnitCommand(builder, build_ability,
+						Commands().UnitCommand(builder, build_ability,
 							Point2D(i, k));
 						return true;
 					}
@@ -336,7 +305,7 @@ bool BasicSc2Bot::build33_after_check(
 						if (EnemyNearby(Point2D(i, k))) {
 							return false;
 						}
-						Actions()->UnitCommand(builder, build_ability,
+						Commands().UnitCommand(builder, build_ability,
 							Point2D(i, k));
 						return true;
 					}
@@ -358,7 +327,7 @@ bool BasicSc2Bot::build33_after_check(
 						if (EnemyNearby(Point2D(i, k))) {
 							return false;
 						}
-						Actions()->UnitCommand(builder, build_ability,
+						Commands().UnitCommand(builder, build_ability,
 							Point2D(i, k));
 						return true;
 					}
@@ -380,7 +349,7 @@ bool BasicSc2Bot::build33_after_check(
 						if (EnemyNearby(Point2D(i, k))) {
 							return false;
 						}
-						Actions()->UnitCommand(builder, build_ability,
+						Commands().UnitCommand(builder, build_ability,
 							Point2D(i, k));
 						return true;
 					}
@@ -401,26 +370,28 @@ bool BasicSc2Bot::depot_area_check(const Unit* builder,
 	Point2D right_limit = main_mineral_convexHull.back();
 	float distance_to_left = Distance2D(left_limit, start_location);
 	float distance_to_right = Distance2D(right_limit, start_location);
-	float distance_to_query;
+
+	// candidates in scan order, the game only checks the ones whose 2x2
+	// footprint is on the main base build map and free of our buildings
+	std::vector<Point2D> candidates;
+	auto consider = [&](int i, int j) {
+		float distance_to_query = Distance2D(Point2D(i, j), start_location);
+
+		if (distance_to_query <= distance_to_right ||
+			distance_to_query <= distance_to_left ||
+			!build_map[0].AreaFree(i - 1, j - 1, 2, 2)) {
+			return;
+		}
+		// DrawBoxAtLocation(debug, Point3D(i + 0.5f, j + 0.5f,
+		// height_at(Point2DI(i, j)) + 0.1f), 1.0f, sc2::Colors::Red);
+		candidates.emplace_back(Point2D(i, j));
+		};
 
 	switch (whereismybase) {
 	case BaseLocation::lefttop:
 		for (int j = left_limit.y; j < build_map_minmax[1].y; ++j) {
 			for (int i = build_map_minmax[0].x; i < right_limit.x; ++i) {
-				distance_to_query = Distance2D(Point2D(i, j), start_location);
-
-				if (distance_to_query <= distance_to_right ||
-					distance_to_query <= distance_to_left ||
-					build_map[0].find(Point2D(i, j)) == build_map[0].end()) {
-					continue;
-				}
-				// DrawBoxAtLocation(debug, Point3D(i + 0.5f, j + 0.5f,
-				// height_at(Point2DI(i, j)) + 0.1f), 1.0f, sc2::Colors::Red);
-				if (Query()->Placement(build_ability, Point2D(i, j))) {
-					Actions()->UnitCommand(builder, build_ability,
-						Point2D(i, j), false);
-					return true;
-				}
+				consider(i, j);
 			}
 		}
 		break;
@@ -428,20 +399,7 @@ bool BasicSc2Bot::depot_area_check(const Unit* builder,
 	case BaseLocation::righttop:
 		for (int j = right_limit.y; j < build_map_minmax[1].y; ++j) {
 			for (int i = left_limit.x; i < build_map_minmax[1].x; ++i) {
-				distance_to_query = Distance2D(Point2D(i, j), start_location);
-
-				if (distance_to_query <= distance_to_right ||
-					distance_to_query <= distance_to_left ||
-					build_map[0].find(Point2D(i, j)) == build_map[0].end()) {
-					continue;
-				}
-				// DrawBoxAtLocation(debug, Point3D(i + 0.5f, j + 0.5f,
-				// height_at(Point2DI(i, j)) + 0.1f), 1.0f, sc2::Colors::Red);
-				if (Query()->Placement(build_ability, Point2D(i, j))) {
-					Actions()->UnitCommand(builder, build_ability,
-						Point2D(i, j), false);
-					return true;
-				}
+				consider(i, j);
 			}
 		}
 		break;
@@ -449,46 +407,27 @@ bool BasicSc2Bot::depot_area_check(const Unit* builder,
 	case BaseLocation::leftbottom:
 		for (int j = build_map_minmax[0].y; j < left_limit.y; ++j) {
 			for (int i = build_map_minmax[0].x; i < right_limit.x; ++i) {
-				distance_to_query = Distance2D(Point2D(i, j), start_location);
-
-				if (distance_to_query <= distance_to_right ||
-					distance_to_query <= distance_to_left ||
-					build_map[0].find(Point2D(i, j)) == build_map[0].end()) {
-					continue;
-				}
-				// DrawBoxAtLocation(debug, Point3D(i + 0.5f, j + 0.5f,
-				// height_at(Point2DI(i, j)) + 0.1f), 1.0f, sc2::Colors::Red);
-				if (Query()->Placement(build_ability, Point2D(i, j))) {
-					Actions()->UnitCommand(builder, build_ability,
-						Point2D(i, j), false);
-					return true;
-				}
+				consider(i, j);
 			}
 		}
 		break;
 	case BaseLocation::rightbottom:
 		for (int j = build_map_minmax[0].y; j < right_limit.y; ++j) {
 			for (int i = left_limit.x; i < build_map_minmax[1].x; ++i) {
-				distance_to_query = Distance2D(Point2D(i, j), start_location);
-
-				if (distance_to_query <= distance_to_right ||
-					distance_to_query <= distance_to_left ||
-					build_map[0].find(Point2D(i, j)) == build_map[0].end()) {
-					continue;
-				}
-				// DrawBoxAtLocation(debug, Point3D(i + 0.5f, j + 0.5f,
-				// height_at(Point2DI(i, j)) + 0.1f), 1.0f, sc2::Colors::Red);
-				if (Query()->Placement(build_ability, Point2D(i, j))) {
-					Actions()->UnitCommand(builder, build_ability,
-						Point2D(i, j), false);
-					return true;
-				}
+				consider(i, j);
 			}
 		}
 		break;
 	}
 
-	return false;
+	// one batched placement query instead of one per candidate
+	int index = placement_planner.FirstPlaceable(Query(), current_gameloop,
+		build_ability, candidates);
+	if (index < 0) {
+		return false;
+	}
+	Commands().UnitCommand(builder, build_ability, candidates[index], false);
+	return true;
 }
 
 // check if the given point is in the depot area
@@ -611,16 +550,21 @@ BasicSc2Bot::find_terret_location_btw(std::vector<Point2D>& mineral_patches,
 	return turret_locations;
 }
 
-// return highet at the given point
-int BasicSc2Bot::height_at(const Point2DI& p) const {
-	HeightMap h_map(Observation()->GetGameInfo());
-	return static_cast<int>(h_map.TerrainHeight(p));
-}
-
-// return highet at the given point
-float BasicSc2Bot::height_at_float(const Point2DI& p) const {
-	HeightMap h_map(Observation()->GetGameInfo());
-	return h_map.TerrainHeight(p);
+// decode the terrain height of every cell once
+// HeightMap copies the whole image, so it must not be built per lookup
+void BasicSc2Bot::decode_terrain_height() {
+	const GameInfo& game_info = Observation()->GetGameInfo();
+	HeightMap h_map(game_info);
+	terrain_width = game_info.width;
+	terrain_rows = game_info.height;
+	terrain_height.resize(static_cast<size_t>(game_info.width) *
+		game_info.height);
+	for (int y = 0; y < game_info.height; ++y) {
+		for (int x = 0; x < game_info.width; ++x) {
+			terrain_height[y * terrain_width + x] =
+				h_map.TerrainHeight(Point2DI(x, y));
+		}
+	}
 }
 
 // find groups of points
@@ -630,76 +574,28 @@ void BasicSc2Bot::find_groups(std::vector<Point2D>& points,
 	int minimum_points_per_group,
 	int max_distance_between_points) {
 	const ObservationInterface* obs = Observation();
-	const int NOT_INTERESTED = -2;
-	const int NOT_COLORED_YET = -1;
-	int currentColor = NOT_COLORED_YET;
 	const float step = minimum_points_per_group == -1 ? 0.5f : 1.0f;
-	const unsigned int height =
-		static_cast<unsigned int>(obs->GetGameInfo().height / step);
-	const unsigned int width =
-		static_cast<unsigned int>(obs->GetGameInfo().width / step);
-	std::vector<std::vector<int>> picture(
-		height, std::vector<int>(width, NOT_INTERESTED));
-
-	auto paint = [&picture, &currentColor, step](const Point2D& pt) {
-		int x = static_cast<int>(pt.x / step);
-		int y = static_cast<int>(pt.y / step);
-		picture[y][x] = currentColor;
-		if (step == 0.5f) {
-			picture[y + 1][x] = currentColor;
-			picture[y][x + 1] = currentColor;
-			picture[y + 1][x + 1] = currentColor;
-		}
-		};
 
+	// neighbors within max_distance_between_points steps (manhattan)
+	// points are whole cells, so only offsets landing on a cell count
 	std::vector<Point2DI> nearby;
 	for (int dx = -max_distance_between_points;
 		dx <= max_distance_between_points; ++dx) {
 		for (int dy = -max_distance_between_points;
 			dy <= max_distance_between_points; ++dy) {
-			if (abs(dx) + abs(dy) <= max_distance_between_points) {
-				nearby.emplace_back(Point2DI(dx, dy));
+			float ox = dx * step;
+			float oy = dy * step;
+			if (abs(dx) + abs(dy) <= max_distance_between_points &&
+				ox == std::floor(ox) && oy == std::floor(oy)) {
+				nearby.emplace_back(Point2DI(static_cast<int>(ox),
+					static_cast<int>(oy)));
 			}
 		}
 	}
-	for (const auto& point : points) {
-		paint(point);
-	}
-
-	std::vector<Point2D> remaining(points.begin(), points.end());
-	std::deque<Point2D> queue;
 
 	// flood fill
-	while (!remaining.empty()) {
-		std::vector<Point2D> currentGroup;
-		if (queue.empty()) {
-			++currentColor;
-			auto start = remaining.back();
-			remaining.pop_back();
-			paint(start);
-			queue.emplace_back(start);
-			currentGroup.emplace_back(start);
-		}
-		while (!queue.empty()) {
-			Point2D base = queue.front();
-			queue.pop_front();
-			for (const auto& offset : nearby) {
-				float px = base.x + offset.x * step;
-				float py = base.y + offset.y * step;
-				if (px < 0 || py < 0 || px >= width * step ||
-					py >= height * step) {
-					continue;
-				}
-				Point2D point(px, py);
-				auto it = std::find(remaining.begin(), remaining.end(), point);
-				if (it != remaining.end()) {
-					remaining.erase(it);
-					paint(point);
-					queue.emplace_back(point);
-					currentGroup.emplace_back(point);
-				}
-			}
-		}
+	for (auto& currentGroup : LabelGroups(points, obs->GetGameInfo().width,
+		obs->GetGameInfo().height, nearby)) {
 		if (minimum_points_per_group != -1) {
 			if (currentGroup.size() >= minimum_points_per_group) {
 				std::sort(currentGroup.begin(), currentGroup.end(),
@@ -711,12 +607,13 @@ void BasicSc2Bot::find_groups(std::vector<Point2D>& points,
 			}
 		}
 		else {
-			std::map<Point2D, bool, Point2DComparator> groups;
 			if (currentGroup.size() != 1) {
+				BuildGrid groups(static_cast<int>(obs->GetGameInfo().width),
+					static_cast<int>(obs->GetGameInfo().height));
 				for (const auto& point : currentGroup) {
-					groups.insert({ point, true });
+					groups.Set(point, true);
 				}
-				build_map.emplace_back(groups);
+				build_map.emplace_back(std::move(groups));
 			}
 		}
 	}
@@ -724,38 +621,43 @@ void BasicSc2Bot::find_groups(std::vector<Point2D>& points,
 	if (minimum_points_per_group == -1) {
 		std::sort(
 			build_map.begin(), build_map.end(),
-			[this](const std::map<Point2D, bool, Point2DComparator>& map1,
-				const std::map<Point2D, bool, Point2DComparator>& map2) {
-					return Distance2D(Point2D_mean(map1), start_location) <
-						Distance2D(Point2D_mean(map2), start_location);
+			[this](const BuildGrid& map1, const BuildGrid& map2) {
+				return Distance2D(map1.Mean(), start_location) <
+					Distance2D(map2.Mean(), start_location);
 			});
 
-		Point2D build_max;
-		Point2D build_min;
-
-		float minY = std::numeric_limits<float>::max();
-		float maxY = std::numeric_limits<float>::lowest();
-
-		// Iterate through the build_map to find min and max y values
-		for (const auto& p : build_map[0]) {
-			if (p.first.y < minY) {
-				minY = p.first.y;
-			}
-			if (p.first.y > maxY) {
-				maxY = p.first.y;
-			}
-		}
-		build_min.x = build_map[0].begin()->first.x;  // x min
-		build_max.x = build_map[0].rbegin()->first.x; // x max
-		// Now minY and maxY hold the minimum and maximum y values respectively
-		build_min.y = minY;
-		build_max.y = maxY;
-
-		build_map_minmax = { build_min, build_max };
+		// smallest and largest x and y of the main base build map
+		build_map_minmax = { build_map[0].Min(), build_map[0].Max() };
 	}
 	return;
 }
 
+// the map analysis of on_start, for the map cache
+// build_map must not have any building marked on it yet
+MapAnalysis BasicSc2Bot::map_analysis() const {
+	MapAnalysis analysis;
+	analysis.expansion_locations = expansion_locations;
+	analysis.ramps = ramps;
+	analysis.depot_points = mainBase_depot_points;
+	analysis.barrack_point = mainBase_barrack_point;
+	analysis.build_map = build_map;
+	analysis.scout_points = scout_points;
+	return analysis;
+}
+
+// restore the map analysis of on_start from the map cache
+void BasicSc2Bot::apply_map_analysis(MapAnalysis& analysis) {
+	expansion_locations = std::move(analysis.expansion_locations);
+	ramps = std::move(analysis.ramps);
+	mainBase_depot_points = std::move(analysis.depot_points);
+	mainBase_barrack_point = analysis.barrack_point;
+	build_map = std::move(analysis.build_map);
+	scout_points = std::move(analysis.scout_points);
+
+	// smallest and largest x and y of the main base build map
+	build_map_minmax = { build_map[0].Min(), build_map[0].Max() };
+}
+
 // find the ramps or the buildable map
 void BasicSc2Bot::find_ramps_build_map(bool isRamp) {
 	const ObservationInterface* obs = Observation();
@@ -934,6 +836,7 @@ void BasicSc2Bot::find_right_ramp(const Point2D& location) {
 // Raise depots when enemies are nearby
 // Lower depots when no enemies are nearby
 void BasicSc2Bot::depot_control() {
+	PROFILE_SCOPE("depot_control");
 	const ObservationInterface* obs = Observation();
 
 	// checking the ramp depots
@@ -969,14 +872,14 @@ void BasicSc2Bot::depot_control() {
 	// Raise depots when enemies are nearby
 	for (const auto& depo : depots) {
 		if (!EnemyNearby(depo->pos, false)) {
-			Actions()->UnitCommand(depo, ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER);
+			Commands().UnitCommand(depo, ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER);
 		}
 	}
 
 	// Lower depots when no enemies are nearby
 	for (const auto& depo : lowered_depots) {
 		if (EnemyNearby(depo->pos, false, 10)) {
-			Actions()->UnitCommand(depo, ABILITY_ID::MORPH_SUPPLYDEPOT_RAISE);
+			Commands().UnitCommand(depo, ABILITY_ID::MORPH_SUPPLYDEPOT_RAISE);
 		}
 	}
 }
@@ -1,15 +1,15 @@
 #include "BasicSc2Bot.h"
 
 void BasicSc2Bot::Offense() {
+	PROFILE_SCOPE("Offense");
 	const ObservationInterface* observation = Observation();
-	Units marines = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_MARINE));
-	Units siege_tanks = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SIEGETANK));
-	Units battlecruisers = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BATTLECRUISER));
-	Units starports = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_STARPORT));
+	const UnitSnapshot& units = Snapshot();
+	const Units& marines =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_MARINE);
+	const Units& siege_tanks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SIEGETANK);
+	const Units& starports =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_STARPORT);
 
 	// Check if we should start attacking
 	if (!is_attacking) {
@@ -88,16 +88,12 @@ void BasicSc2Bot::Offense() {
 		if (AllRetreating()) {
 			is_attacking = false;
 			for (const auto& marine : marines) {
-				if (unit_attacking[marine]) {
-					unit_attacking[marine] = false;
-				}
-				Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE, rally_barrack);
+				unit_attacking.Erase(marine->tag);
+				Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE, rally_barrack);
 			}
 			for (const auto& tank : siege_tanks) {
-				if (unit_attacking[tank]) {
-					unit_attacking[tank] = false;
-				}
-				Actions()->UnitCommand(tank, ABILITY_ID::MOVE_MOVE, rally_factory);
+				unit_attacking.Erase(tank->tag);
+				Commands().UnitCommand(tank, ABILITY_ID::MOVE_MOVE, rally_factory);
 			}
 		}
 		else {
@@ -115,19 +111,19 @@ void BasicSc2Bot::Offense() {
 
 void BasicSc2Bot::AllOutRush() {
 
-	if (current_gameloop % 23 != 0) {
+	if (!scheduler.Due(rush_slot, current_gameloop)) {
 		return;
 	}
 
-	const ObservationInterface* obs = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Get all our combat units
-	Units marines =
-		obs->GetUnits(Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_MARINE));
-	Units siege_tanks = obs->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_SIEGETANK));
-	Units battlecruisers = obs->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BATTLECRUISER));
+	const Units& marines =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_MARINE);
+	const Units& siege_tanks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SIEGETANK);
+	const Units& battlecruisers =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BATTLECRUISER);
 
 	// Check if we have any units to attack with
 	if (marines.empty() && siege_tanks.empty()) {
@@ -157,7 +153,7 @@ void BasicSc2Bot::AllOutRush() {
 	// Check for enemy units or structures near the attack target, including
 	// snapshots
 	Units enemy_units =
-		obs->GetUnits(Unit::Alliance::Enemy, [this](const Unit& unit) {
+		units.Select(Unit::Alliance::Enemy, [this](const Unit& unit) {
 		return (unit.display_type == Unit::DisplayType::Visible ||
 			unit.display_type == Unit::DisplayType::Snapshot) &&
 			unit.is_alive && Distance2D(unit.pos, attack_target) < 25.0f;
@@ -170,7 +166,7 @@ void BasicSc2Bot::AllOutRush() {
 		float min_distance = std::numeric_limits<float>::max();
 
 		// Search for any visible unit left on the map
-		for (const auto& enemy_unit : obs->GetUnits(Unit::Alliance::Enemy)) {
+		for (const auto& enemy_unit : units.All(Unit::Alliance::Enemy)) {
 			if (enemy_unit->display_type == Unit::DisplayType::Visible &&
 				enemy_unit->is_alive) {
 				float distance = Distance2D(enemy_unit->pos, start_location);
@@ -189,7 +185,7 @@ void BasicSc2Bot::AllOutRush() {
 		else {
 			// Search for the closest snapshot unit
 			for (const auto& enemy_unit :
-				obs->GetUnits(Unit::Alliance::Enemy)) {
+				units.All(Unit::Alliance::Enemy)) {
 				if (enemy_unit->display_type == Unit::DisplayType::Snapshot &&
 					enemy_unit->is_alive) {
 					float distance =
@@ -215,8 +211,8 @@ void BasicSc2Bot::AllOutRush() {
 	// Move units to the target location
 	for (const auto& marine : marine_near_rally) {
 		if (marine->orders.empty() && Distance2D(marine->pos, attack_target) > 5.0f) {
-			unit_attacking[marine] = true;
-			Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE, attack_target);
+			unit_attacking.Set(marine->tag, true);
+			Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE, attack_target);
 		}
 	}
 
@@ -234,8 +230,8 @@ void BasicSc2Bot::AllOutRush() {
 		// Command the attacking tanks
 		for (const auto& tank : attacking_tanks) {
 			if (tank->orders.empty() && Distance2D(tank->pos, attack_target) > 5.0f) {
-				unit_attacking[tank] = true;
-				Actions()->UnitCommand(tank, ABILITY_ID::MOVE_MOVE, attack_target);
+				unit_attacking.Set(tank->tag, true);
+				Commands().UnitCommand(tank, ABILITY_ID::MOVE_MOVE, attack_target);
 			}
 		}
 	}
@@ -244,7 +240,7 @@ void BasicSc2Bot::AllOutRush() {
 		for (const auto& battlecruiser : battlecruisers) {
 			if (battlecruiser->orders.empty() &&
 				Distance2D(battlecruiser->pos, attack_target) > 5.0f) {
-				Actions()->UnitCommand(battlecruiser, ABILITY_ID::MOVE_MOVE,
+				Commands().UnitCommand(battlecruiser, ABILITY_ID::MOVE_MOVE,
 					attack_target);
 			}
 		}
@@ -257,13 +253,11 @@ void BasicSc2Bot::AllOutRush() {
 
 // Fanout to find the hidden enemy base
 void BasicSc2Bot::CleanUp() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
 	// Get all our combat units
-	Units marines = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_MARINE));
-	Units siege_tanks = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SIEGETANK));
+	const Units& marines =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_MARINE);
 
 	Point2D attack_target = enemy_start_location;
 	// sort scout locations by distance to the start location
@@ -282,7 +276,7 @@ void BasicSc2Bot::CleanUp() {
 	// Check for enemy units or structures near the attack target, including
 	// snapshots
 	for (const auto& enemy_unit :
-		observation->GetUnits(Unit::Alliance::Enemy)) {
+		units.All(Unit::Alliance::Enemy)) {
 		if ((enemy_unit->display_type == Unit::DisplayType::Visible ||
 			enemy_unit->display_type == Unit::DisplayType::Snapshot) &&
 			enemy_unit->is_alive &&
@@ -296,7 +290,7 @@ void BasicSc2Bot::CleanUp() {
 	for (const auto& marine : marines) {
 		if (marine->orders.empty() &&
 			Distance2D(marine->pos, attack_target) > 5.0f) {
-			Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
+			Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
 				attack_target);
 
 			if (marine->orders.empty() ||
@@ -309,12 +303,12 @@ void BasicSc2Bot::CleanUp() {
 
 //Determine if we have enough army to attack
 bool BasicSc2Bot::EnoughArmy() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
-	Units marines = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_MARINE));
-	Units siege_tanks = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SIEGETANK));
+	const Units& marines =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_MARINE);
+	const Units& siege_tanks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SIEGETANK);
 
 	if (marines.empty() && siege_tanks.empty()) {
 		return false;
@@ -349,12 +343,12 @@ bool BasicSc2Bot::EnoughArmy() {
 
 // Issue move command continously to all attacking units
 void BasicSc2Bot::ContinuousMove() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
-	Units marines = observation->GetUnits(Unit::Alliance::Self,
-		IsUnit(UNIT_TYPEID::TERRAN_MARINE));
-	Units siege_tanks = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_SIEGETANK));
+	const Units& marines =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_MARINE);
+	const Units& siege_tanks =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_SIEGETANK);
 
 	if (marines.empty() && siege_tanks.empty()) {
 		return;
@@ -363,16 +357,16 @@ void BasicSc2Bot::ContinuousMove() {
 	// Move units to the target location
 	if (!marines.empty()) {
 		for (const auto& marine : marines) {
-			if (unit_attacking[marine] && marine->orders.empty()) {
-				Actions()->UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
+			if (unit_attacking.Get(marine->tag) && marine->orders.empty()) {
+				Commands().UnitCommand(marine, ABILITY_ID::MOVE_MOVE,
 					attack_target);
 			}
 		}
 	}
 	if (!siege_tanks.empty()) {
 		for (const auto& tank : siege_tanks) {
-			if (unit_attacking[tank] && tank->orders.empty()) {
-				Actions()->UnitCommand(tank, ABILITY_ID::MOVE_MOVE,
+			if (unit_attacking.Get(tank->tag) && tank->orders.empty()) {
+				Commands().UnitCommand(tank, ABILITY_ID::MOVE_MOVE,
 					attack_target);
 			}
 		}
@@ -381,10 +375,10 @@ void BasicSc2Bot::ContinuousMove() {
 
 // Determine whether attacking units need to retreat
 bool BasicSc2Bot::AllRetreating() {
-	const ObservationInterface* observation = Observation();
+	const UnitSnapshot& units = Snapshot();
 
-	Units battlecruisers = observation->GetUnits(
-		Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BATTLECRUISER));
+	const Units& battlecruisers =
+		units.OfType(Unit::Alliance::Self, UNIT_TYPEID::TERRAN_BATTLECRUISER);
 
 	bool retreat = true;
 
@@ -400,7 +394,7 @@ bool BasicSc2Bot::AllRetreating() {
 
 	// Check if Battlecruisers are retreating
 	for (const auto& battlecruiser : battlecruisers) {
-		if (!battlecruiser_retreating[battlecruiser] ||
+		if (!battlecruiser_retreating.Get(battlecruiser->tag) ||
 			battlecruiser->health > 150.0f) {
 			retreat = false;
 		}
@@ -0,0 +1,89 @@
+#include "PlacementPlanner.h"
+
+#include <cstring>
+
+using namespace sc2;
+
+const size_t PlacementPlanner::batch_size;
+
+size_t PlacementPlanner::KeyHash::operator()(const Key& key) const {
+	uint32_t x;
+	uint32_t y;
+	std::memcpy(&x, &key.x, sizeof(x));
+	std::memcpy(&y, &key.y, sizeof(y));
+	size_t hash = key.ability;
+	hash = hash * 31 + x;
+	hash = hash * 31 + y;
+	hash = hash * 31 + static_cast<size_t>(key.builder);
+	return hash;
+}
+
+PlacementPlanner::Key PlacementPlanner::MakeKey(AbilityID ability,
+	const Point2D& target, const Unit* builder) {
+	return { static_cast<uint32_t>(ability), target.x, target.y,
+		builder ? builder->tag : NullTag };
+}
+
+void PlacementPlanner::StartLoop(uint32_t game_loop) {
+	if (game_loop != cache_loop) {
+		cache.clear();
+		cache_loop = game_loop;
+	}
+}
+
+bool PlacementPlanner::CanPlace(QueryInterface* query, uint32_t game_loop,
+	AbilityID ability, const Point2D& target, const Unit* builder) {
+	StartLoop(game_loop);
+	Key key = MakeKey(ability, target, builder);
+	auto it = cache.find(key);
+	if (it != cache.end()) {
+		return it->second;
+	}
+	++round_trips;
+	bool result = query->Placement(ability, target, builder);
+	cache.emplace(key, result);
+	return result;
+}
+
+int PlacementPlanner::FirstPlaceable(QueryInterface* query,
+	uint32_t game_loop, AbilityID ability,
+	const std::vector<Point2D>& candidates, const Unit* builder) {
+	StartLoop(game_loop);
+	std::vector<QueryInterface::PlacementQuery> batch;
+	std::vector<Key> batch_keys;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		auto it = cache.find(MakeKey(ability, candidates[i], builder));
+		if (it != cache.end()) {
+			if (it->second) {
+				return static_cast<int>(i);
+			}
+			continue;
+		}
+
+		// Ask for this candidate and the next unknown ones in one go
+		batch.clear();
+		batch_keys.clear();
+		for (size_t j = i; j < candidates.size() && batch.size() < batch_size;
+			++j) {
+			Key key = MakeKey(ability, candidates[j], builder);
+			if (cache.count(key)) {
+				continue;
+			}
+			QueryInterface::PlacementQuery placement(ability, candidates[j]);
+			if (builder) {
+				placement.placing_unit_tag = builder->tag;
+			}
+			batch.push_back(placement);
+			batch_keys.push_back(key);
+		}
+		++round_trips;
+		std::vector<bool> results = query->Placement(batch);
+		for (size_t k = 0; k < batch_keys.size(); ++k) {
+			cache[batch_keys[k]] = k < results.size() && results[k];
+		}
+		if (cache[MakeKey(ability, candidates[i], builder)]) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,64 @@
+#ifndef PLACEMENT_PLANNER_H_
+#define PLACEMENT_PLANNER_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_interfaces.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Placement queries to the game, batched and cached for the current game loop.
+//
+// Callers filter candidates against the local build map first; the planner
+// then checks what is left with as few server round trips as it can.
+class PlacementPlanner {
+public:
+	// Query()->Placement for one point, cached for the game loop
+	bool CanPlace(sc2::QueryInterface* query, uint32_t game_loop,
+		sc2::AbilityID ability, const sc2::Point2D& target,
+		const sc2::Unit* builder = nullptr);
+
+	// Index of the first candidate (in order) that can be placed, -1 if none.
+	// Unknown candidates are checked in batches of up to batch_size per
+	// round trip, stopping at the first batch with a hit.
+	int FirstPlaceable(sc2::QueryInterface* query, uint32_t game_loop,
+		sc2::AbilityID ability, const std::vector<sc2::Point2D>& candidates,
+		const sc2::Unit* builder = nullptr);
+
+	// Server round trips made so far
+	size_t RoundTrips() const { return round_trips; }
+
+	static const size_t batch_size = 32;
+
+private:
+	struct Key {
+		uint32_t ability;
+		float x;
+		float y;
+		sc2::Tag builder;
+
+		bool operator==(const Key& other) const {
+			return ability == other.ability && x == other.x && y == other.y &&
+				builder == other.builder;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const;
+	};
+
+	static Key MakeKey(sc2::AbilityID ability, const sc2::Point2D& target,
+		const sc2::Unit* builder);
+
+	// Drops the answers of an older game loop
+	void StartLoop(uint32_t game_loop);
+
+	std::unordered_map<Key, bool, KeyHash> cache;
+	uint32_t cache_loop = 0;
+	size_t round_trips = 0;
+};
+
+#endif
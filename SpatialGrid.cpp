@@ -0,0 +1,131 @@
+#include "SpatialGrid.h"
+
+using namespace sc2;
+
+SpatialGrid::SpatialGrid(float cell_size)
+	: cell_size(cell_size), inv_cell_size(1.0f / cell_size),
+	origin(0.0f, 0.0f), width(0), height(0), built_loop(0), built(false) {}
+
+void SpatialGrid::Build(const sc2::Units& source, uint32_t game_loop) {
+	built_loop = game_loop;
+	built = true;
+
+	units.assign(source.begin(), source.end());
+	entries.clear();
+	cell_start.clear();
+	cell_of.clear();
+	width = 0;
+	height = 0;
+	if (units.empty()) {
+		return;
+	}
+
+	// Bounds of the units, the grid only covers those
+	Point2D min_p(std::numeric_limits<float>::max(),
+		std::numeric_limits<float>::max());
+	Point2D max_p(std::numeric_limits<float>::lowest(),
+		std::numeric_limits<float>::lowest());
+	for (const auto& unit : units) {
+		min_p.x = std::min(min_p.x, unit->pos.x);
+		min_p.y = std::min(min_p.y, unit->pos.y);
+		max_p.x = std::max(max_p.x, unit->pos.x);
+		max_p.y = std::max(max_p.y, unit->pos.y);
+	}
+	origin = min_p;
+	width = static_cast<int>((max_p.x - min_p.x) * inv_cell_size) + 1;
+	height = static_cast<int>((max_p.y - min_p.y) * inv_cell_size) + 1;
+
+	// Counting sort by cell, stable so each cell keeps the list order
+	cell_start.assign(static_cast<size_t>(width) * height + 1, 0);
+	cell_of.resize(units.size());
+	for (size_t i = 0; i < units.size(); ++i) {
+		int cx, cy;
+		CellOf(units[i]->pos, cx, cy);
+		cell_of[i] = static_cast<uint32_t>(cy * width + cx);
+		++cell_start[cell_of[i] + 1];
+	}
+	for (size_t c = 1; c < cell_start.size(); ++c) {
+		cell_start[c] += cell_start[c - 1];
+	}
+	entries.resize(units.size());
+	std::vector<uint32_t> fill(cell_start.begin(), cell_start.end() - 1);
+	for (size_t i = 0; i < units.size(); ++i) {
+		Entry& e = entries[fill[cell_of[i]]++];
+		e.pos = units[i]->pos;
+		e.unit = units[i];
+		e.index = static_cast<uint32_t>(i);
+	}
+}
+
+std::vector<uint32_t> SpatialGrid::NeighborCounts(float radius) const {
+	std::vector<uint32_t> counts(units.size(), 0);
+	if (units.empty()) {
+		return counts;
+	}
+	// Cells (slightly) larger than the radius, so only the 3x3 block around a
+	// unit can hold its neighbors
+	SpatialGrid fine(radius * 1.001f);
+	fine.Build(units, built_loop);
+	for (size_t c = 0; c + 1 < fine.cell_start.size(); ++c) {
+		int cx = static_cast<int>(c % fine.width);
+		int cy = static_cast<int>(c / fine.width);
+		int x0 = std::max(cx - 1, 0);
+		int x1 = std::min(cx + 1, fine.width - 1);
+		int y0 = std::max(cy - 1, 0);
+		int y1 = std::min(cy + 1, fine.height - 1);
+		for (uint32_t i = fine.cell_start[c]; i < fine.cell_start[c + 1]; ++i) {
+			const Entry& a = fine.entries[i];
+			uint32_t count = 0;
+			for (int y = y0; y <= y1; ++y) {
+				for (int x = x0; x <= x1; ++x) {
+					size_t n = static_cast<size_t>(y) * fine.width + x;
+					for (uint32_t j = fine.cell_start[n];
+						j < fine.cell_start[n + 1]; ++j) {
+						const Entry& b = fine.entries[j];
+						if (b.unit != a.unit &&
+							Distance2D(a.pos, b.pos) < radius) {
+							++count;
+						}
+					}
+				}
+			}
+			counts[a.index] = count;
+		}
+	}
+	return counts;
+}
+
+void SpatialGrid::CellOf(const Point2D& pos, int& cx, int& cy) const {
+	cx = static_cast<int>(std::floor((pos.x - origin.x) * inv_cell_size));
+	cy = static_cast<int>(std::floor((pos.y - origin.y) * inv_cell_size));
+	cx = std::min(std::max(cx, 0), width - 1);
+	cy = std::min(std::max(cy, 0), height - 1);
+}
+
+void SpatialGrid::CellRange(const Point2D& pos, float radius, int& x0,
+	int& y0, int& x1, int& y1) const {
+	CellOf(Point2D(pos.x - radius, pos.y - radius), x0, y0);
+	CellOf(Point2D(pos.x + radius, pos.y + radius), x1, y1);
+}
+
+float SpatialGrid::RingLowerBound(const Point2D& pos, int cx, int cy,
+	int ring) const {
+	float bound = std::numeric_limits<float>::max();
+	// Cells left, right, below and above the ring (if there are any)
+	if (cx - ring - 1 >= 0) {
+		bound = std::min(bound, pos.x - (origin.x + (cx - ring) * cell_size));
+	}
+	if (cx + ring + 1 < width) {
+		bound = std::min(bound,
+			origin.x + (cx + ring + 1) * cell_size - pos.x);
+	}
+	if (cy - ring - 1 >= 0) {
+		bound = std::min(bound, pos.y - (origin.y + (cy - ring) * cell_size));
+	}
+	if (cy + ring + 1 < height) {
+		bound = std::min(bound,
+			origin.y + (cy + ring + 1) * cell_size - pos.y);
+	}
+	// Keep a small margin for float rounding of Distance2D
+	return bound - 1e-3f;
+}
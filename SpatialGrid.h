@@ -0,0 +1,265 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_unit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Uniform grid (bucketed spatial hash) over a set of units, rebuilt once per
+// game loop. Cells are stored contiguously (counting sort by cell), so a
+// radius query only touches the cells overlapping the query circle.
+//
+// Every unit keeps its index in the list it was built from. Nearest queries
+// break distance ties by that index, so they return the same unit as a linear
+// scan over the list that keeps the first strictly closer unit.
+class SpatialGrid {
+public:
+	explicit SpatialGrid(float cell_size = 8.0f);
+
+	// Rebuilds the grid from the units (in their given order)
+	void Build(const sc2::Units& units, uint32_t game_loop);
+
+	// True if the grid was built for the given game loop
+	bool IsBuiltFor(uint32_t game_loop) const {
+		return built && game_loop == built_loop;
+	}
+
+	// Units the grid was built from, in their original order
+	const sc2::Units& AllUnits() const { return units; }
+
+	size_t Size() const { return units.size(); }
+
+	float CellSize() const { return cell_size; }
+
+	// For every unit, the number of other units strictly closer than radius.
+	// Indexed like AllUnits().
+	std::vector<uint32_t> NeighborCounts(float radius) const;
+
+	// Calls f(unit, distance) for every unit within `radius` (inclusive) of
+	// pos. Units are visited cell by cell, not in list order.
+	template <typename F>
+	void ForEachInRadius(const sc2::Point2D& pos, float radius, F f) const {
+		if (units.empty()) {
+			return;
+		}
+		int x0, y0, x1, y1;
+		CellRange(pos, radius, x0, y0, x1, y1);
+		for (int cy = y0; cy <= y1; ++cy) {
+			for (int cx = x0; cx <= x1; ++cx) {
+				size_t c = static_cast<size_t>(cy) * width + cx;
+				for (uint32_t i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+					const Entry& e = entries[i];
+					float distance = sc2::Distance2D(pos, e.pos);
+					if (distance <= radius) {
+						f(e.unit, distance);
+					}
+				}
+			}
+		}
+	}
+
+	// True if a unit passing pred is closer than `radius` (or within it if
+	// inclusive is set)
+	template <typename Predicate>
+	bool AnyInRadius(const sc2::Point2D& pos, float radius, Predicate pred,
+		bool inclusive = false) const {
+		if (units.empty()) {
+			return false;
+		}
+		int x0, y0, x1, y1;
+		CellRange(pos, radius, x0, y0, x1, y1);
+		for (int cy = y0; cy <= y1; ++cy) {
+			for (int cx = x0; cx <= x1; ++cx) {
+				size_t c = static_cast<size_t>(cy) * width + cx;
+				for (uint32_t i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+					const Entry& e = entries[i];
+					float distance = sc2::Distance2D(pos, e.pos);
+					if ((distance < radius || (inclusive && distance == radius)) &&
+						pred(e.unit)) {
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+	// Units passing pred within `radius` (inclusive), in list order
+	template <typename Predicate>
+	sc2::Units InRadius(const sc2::Point2D& pos, float radius,
+		Predicate pred) const {
+		std::vector<uint32_t> found;
+		int x0, y0, x1, y1;
+		if (!units.empty()) {
+			CellRange(pos, radius, x0, y0, x1, y1);
+			for (int cy = y0; cy <= y1; ++cy) {
+				for (int cx = x0; cx <= x1; ++cx) {
+					size_t c = static_cast<size_t>(cy) * width + cx;
+					for (uint32_t i = cell_start[c]; i < cell_start[c + 1];
+						++i) {
+						const Entry& e = entries[i];
+						if (sc2::Distance2D(pos, e.pos) <= radius &&
+							pred(e.unit)) {
+							found.push_back(e.index);
+						}
+					}
+				}
+			}
+		}
+		std::sort(found.begin(), found.end());
+		sc2::Units result;
+		result.reserve(found.size());
+		for (uint32_t index : found) {
+			result.push_back(units[index]);
+		}
+		return result;
+	}
+
+	// Closest unit passing pred that is strictly closer than max_distance.
+	// Ties are broken by list order. Returns nullptr if there is none.
+	template <typename Predicate>
+	const sc2::Unit* Nearest(const sc2::Point2D& pos, Predicate pred,
+		float max_distance = std::numeric_limits<float>::max()) const {
+		const sc2::Unit* best = nullptr;
+		float best_distance = max_distance;
+		uint32_t best_index = std::numeric_limits<uint32_t>::max();
+		if (units.empty()) {
+			return nullptr;
+		}
+		int cx, cy;
+		CellOf(pos, cx, cy);
+		int max_ring = std::max(std::max(cx, width - 1 - cx),
+			std::max(cy, height - 1 - cy));
+		for (int ring = 0; ring <= max_ring; ++ring) {
+			ForEachCellInRing(cx, cy, ring, [&](size_t c) {
+				for (uint32_t i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+					const Entry& e = entries[i];
+					float distance = sc2::Distance2D(pos, e.pos);
+					if ((distance < best_distance ||
+						(best && distance == best_distance &&
+							e.index < best_index)) &&
+						pred(e.unit)) {
+						best = e.unit;
+						best_distance = distance;
+						best_index = e.index;
+					}
+				}
+				});
+			// Nothing outside this ring can be closer (or tie) any more
+			if (RingLowerBound(pos, cx, cy, ring) > best_distance) {
+				break;
+			}
+		}
+		return best;
+	}
+
+	// Up to k closest units passing pred, ordered by distance then list order
+	template <typename Predicate>
+	sc2::Units KNearest(const sc2::Point2D& pos, size_t k, Predicate pred,
+		float max_distance = std::numeric_limits<float>::max()) const {
+		struct Hit {
+			float distance;
+			uint32_t index;
+		};
+		std::vector<Hit> hits;
+		sc2::Units result;
+		if (units.empty() || k == 0) {
+			return result;
+		}
+		auto worse = [](const Hit& a, const Hit& b) {
+			return a.distance < b.distance ||
+				(a.distance == b.distance && a.index < b.index);
+		};
+		int cx, cy;
+		CellOf(pos, cx, cy);
+		int max_ring = std::max(std::max(cx, width - 1 - cx),
+			std::max(cy, height - 1 - cy));
+		for (int ring = 0; ring <= max_ring; ++ring) {
+			ForEachCellInRing(cx, cy, ring, [&](size_t c) {
+				for (uint32_t i = cell_start[c]; i < cell_start[c + 1]; ++i) {
+					const Entry& e = entries[i];
+					float distance = sc2::Distance2D(pos, e.pos);
+					if (distance >= max_distance || !pred(e.unit)) {
+						continue;
+					}
+					Hit hit{ distance, e.index };
+					if (hits.size() < k) {
+						hits.push_back(hit);
+						std::push_heap(hits.begin(), hits.end(), worse);
+					}
+					else if (worse(hit, hits.front())) {
+						std::pop_heap(hits.begin(), hits.end(), worse);
+						hits.back() = hit;
+						std::push_heap(hits.begin(), hits.end(), worse);
+					}
+				}
+				});
+			if (hits.size() == k &&
+				RingLowerBound(pos, cx, cy, ring) > hits.front().distance) {
+				break;
+			}
+		}
+		std::sort_heap(hits.begin(), hits.end(), worse);
+		result.reserve(hits.size());
+		for (const auto& hit : hits) {
+			result.push_back(units[hit.index]);
+		}
+		return result;
+	}
+
+private:
+	struct Entry {
+		sc2::Point2D pos;
+		const sc2::Unit* unit;
+		uint32_t index;
+	};
+
+	void CellOf(const sc2::Point2D& pos, int& cx, int& cy) const;
+
+	void CellRange(const sc2::Point2D& pos, float radius, int& x0, int& y0,
+		int& x1, int& y1) const;
+
+	// Distance from pos to the closest cell outside the given ring
+	float RingLowerBound(const sc2::Point2D& pos, int cx, int cy,
+		int ring) const;
+
+	template <typename F>
+	void ForEachCellInRing(int cx, int cy, int ring, F f) const {
+		int x0 = cx - ring;
+		int x1 = cx + ring;
+		int y0 = cy - ring;
+		int y1 = cy + ring;
+		for (int y = std::max(y0, 0); y <= std::min(y1, height - 1); ++y) {
+			bool edge_row = (y == y0 || y == y1);
+			for (int x = std::max(x0, 0); x <= std::min(x1, width - 1); ++x) {
+				if (!edge_row && x != x0 && x != x1) {
+					// Jump over the inside of the ring
+					x = std::min(x1, width) - 1;
+					continue;
+				}
+				f(static_cast<size_t>(y) * width + x);
+			}
+		}
+	}
+
+	float cell_size;
+	float inv_cell_size;
+	sc2::Point2D origin;
+	int width;
+	int height;
+
+	sc2::Units units;
+	std::vector<Entry> entries;
+	std::vector<uint32_t> cell_start;
+	std::vector<uint32_t> cell_of;
+
+	uint32_t built_loop;
+	bool built;
+};
+
+#endif
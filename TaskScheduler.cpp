@@ -0,0 +1,181 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <utility>
+
+namespace {
+// Longest frame plan kept; periods whose common multiple is longer are
+// planned over this many frames only
+const uint32_t max_horizon = 1 << 16;
+
+uint32_t Gcd(uint32_t a, uint32_t b) {
+	while (b) {
+		uint32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+uint32_t Lcm(uint32_t a, uint32_t b) {
+	uint64_t lcm = static_cast<uint64_t>(a) / Gcd(a, b) * b;
+	return static_cast<uint32_t>(std::min<uint64_t>(lcm, max_horizon));
+}
+
+// First game loop at or after this one that falls on the phase
+uint32_t Aligned(uint32_t game_loop, uint32_t period, uint32_t phase) {
+	return game_loop + (phase + period - game_loop % period) % period;
+}
+}
+
+void TaskScheduler::Clear() {
+	tasks.clear();
+	load.clear();
+	in_place_time = 0.0;
+	frames = 0;
+	frames_over_budget = 0;
+}
+
+TaskScheduler::TaskId TaskScheduler::Add(const char* name, uint32_t period,
+	double cost_microseconds, std::function<void()> run) {
+	period = std::max<uint32_t>(period, 1);
+	Task task;
+	task.name = name;
+	task.period = period;
+	task.phase = PickPhase(period);
+	task.cost = cost_microseconds;
+	task.run = std::move(run);
+	tasks.push_back(std::move(task));
+	PlanLoad();
+	return tasks.size() - 1;
+}
+
+TaskScheduler::TaskId TaskScheduler::AddSlot(const char* name,
+	uint32_t period, double cost_microseconds) {
+	return Add(name, period, cost_microseconds, nullptr);
+}
+
+TaskScheduler::TaskId TaskScheduler::AddInPlace(const char* name,
+	uint32_t period, double cost_microseconds, std::function<void()> run) {
+	TaskId task = Add(name, period, cost_microseconds, std::move(run));
+	tasks[task].in_place = true;
+	return task;
+}
+
+uint32_t TaskScheduler::PickPhase(uint32_t period) const {
+	uint32_t horizon = load.empty()
+		? period : Lcm(static_cast<uint32_t>(load.size()), period);
+	uint32_t best_phase = 0;
+	double best_peak = 0.0;
+	double best_total = 0.0;
+	for (uint32_t phase = 0; phase < period; ++phase) {
+		double peak = 0.0;
+		double total = 0.0;
+		for (uint32_t frame = phase; frame < horizon; frame += period) {
+			double planned = load.empty() ? 0.0 : load[frame % load.size()];
+			peak = std::max(peak, planned);
+			total += planned;
+		}
+		// Lightest busiest frame first, then the least shared frames
+		if (phase == 0 || peak < best_peak ||
+			(peak == best_peak && total < best_total)) {
+			best_phase = phase;
+			best_peak = peak;
+			best_total = total;
+		}
+	}
+	return best_phase;
+}
+
+void TaskScheduler::PlanLoad() {
+	uint32_t horizon = 1;
+	for (const auto& task : tasks) {
+		horizon = Lcm(horizon, task.period);
+	}
+	load.assign(horizon, 0.0);
+	for (const auto& task : tasks) {
+		for (uint32_t frame = task.phase; frame < horizon;
+			frame += task.period) {
+			load[frame] += task.cost;
+		}
+	}
+}
+
+double TaskScheduler::RunTask(Task& task, uint32_t game_loop) {
+	if (!task.started) {
+		task.next_due = Aligned(game_loop, task.period, task.phase);
+		task.started = true;
+	}
+	if (game_loop < task.next_due) {
+		return 0.0;
+	}
+	task.next_due = Aligned(game_loop + 1, task.period, task.phase);
+
+	auto start = std::chrono::steady_clock::now();
+	task.run();
+	std::chrono::duration<double, std::micro> elapsed =
+		std::chrono::steady_clock::now() - start;
+
+	double time = elapsed.count();
+	task.runs++;
+	task.total += time;
+	task.max = std::max(task.max, time);
+	if (time > task.cost) {
+		task.overruns++;
+		task.overrun_total += time - task.cost;
+	}
+	return time;
+}
+
+void TaskScheduler::Run(uint32_t game_loop) {
+	double frame_time = in_place_time;
+	in_place_time = 0.0;
+	for (auto& task : tasks) {
+		if (task.run && !task.in_place) {
+			frame_time += RunTask(task, game_loop);
+		}
+	}
+	frames++;
+	if (frame_time > frame_budget) {
+		frames_over_budget++;
+	}
+}
+
+void TaskScheduler::RunIfDue(TaskId task, uint32_t game_loop) {
+	in_place_time += RunTask(tasks[task], game_loop);
+}
+
+bool TaskScheduler::Due(TaskId task, uint32_t game_loop) const {
+	return game_loop % tasks[task].period == tasks[task].phase;
+}
+
+double TaskScheduler::PeakLoad() const {
+	return load.empty() ? 0.0 : *std::max_element(load.begin(), load.end());
+}
+
+void TaskScheduler::Report(std::ostream& out) const {
+	char line[160];
+	std::snprintf(line, sizeof(line),
+		"%-28s %6s %6s %8s %10s %10s %10s %10s %10s", "task (us)", "period",
+		"phase", "runs", "estimate", "mean", "max", "overruns", "over by");
+	out << line << std::endl;
+	for (const auto& task : tasks) {
+		std::snprintf(line, sizeof(line),
+			"%-28s %6u %6u %8llu %10.1f %10.1f %10.1f %10llu %10.1f",
+			task.name.c_str(), task.period, task.phase,
+			static_cast<unsigned long long>(task.runs), task.cost,
+			task.runs ? task.total / static_cast<double>(task.runs) : 0.0,
+			task.max, static_cast<unsigned long long>(task.overruns),
+			task.overruns
+				? task.overrun_total / static_cast<double>(task.overruns)
+				: 0.0);
+		out << line << std::endl;
+	}
+	std::snprintf(line, sizeof(line),
+		"%llu of %llu frames over the %.0f us budget, planned peak %.0f us",
+		static_cast<unsigned long long>(frames_over_budget),
+		static_cast<unsigned long long>(frames), frame_budget, PeakLoad());
+	out << line << std::endl;
+}
@@ -0,0 +1,100 @@
+#ifndef TASK_SCHEDULER_H_
+#define TASK_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Periodic work, spread over game loops so that tasks with different periods
+// don't all land on the same frame.
+//
+// Every task has a period and a cost estimate. When it is added it gets the
+// phase (game loop offset within its period) that keeps the busiest frame
+// as light as possible, so no frame goes over the frame budget if that can
+// be avoided. Run() then runs the tasks that are due this game loop and
+// times them against their estimate.
+//
+// Slots are tasks without work of their own, for throttles buried inside
+// larger decisions: they are staggered like tasks and callers check Due().
+// In-place tasks are tasks whose commands must come at a fixed point of the
+// step: Run() leaves them out and the caller runs them with RunIfDue().
+class TaskScheduler {
+public:
+	typedef size_t TaskId;
+
+	// Planned cost per frame to stay under, in microseconds
+	void SetFrameBudget(double microseconds) { frame_budget = microseconds; }
+
+	// Removes all tasks and statistics
+	void Clear();
+
+	TaskId Add(const char* name, uint32_t period, double cost_microseconds,
+		std::function<void()> run);
+
+	TaskId AddSlot(const char* name, uint32_t period, double cost_microseconds);
+
+	TaskId AddInPlace(const char* name, uint32_t period,
+		double cost_microseconds, std::function<void()> run);
+
+	// Runs the tasks due at this game loop. A task whose game loop was
+	// skipped runs at the next call. Call it once per step, after the
+	// in-place tasks.
+	void Run(uint32_t game_loop);
+
+	// Runs the in-place task if it is due, like Run() does
+	void RunIfDue(TaskId task, uint32_t game_loop);
+
+	// Whether the task or slot falls on this game loop
+	bool Due(TaskId task, uint32_t game_loop) const;
+
+	// Planned cost of the busiest frame
+	double PeakLoad() const;
+
+	// Runs, mean time and overruns of every task, and frames over budget
+	void Report(std::ostream& out) const;
+
+private:
+	struct Task {
+		std::string name;
+		uint32_t period;
+		uint32_t phase;
+		double cost;
+		std::function<void()> run;
+		bool in_place = false;
+
+		// 0 until the first Run() after the task was added
+		uint32_t next_due = 0;
+		bool started = false;
+
+		uint64_t runs = 0;
+		double total = 0.0;
+		double max = 0.0;
+
+		// Runs that took longer than the cost estimate, and by how much
+		uint64_t overruns = 0;
+		double overrun_total = 0.0;
+	};
+
+	// Phase with the lightest busiest frame for a new task
+	uint32_t PickPhase(uint32_t period) const;
+
+	// Planned cost of every frame over the common period of all tasks
+	void PlanLoad();
+
+	// Runs the task if it is due and returns the time it took
+	double RunTask(Task& task, uint32_t game_loop);
+
+	std::vector<Task> tasks;
+	std::vector<double> load;
+	double frame_budget = 2000.0;
+	// Time of the in-place tasks since the last Run()
+	double in_place_time = 0.0;
+
+	uint64_t frames = 0;
+	uint64_t frames_over_budget = 0;
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef TYPE_TABLES_H_
+#define TYPE_TABLES_H_
+
+#include "sc2api/sc2_typeenums.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+// Membership sets and per-id values over unit type and ability ids, laid out
+// by the compiler. A lookup is one load and a mask; ids past the end of a
+// table are never members. Listing an id past the end fails to compile.
+
+// Unit type ids are below this
+constexpr size_t max_unit_type_id = 2048;
+// Ability ids are below this
+constexpr size_t max_ability_id = 4096;
+
+template <typename Id, size_t N>
+class IdSet {
+public:
+	constexpr IdSet(std::initializer_list<Id> ids) : words{} {
+		for (Id id : ids) {
+			uint32_t index = static_cast<uint32_t>(id);
+			words[index / 64] |= uint64_t(1) << (index % 64);
+		}
+	}
+
+	constexpr bool Has(Id id) const {
+		uint32_t index = static_cast<uint32_t>(id);
+		// Wrapped into range and masked by the range check, so no branch
+		return (index < N) &
+			static_cast<bool>((words[(index / 64) % (N / 64)] >> (index % 64)) & 1);
+	}
+
+private:
+	uint64_t words[N / 64];
+};
+
+template <typename Id, size_t N, typename T>
+class IdTable {
+public:
+	struct Entry {
+		Id id;
+		T value;
+	};
+
+	// Ids not listed get T()
+	constexpr IdTable(std::initializer_list<Entry> entries) : values{} {
+		for (const Entry& entry : entries) {
+			values[static_cast<uint32_t>(entry.id)] = entry.value;
+		}
+	}
+
+	constexpr T operator[](Id id) const {
+		uint32_t index = static_cast<uint32_t>(id);
+		T value = values[index % N];
+		return index < N ? value : T();
+	}
+
+private:
+	T values[N];
+};
+
+typedef IdSet<sc2::UNIT_TYPEID, max_unit_type_id> UnitTypeSet;
+typedef IdSet<sc2::ABILITY_ID, max_ability_id> AbilitySet;
+
+// Turret types
+constexpr UnitTypeSet turret_types = {
+	sc2::UNIT_TYPEID::TERRAN_MISSILETURRET,
+	sc2::UNIT_TYPEID::ZERG_SPORECRAWLER,
+	sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON };
+
+// Worker types
+constexpr UnitTypeSet worker_types = {
+	sc2::UNIT_TYPEID::TERRAN_SCV, sc2::UNIT_TYPEID::TERRAN_MULE,
+	sc2::UNIT_TYPEID::PROTOSS_PROBE, sc2::UNIT_TYPEID::ZERG_DRONE };
+
+// Units not worth attacking
+constexpr UnitTypeSet trivial_types = {
+	sc2::UNIT_TYPEID::ZERG_OVERLORD, sc2::UNIT_TYPEID::ZERG_OVERSEER,
+	sc2::UNIT_TYPEID::ZERG_OVERSEERSIEGEMODE, sc2::UNIT_TYPEID::ZERG_CHANGELING,
+	sc2::UNIT_TYPEID::ZERG_CHANGELINGMARINE,
+	sc2::UNIT_TYPEID::ZERG_CHANGELINGMARINESHIELD,
+	sc2::UNIT_TYPEID::PROTOSS_OBSERVER,
+	sc2::UNIT_TYPEID::PROTOSS_OBSERVERSIEGEMODE };
+
+// Resource units
+constexpr UnitTypeSet resource_types = {
+	sc2::UNIT_TYPEID::ZERG_OVERLORD, sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT,
+	sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED,
+	sc2::UNIT_TYPEID::PROTOSS_PYLON };
+
+// Heavy armored units
+constexpr UnitTypeSet heavy_armor_types = {
+	sc2::UNIT_TYPEID::TERRAN_MARAUDER,
+	sc2::UNIT_TYPEID::TERRAN_CYCLONE,
+	sc2::UNIT_TYPEID::TERRAN_SIEGETANK,
+	sc2::UNIT_TYPEID::TERRAN_THOR,
+	sc2::UNIT_TYPEID::TERRAN_BUNKER,
+	sc2::UNIT_TYPEID::PROTOSS_STALKER,
+	sc2::UNIT_TYPEID::PROTOSS_IMMORTAL,
+	sc2::UNIT_TYPEID::PROTOSS_DISRUPTOR,
+	sc2::UNIT_TYPEID::PROTOSS_COLOSSUS,
+	sc2::UNIT_TYPEID::ZERG_ROACH,
+	sc2::UNIT_TYPEID::ZERG_ROACHBURROWED,
+	sc2::UNIT_TYPEID::ZERG_RAVAGER,
+	sc2::UNIT_TYPEID::ZERG_SWARMHOSTMP,
+	sc2::UNIT_TYPEID::ZERG_SWARMHOSTBURROWEDMP,
+	sc2::UNIT_TYPEID::ZERG_LURKERMP,
+	sc2::UNIT_TYPEID::ZERG_LURKERDENMP,
+	sc2::UNIT_TYPEID::ZERG_ULTRALISK,
+	sc2::UNIT_TYPEID::ZERG_ULTRALISKBURROWED };
+
+// Meele units
+constexpr UnitTypeSet melee_types = {
+	sc2::UNIT_TYPEID::ZERG_DRONE,          sc2::UNIT_TYPEID::PROTOSS_PROBE,
+	sc2::UNIT_TYPEID::TERRAN_SCV,          sc2::UNIT_TYPEID::ZERG_ZERGLING,
+	sc2::UNIT_TYPEID::ZERG_BANELING,       sc2::UNIT_TYPEID::ZERG_ULTRALISK,
+	sc2::UNIT_TYPEID::TERRAN_HELLIONTANK,  sc2::UNIT_TYPEID::PROTOSS_ZEALOT,
+	sc2::UNIT_TYPEID::PROTOSS_DARKTEMPLAR, sc2::UNIT_TYPEID::ZERG_BROODLING };
+
+// Unit types that are always in the air
+constexpr UnitTypeSet air_types = {
+	sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER,
+	sc2::UNIT_TYPEID::TERRAN_MEDIVAC,
+	sc2::UNIT_TYPEID::TERRAN_LIBERATOR,
+	sc2::UNIT_TYPEID::TERRAN_LIBERATORAG,
+	sc2::UNIT_TYPEID::TERRAN_RAVEN,
+	sc2::UNIT_TYPEID::TERRAN_BANSHEE,
+	sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER,
+	sc2::UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING,
+	sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING,
+	sc2::UNIT_TYPEID::TERRAN_BARRACKSFLYING,
+	sc2::UNIT_TYPEID::TERRAN_FACTORYFLYING,
+	sc2::UNIT_TYPEID::TERRAN_STARPORTFLYING,
+	sc2::UNIT_TYPEID::PROTOSS_OBSERVER,
+	sc2::UNIT_TYPEID::PROTOSS_OBSERVERSIEGEMODE,
+	sc2::UNIT_TYPEID::PROTOSS_WARPPRISM,
+	sc2::UNIT_TYPEID::PROTOSS_PHOENIX,
+	sc2::UNIT_TYPEID::PROTOSS_VOIDRAY,
+	sc2::UNIT_TYPEID::PROTOSS_ORACLE,
+	sc2::UNIT_TYPEID::PROTOSS_CARRIER,
+	sc2::UNIT_TYPEID::PROTOSS_INTERCEPTOR,
+	sc2::UNIT_TYPEID::PROTOSS_TEMPEST,
+	sc2::UNIT_TYPEID::PROTOSS_MOTHERSHIP,
+	sc2::UNIT_TYPEID::ZERG_OVERLORD,
+	sc2::UNIT_TYPEID::ZERG_OVERLORDTRANSPORT,
+	sc2::UNIT_TYPEID::ZERG_OVERSEER,
+	sc2::UNIT_TYPEID::ZERG_OVERSEERSIEGEMODE,
+	sc2::UNIT_TYPEID::ZERG_MUTALISK,
+	sc2::UNIT_TYPEID::ZERG_CORRUPTOR,
+	sc2::UNIT_TYPEID::ZERG_BROODLORD,
+	sc2::UNIT_TYPEID::ZERG_VIPER };
+
+// Our structures that go on the build map
+constexpr UnitTypeSet friendly_structure_types = {
+	sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT,
+	sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED,
+	sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER,
+	sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND,
+	sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS,
+	sc2::UNIT_TYPEID::TERRAN_BARRACKS,
+	sc2::UNIT_TYPEID::TERRAN_FACTORY,
+	sc2::UNIT_TYPEID::TERRAN_STARPORT,
+	sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY,
+	sc2::UNIT_TYPEID::TERRAN_ARMORY,
+	sc2::UNIT_TYPEID::TERRAN_FUSIONCORE,
+	sc2::UNIT_TYPEID::TERRAN_MISSILETURRET,
+	sc2::UNIT_TYPEID::TERRAN_BUNKER,
+	sc2::UNIT_TYPEID::TERRAN_TECHLAB,
+	sc2::UNIT_TYPEID::TERRAN_REACTOR,
+	sc2::UNIT_TYPEID::TERRAN_FACTORYTECHLAB,
+	sc2::UNIT_TYPEID::TERRAN_STARPORTTECHLAB,
+	sc2::UNIT_TYPEID::TERRAN_BARRACKSTECHLAB };
+
+// Abilities SCVs build structures with
+constexpr AbilitySet build_abilities = {
+	sc2::ABILITY_ID::BUILD_ARMORY,
+	sc2::ABILITY_ID::BUILD_BARRACKS,
+	sc2::ABILITY_ID::BUILD_BUNKER,
+	sc2::ABILITY_ID::BUILD_COMMANDCENTER,
+	sc2::ABILITY_ID::BUILD_ENGINEERINGBAY,
+	sc2::ABILITY_ID::BUILD_FACTORY,
+	sc2::ABILITY_ID::BUILD_FUSIONCORE,
+	sc2::ABILITY_ID::BUILD_GHOSTACADEMY,
+	sc2::ABILITY_ID::BUILD_MISSILETURRET,
+	sc2::ABILITY_ID::BUILD_REFINERY,
+	sc2::ABILITY_ID::BUILD_STARPORT,
+	sc2::ABILITY_ID::BUILD_SUPPLYDEPOT };
+
+// Threat levels of anti-air units, 0 for units that can't shoot up
+constexpr IdTable<sc2::UNIT_TYPEID, max_unit_type_id, uint8_t> threat_levels = {
+	{sc2::UNIT_TYPEID::TERRAN_MARINE, 1},
+	{sc2::UNIT_TYPEID::TERRAN_GHOST, 1},
+	{sc2::UNIT_TYPEID::TERRAN_CYCLONE, 2},
+	{sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER, 2},
+	{sc2::UNIT_TYPEID::TERRAN_VIKINGASSAULT, 2},
+	{sc2::UNIT_TYPEID::TERRAN_THOR, 5},
+	{sc2::UNIT_TYPEID::TERRAN_MISSILETURRET, 3},
+	{sc2::UNIT_TYPEID::PROTOSS_STALKER, 3},
+	{sc2::UNIT_TYPEID::PROTOSS_SENTRY, 1},
+	{sc2::UNIT_TYPEID::PROTOSS_ARCHON, 3},
+	{sc2::UNIT_TYPEID::PROTOSS_PHOENIX, 2},
+	{sc2::UNIT_TYPEID::PROTOSS_VOIDRAY, 5},
+	{sc2::UNIT_TYPEID::PROTOSS_CARRIER, 3},
+	{sc2::UNIT_TYPEID::PROTOSS_TEMPEST, 2},
+	{sc2::UNIT_TYPEID::PROTOSS_PHOTONCANNON, 3},
+	{sc2::UNIT_TYPEID::ZERG_QUEEN, 2},
+	{sc2::UNIT_TYPEID::ZERG_HYDRALISK, 2},
+	{sc2::UNIT_TYPEID::ZERG_RAVAGER, 3},
+	{sc2::UNIT_TYPEID::ZERG_MUTALISK, 2},
+	{sc2::UNIT_TYPEID::ZERG_CORRUPTOR, 4},
+	{sc2::UNIT_TYPEID::ZERG_SPORECRAWLER, 3} };
+
+// Footprint radius of our buildings, 0 for other types
+constexpr IdTable<sc2::UNIT_TYPEID, max_unit_type_id, float> footprint_radius = {
+	{sc2::UNIT_TYPEID::TERRAN_COMMANDCENTER, 2.5f},
+	{sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOT, 1.0f},
+	{sc2::UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED, 1.0f},
+	{sc2::UNIT_TYPEID::TERRAN_REFINERY, 1.0f},
+	{sc2::UNIT_TYPEID::TERRAN_BARRACKS, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_ENGINEERINGBAY, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_MISSILETURRET, 1.0f},
+	{sc2::UNIT_TYPEID::TERRAN_BUNKER, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_SENSORTOWER, 0.5f},
+	{sc2::UNIT_TYPEID::TERRAN_GHOSTACADEMY, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_FACTORY, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_STARPORT, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_ARMORY, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_FUSIONCORE, 1.5f},
+	{sc2::UNIT_TYPEID::TERRAN_TECHLAB, 3.5f},
+	{sc2::UNIT_TYPEID::TERRAN_REACTOR, 3.5f},
+	{sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND, 2.5f},
+	{sc2::UNIT_TYPEID::TERRAN_PLANETARYFORTRESS, 2.5f},
+	{sc2::UNIT_TYPEID::TERRAN_AUTOTURRET, 0.5f},
+	// SCV is not a building but included for completeness
+	{sc2::UNIT_TYPEID::TERRAN_SCV, 0.375f} };
+
+#endif
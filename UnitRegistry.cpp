@@ -0,0 +1,235 @@
+#include "UnitRegistry.h"
+
+#include "sc2api/sc2_typeenums.h"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+using namespace sc2;
+
+namespace {
+const Units empty_units;
+
+int StateIndex(uint8_t state) {
+	return state == UnitRegistry::InProgress ? 0
+		: state == UnitRegistry::Complete ? 1 : 2;
+}
+}
+
+uint8_t UnitRegistry::StateOf(const Unit& unit) {
+	if (unit.is_flying) {
+		return Flying;
+	}
+	return unit.build_progress < 1.0f ? InProgress : Complete;
+}
+
+bool UnitRegistry::CanMorph(UNIT_TYPEID unit_type) {
+	switch (unit_type) {
+	case UNIT_TYPEID::TERRAN_COMMANDCENTER:
+	case UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING:
+	case UNIT_TYPEID::TERRAN_ORBITALCOMMAND:
+	case UNIT_TYPEID::TERRAN_ORBITALCOMMANDFLYING:
+	case UNIT_TYPEID::TERRAN_SUPPLYDEPOT:
+	case UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED:
+	case UNIT_TYPEID::TERRAN_BARRACKS:
+	case UNIT_TYPEID::TERRAN_BARRACKSFLYING:
+	case UNIT_TYPEID::TERRAN_FACTORY:
+	case UNIT_TYPEID::TERRAN_FACTORYFLYING:
+	case UNIT_TYPEID::TERRAN_STARPORT:
+	case UNIT_TYPEID::TERRAN_STARPORTFLYING:
+	case UNIT_TYPEID::TERRAN_SIEGETANK:
+	case UNIT_TYPEID::TERRAN_SIEGETANKSIEGED:
+	case UNIT_TYPEID::TERRAN_VIKINGFIGHTER:
+	case UNIT_TYPEID::TERRAN_VIKINGASSAULT:
+	case UNIT_TYPEID::TERRAN_HELLION:
+	case UNIT_TYPEID::TERRAN_HELLIONTANK:
+	case UNIT_TYPEID::TERRAN_WIDOWMINE:
+	case UNIT_TYPEID::TERRAN_WIDOWMINEBURROWED:
+	case UNIT_TYPEID::TERRAN_LIBERATOR:
+	case UNIT_TYPEID::TERRAN_LIBERATORAG:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void UnitRegistry::Reset(const Units& units) {
+	entries.clear();
+	by_type.clear();
+	counts.clear();
+	watched.clear();
+	for (const auto& unit : units) {
+		Add(unit);
+	}
+}
+
+void UnitRegistry::OnCreated(const Unit* unit) {
+	if (unit->alliance == Unit::Alliance::Self) {
+		Add(unit);
+	}
+}
+
+void UnitRegistry::OnCompleted(const Unit* unit) {
+	auto it = entries.find(unit->tag);
+	if (it == entries.end()) {
+		OnCreated(unit);
+		return;
+	}
+	Entry& entry = it->second;
+	uint8_t state = StateOf(*unit);
+	if (entry.state != state || entry.unit_type != unit->unit_type) {
+		Erase(entry);
+		entry.unit_type = unit->unit_type;
+		entry.state = state;
+		Insert(entry);
+	}
+}
+
+void UnitRegistry::OnDestroyed(const Unit* unit) {
+	Remove(unit->tag);
+}
+
+void UnitRegistry::Reconcile() {
+	for (size_t i = 0; i < watched.size();) {
+		auto it = entries.find(watched[i]);
+		if (it == entries.end()) {
+			watched[i] = watched.back();
+			watched.pop_back();
+			continue;
+		}
+		Entry& entry = it->second;
+		const Unit* unit = entry.unit;
+		uint8_t state = StateOf(*unit);
+		if (entry.state != state || entry.unit_type != unit->unit_type) {
+			Erase(entry);
+			entry.unit_type = unit->unit_type;
+			entry.state = state;
+			Insert(entry);
+		}
+		// Buildings stay watched until finished, morphing types for good
+		if (entry.state != InProgress && !CanMorph(entry.unit_type)) {
+			watched[i] = watched.back();
+			watched.pop_back();
+			continue;
+		}
+		++i;
+	}
+}
+
+size_t UnitRegistry::Count(UNIT_TYPEID unit_type, uint8_t states) const {
+	auto it = counts.find(static_cast<uint32_t>(unit_type));
+	if (it == counts.end()) {
+		return 0;
+	}
+	size_t count = 0;
+	if (states & InProgress) {
+		count += it->second[0];
+	}
+	if (states & Complete) {
+		count += it->second[1];
+	}
+	if (states & Flying) {
+		count += it->second[2];
+	}
+	return count;
+}
+
+const Units& UnitRegistry::Get(UNIT_TYPEID unit_type) const {
+	auto it = by_type.find(static_cast<uint32_t>(unit_type));
+	return it == by_type.end() ? empty_units : it->second;
+}
+
+Units UnitRegistry::Get(UNIT_TYPEID unit_type, uint8_t states) const {
+	Units units;
+	for (const auto& unit : Get(unit_type)) {
+		if (entries.at(unit->tag).state & states) {
+			units.push_back(unit);
+		}
+	}
+	return units;
+}
+
+size_t UnitRegistry::CheckConsistency(const Units& observed,
+	uint32_t game_loop) const {
+	size_t mismatches = 0;
+	std::unordered_set<Tag> seen;
+	for (const auto& unit : observed) {
+		// Placeholders of planned buildings are not units yet
+		if (unit->display_type == Unit::DisplayType::Placeholder) {
+			continue;
+		}
+		seen.insert(unit->tag);
+		auto it = entries.find(unit->tag);
+		if (it == entries.end()) {
+			std::cout << "UnitRegistry: missing " << UnitTypeToName(unit->unit_type)
+				<< " " << unit->tag << std::endl;
+			++mismatches;
+			continue;
+		}
+		const Entry& entry = it->second;
+		if (entry.unit_type != unit->unit_type || entry.state != StateOf(*unit)) {
+			std::cout << "UnitRegistry: stale " << UnitTypeToName(entry.unit_type)
+				<< " " << unit->tag << ", now " << UnitTypeToName(unit->unit_type)
+				<< std::endl;
+			++mismatches;
+		}
+	}
+	// Units out of sight for a while (SCVs inside a refinery) are still ours,
+	// dead units and units gone for longer are leaked entries
+	const uint32_t out_of_sight_loops = 448;
+	for (const auto& it : entries) {
+		const Unit* unit = it.second.unit;
+		if (seen.count(it.first) || (unit->is_alive &&
+			unit->last_seen_game_loop + out_of_sight_loops >= game_loop)) {
+			continue;
+		}
+		std::cout << "UnitRegistry: extra " << UnitTypeToName(it.second.unit_type)
+			<< " " << it.first << std::endl;
+		++mismatches;
+	}
+	for (const auto& it : by_type) {
+		if (it.second.size() != Count(static_cast<UNIT_TYPEID>(it.first))) {
+			std::cout << "UnitRegistry: bad count for "
+				<< UnitTypeToName(static_cast<UNIT_TYPEID>(it.first)) << std::endl;
+			++mismatches;
+		}
+	}
+	return mismatches;
+}
+
+void UnitRegistry::Add(const Unit* unit) {
+	if (unit->display_type == Unit::DisplayType::Placeholder ||
+		entries.count(unit->tag)) {
+		return;
+	}
+	Entry entry = { unit, unit->unit_type, StateOf(*unit) };
+	entries.emplace(unit->tag, entry);
+	Insert(entry);
+	if (entry.state == InProgress || CanMorph(entry.unit_type)) {
+		watched.push_back(unit->tag);
+	}
+}
+
+void UnitRegistry::Remove(Tag tag) {
+	auto it = entries.find(tag);
+	if (it == entries.end()) {
+		return;
+	}
+	Erase(it->second);
+	entries.erase(it);
+}
+
+void UnitRegistry::Insert(const Entry& entry) {
+	uint32_t type = static_cast<uint32_t>(entry.unit_type);
+	by_type[type].push_back(entry.unit);
+	counts[type][StateIndex(entry.state)]++;
+}
+
+void UnitRegistry::Erase(const Entry& entry) {
+	uint32_t type = static_cast<uint32_t>(entry.unit_type);
+	// Keep registration order, buckets are small
+	Units& units = by_type[type];
+	units.erase(std::remove(units.begin(), units.end(), entry.unit), units.end());
+	counts[type][StateIndex(entry.state)]--;
+}
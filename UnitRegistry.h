@@ -0,0 +1,80 @@
+#ifndef UNIT_REGISTRY_H_
+#define UNIT_REGISTRY_H_
+
+#include "sc2api/sc2_unit.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Our own units by type and state, maintained from the unit event callbacks
+// (OnUnitCreated, OnBuildingConstructionComplete, OnUnitDestroyed) instead of
+// rescanning the observation.
+//
+// Morphs (Orbital Command, lowered depots, sieged tanks, lifted buildings) do
+// not raise an event, so Reconcile() re-reads the type and state of the few
+// units that can change either.
+class UnitRegistry {
+public:
+	enum State : uint8_t {
+		InProgress = 1 << 0, // build_progress < 1
+		Complete = 1 << 1,   // build_progress == 1 and on the ground
+		Flying = 1 << 2,     // is_flying
+		AnyState = InProgress | Complete | Flying,
+	};
+
+	// Starts over from the given units (the first frame has no events)
+	void Reset(const sc2::Units& units);
+
+	void OnCreated(const sc2::Unit* unit);
+	void OnCompleted(const sc2::Unit* unit);
+	void OnDestroyed(const sc2::Unit* unit);
+
+	// Picks up type and state changes of units that morph or lift
+	void Reconcile();
+
+	// Number of units of the type in any of the given states
+	size_t Count(sc2::UNIT_TYPEID unit_type, uint8_t states = AnyState) const;
+
+	// Units of the type (any state), in the order they were registered
+	const sc2::Units& Get(sc2::UNIT_TYPEID unit_type) const;
+
+	// Units of the type in any of the given states
+	sc2::Units Get(sc2::UNIT_TYPEID unit_type, uint8_t states) const;
+
+	size_t Size() const { return entries.size(); }
+
+	// Compares the registry against the units seen this game loop and prints
+	// every difference: units missing from the registry, stale types and
+	// states, and entries for units that died or haven't been seen for 20
+	// seconds. Returns the number of differences.
+	size_t CheckConsistency(const sc2::Units& observed,
+		uint32_t game_loop) const;
+
+	static uint8_t StateOf(const sc2::Unit& unit);
+
+private:
+	struct Entry {
+		const sc2::Unit* unit;
+		sc2::UNIT_TYPEID unit_type;
+		uint8_t state;
+	};
+
+	void Add(const sc2::Unit* unit);
+	void Remove(sc2::Tag tag);
+	void Insert(const Entry& entry);
+	void Erase(const Entry& entry);
+
+	// True for types whose units can change type or state without an event
+	static bool CanMorph(sc2::UNIT_TYPEID unit_type);
+
+	std::unordered_map<sc2::Tag, Entry> entries;
+	std::unordered_map<uint32_t, sc2::Units> by_type;
+	// Counts per type for InProgress, Complete and Flying
+	std::unordered_map<uint32_t, std::array<uint32_t, 3>> counts;
+	// Tags checked by Reconcile()
+	std::vector<sc2::Tag> watched;
+};
+
+#endif
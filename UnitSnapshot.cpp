@@ -0,0 +1,148 @@
+#include "UnitSnapshot.h"
+
+#include "sc2api/sc2_unit_filters.h"
+
+#include <algorithm>
+
+using namespace sc2;
+
+namespace {
+const Units empty_units;
+}
+
+UnitSnapshot::UnitSnapshot() : game_loop(0), built(false) {}
+
+uint8_t UnitSnapshot::FlagsOf(const Unit& unit) {
+	uint8_t flags = 0;
+	if (unit.build_progress == 1.0f) {
+		flags |= Completed;
+	}
+	if (unit.is_flying) {
+		flags |= Flying;
+	}
+	if (unit.orders.empty()) {
+		flags |= Idle;
+	}
+	if (unit.add_on_tag != 0) {
+		flags |= HasAddon;
+	}
+	return flags;
+}
+
+void UnitSnapshot::Update(const ObservationInterface* obs) {
+	uint32_t loop = obs->GetGameLoop();
+	if (built && loop == game_loop) {
+		return;
+	}
+	game_loop = loop;
+	built = true;
+
+	// Keep the buckets (and their capacity) around, only clear the contents
+	for (auto& index : alliances) {
+		index.all.clear();
+		index.town_halls.clear();
+		for (auto& bucket : index.by_type) {
+			bucket.second.units.clear();
+			bucket.second.flags.clear();
+		}
+	}
+
+	// Single scan of every unit in the observation
+	for (const auto& unit : obs->GetUnits()) {
+		size_t a = static_cast<size_t>(unit->alliance);
+		if (a >= 5) {
+			continue;
+		}
+		AllianceIndex& index = alliances[a];
+		index.all.push_back(unit);
+		if (IsTownHall()(*unit)) {
+			index.town_halls.push_back(unit);
+		}
+		Bucket& bucket =
+			index.by_type[static_cast<uint32_t>(unit->unit_type.ToType())];
+		bucket.units.push_back(unit);
+		bucket.flags.push_back(FlagsOf(*unit));
+	}
+}
+
+const UnitSnapshot::AllianceIndex&
+UnitSnapshot::Index(Unit::Alliance alliance) const {
+	size_t a = static_cast<size_t>(alliance);
+	return alliances[a < 5 ? a : 0];
+}
+
+const UnitSnapshot::Bucket* UnitSnapshot::Find(Unit::Alliance alliance,
+	UNIT_TYPEID unit_type) const {
+	const AllianceIndex& index = Index(alliance);
+	auto it = index.by_type.find(static_cast<uint32_t>(unit_type));
+	if (it == index.by_type.end() || it->second.units.empty()) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+const Units& UnitSnapshot::All(Unit::Alliance alliance) const {
+	return Index(alliance).all;
+}
+
+const Units& UnitSnapshot::TownHalls(Unit::Alliance alliance) const {
+	return Index(alliance).town_halls;
+}
+
+const Units& UnitSnapshot::OfType(Unit::Alliance alliance,
+	UNIT_TYPEID unit_type) const {
+	const Bucket* bucket = Find(alliance, unit_type);
+	return bucket ? bucket->units : empty_units;
+}
+
+Units UnitSnapshot::OfType(Unit::Alliance alliance, UNIT_TYPEID unit_type,
+	uint8_t with, uint8_t without) const {
+	Units result;
+	const Bucket* bucket = Find(alliance, unit_type);
+	if (!bucket) {
+		return result;
+	}
+	for (size_t i = 0; i < bucket->units.size(); ++i) {
+		uint8_t flags = bucket->flags[i];
+		if ((flags & with) == with && !(flags & without)) {
+			result.push_back(bucket->units[i]);
+		}
+	}
+	return result;
+}
+
+size_t UnitSnapshot::Count(Unit::Alliance alliance, UNIT_TYPEID unit_type,
+	uint8_t with, uint8_t without) const {
+	const Bucket* bucket = Find(alliance, unit_type);
+	if (!bucket) {
+		return 0;
+	}
+	if (!with && !without) {
+		return bucket->units.size();
+	}
+	size_t count = 0;
+	for (uint8_t flags : bucket->flags) {
+		if ((flags & with) == with && !(flags & without)) {
+			++count;
+		}
+	}
+	return count;
+}
+
+Units UnitSnapshot::OfTypes(Unit::Alliance alliance,
+	const std::vector<UNIT_TYPEID>& unit_types) const {
+	Units result;
+	if (unit_types.size() == 1) {
+		const Units& units = OfType(alliance, unit_types.front());
+		result.assign(units.begin(), units.end());
+		return result;
+	}
+	// Walk the alliance list to keep the observation order across types
+	for (const auto& unit : All(alliance)) {
+		if (std::find(unit_types.begin(), unit_types.end(),
+			unit->unit_type.ToType()) != unit_types.end()) {
+			result.push_back(unit);
+		}
+	}
+	return result;
+}
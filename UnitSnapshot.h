@@ -0,0 +1,109 @@
+#ifndef UNIT_SNAPSHOT_H_
+#define UNIT_SNAPSHOT_H_
+
+#include "sc2api/sc2_interfaces.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Index of every observed unit for one game loop.
+// Units are bucketed by alliance and UNIT_TYPEID so that the per-frame logic
+// can look them up without calling Observation()->GetUnits (which allocates a
+// new vector and scans every unit on each call).
+// Inside a bucket units keep the order GetUnits would return them in.
+class UnitSnapshot {
+public:
+	// Derived per unit flags, computed once when the snapshot is built
+	enum Flag : uint8_t {
+		Completed = 1 << 0, // build_progress == 1.0f
+		Flying = 1 << 1,    // is_flying
+		Idle = 1 << 2,      // orders.empty()
+		HasAddon = 1 << 3,  // add_on_tag != 0
+	};
+
+	UnitSnapshot();
+
+	// Rebuilds the buckets from the observation.
+	// Does nothing if the snapshot was already built for this game loop.
+	void Update(const sc2::ObservationInterface* obs);
+
+	// Game loop the snapshot was built for
+	uint32_t GameLoop() const { return game_loop; }
+
+	// All units of the alliance
+	const sc2::Units& All(sc2::Unit::Alliance alliance) const;
+
+	// All units of the alliance with the given type
+	const sc2::Units& OfType(sc2::Unit::Alliance alliance,
+		sc2::UNIT_TYPEID unit_type) const;
+
+	// Units of the given type with all the flags in `with` set and none of the
+	// flags in `without` set
+	sc2::Units OfType(sc2::Unit::Alliance alliance, sc2::UNIT_TYPEID unit_type,
+		uint8_t with, uint8_t without = 0) const;
+
+	// Number of units of the given type matching the flags
+	size_t Count(sc2::Unit::Alliance alliance, sc2::UNIT_TYPEID unit_type,
+		uint8_t with = 0, uint8_t without = 0) const;
+
+	// Units of any of the given types, in observation order
+	sc2::Units OfTypes(sc2::Unit::Alliance alliance,
+		const std::vector<sc2::UNIT_TYPEID>& unit_types) const;
+
+	// Town halls of the alliance (same as GetUnits(alliance, IsTownHall()))
+	const sc2::Units& TownHalls(sc2::Unit::Alliance alliance) const;
+
+	// Units of the given type that pass the predicate
+	template <typename Predicate>
+	sc2::Units Select(sc2::Unit::Alliance alliance, sc2::UNIT_TYPEID unit_type,
+		Predicate pred) const {
+		sc2::Units result;
+		for (const auto& unit : OfType(alliance, unit_type)) {
+			if (pred(*unit)) {
+				result.push_back(unit);
+			}
+		}
+		return result;
+	}
+
+	// Units of the alliance that pass the predicate
+	template <typename Predicate>
+	sc2::Units Select(sc2::Unit::Alliance alliance, Predicate pred) const {
+		sc2::Units result;
+		for (const auto& unit : All(alliance)) {
+			if (pred(*unit)) {
+				result.push_back(unit);
+			}
+		}
+		return result;
+	}
+
+	// Flags of a unit
+	static uint8_t FlagsOf(const sc2::Unit& unit);
+
+private:
+	struct Bucket {
+		sc2::Units units;
+		std::vector<uint8_t> flags;
+	};
+
+	struct AllianceIndex {
+		sc2::Units all;
+		sc2::Units town_halls;
+		std::unordered_map<uint32_t, Bucket> by_type;
+	};
+
+	const AllianceIndex& Index(sc2::Unit::Alliance alliance) const;
+	const Bucket* Find(sc2::Unit::Alliance alliance,
+		sc2::UNIT_TYPEID unit_type) const;
+
+	// Indexed by Unit::Alliance (Self = 1 ... Enemy = 4)
+	AllianceIndex alliances[5];
+
+	uint32_t game_loop;
+	bool built;
+};
+
+#endif
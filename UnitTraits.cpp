@@ -0,0 +1,39 @@
+#include "UnitTraits.h"
+
+using namespace sc2;
+
+void UnitTraits::Build(const UnitTypes& unit_types) {
+	for (uint32_t index = 0; index < max_unit_type_id; ++index) {
+		UNIT_TYPEID unit_type = static_cast<UNIT_TYPEID>(index);
+		uint16_t traits = 0;
+		traits |= air_types.Has(unit_type) ? Flying : 0;
+		traits |= worker_types.Has(unit_type) ? Worker : 0;
+		traits |= trivial_types.Has(unit_type) ? Trivial : 0;
+		traits |= melee_types.Has(unit_type) ? Melee : 0;
+		traits |= turret_types.Has(unit_type) ? Turret : 0;
+		traits |= heavy_armor_types.Has(unit_type) ? HeavyArmor : 0;
+		traits |= resource_types.Has(unit_type) ? SupplyProvider : 0;
+		flags[index] = traits;
+	}
+	for (const auto& data : unit_types) {
+		uint32_t index = data.unit_type_id;
+		if (index >= max_unit_type_id) {
+			continue;
+		}
+		for (const auto& attribute : data.attributes) {
+			switch (attribute) {
+			case Attribute::Structure:
+				flags[index] |= Structure;
+				break;
+			case Attribute::Armored:
+				flags[index] |= Armored;
+				break;
+			case Attribute::Light:
+				flags[index] |= Light;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef UNIT_TRAITS_H_
+#define UNIT_TRAITS_H_
+
+#include "TypeTables.h"
+
+#include "sc2api/sc2_data.h"
+#include "sc2api/sc2_typeenums.h"
+
+#include <cstdint>
+
+// Packed flags per unit type, indexed directly by the type id, so trait
+// checks on the hot paths are a load and a bit test instead of a search of
+// the type's attributes.
+//
+// Structure, Armored and Light come from the unit type data, which is only
+// known once the game started. The rest are copied from the type tables.
+// Built once per game.
+class UnitTraits {
+public:
+	enum Trait : uint16_t {
+		Structure = 1 << 0,
+		Armored = 1 << 1,
+		Light = 1 << 2,
+		Flying = 1 << 3,
+		Worker = 1 << 4,
+		// Not worth targeting (overlords, observers, changelings)
+		Trivial = 1 << 5,
+		Melee = 1 << 6,
+		// Static anti-air
+		Turret = 1 << 7,
+		HeavyArmor = 1 << 8,
+		SupplyProvider = 1 << 9,
+	};
+
+	// Starts over from the unit type data
+	void Build(const sc2::UnitTypes& unit_types);
+
+	// True if the type has any of the traits
+	bool Has(sc2::UnitTypeID unit_type, uint16_t traits) const {
+		return (Of(unit_type) & traits) != 0;
+	}
+
+	uint16_t Of(sc2::UnitTypeID unit_type) const {
+		uint32_t index = unit_type;
+		uint16_t traits = flags[index % max_unit_type_id];
+		return index < max_unit_type_id ? traits : 0;
+	}
+
+private:
+	uint16_t flags[max_unit_type_id] = {};
+};
+
+#endif
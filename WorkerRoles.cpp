@@ -0,0 +1,137 @@
+#include "WorkerRoles.h"
+
+#include "TypeTables.h"
+
+#include "sc2api/sc2_typeenums.h"
+
+#include <algorithm>
+
+using namespace sc2;
+
+WorkerRoles::Role WorkerRoles::ActivityOf(const Unit& scv) const {
+	if (scv.orders.empty()) {
+		return Idle;
+	}
+	// The game reports the SCV's own abilities, commands may use the generic
+	const UnitOrder& order = scv.orders.front();
+	switch (order.ability_id.ToType()) {
+	case ABILITY_ID::HARVEST_GATHER:
+	case ABILITY_ID::HARVEST_GATHER_SCV:
+		return std::binary_search(refinery_tags.begin(), refinery_tags.end(),
+			order.target_unit_tag)
+			? Gas
+			: Minerals;
+	case ABILITY_ID::HARVEST_RETURN:
+	case ABILITY_ID::HARVEST_RETURN_SCV:
+		return Returning;
+	case ABILITY_ID::EFFECT_REPAIR:
+	case ABILITY_ID::EFFECT_REPAIR_SCV:
+		return Repairing;
+	case ABILITY_ID::ATTACK:
+	case ABILITY_ID::ATTACK_ATTACK:
+		return Militia;
+	default:
+		return build_abilities.Has(order.ability_id) ? Builder : Other;
+	}
+}
+
+void WorkerRoles::SetRoles(Entry& entry, uint16_t roles) {
+	uint16_t changed = entry.roles ^ roles;
+	for (size_t bit = 0; changed; ++bit, changed >>= 1) {
+		if (changed & 1) {
+			if (roles & (1 << bit)) {
+				++counts[bit];
+			}
+			else {
+				--counts[bit];
+			}
+		}
+	}
+	entry.roles = roles;
+}
+
+void WorkerRoles::Update(const Units& scvs, const Units& refineries) {
+	std::vector<Tag> tags;
+	tags.reserve(refineries.size());
+	for (const auto& refinery : refineries) {
+		tags.push_back(refinery->tag);
+	}
+	std::sort(tags.begin(), tags.end());
+	// Gatherers may have changed between minerals and gas
+	bool reclassify = tags != refinery_tags;
+	refinery_tags.swap(tags);
+
+	for (const auto& scv : scvs) {
+		Entry& entry = entries[scv->tag];
+		entry.unit = scv;
+		AbilityID ability_id;
+		Tag target = 0;
+		if (!scv->orders.empty()) {
+			ability_id = scv->orders.front().ability_id;
+			target = scv->orders.front().target_unit_tag;
+		}
+		if (entry.classified && !reclassify &&
+			entry.ability_id == ability_id && entry.target == target) {
+			continue;
+		}
+		entry.ability_id = ability_id;
+		entry.target = target;
+		entry.classified = true;
+		SetRoles(entry, (entry.roles & ~AnyActivity) | ActivityOf(*scv));
+	}
+}
+
+void WorkerRoles::OnDestroyed(const Unit* unit) {
+	auto it = entries.find(unit->tag);
+	if (it == entries.end()) {
+		return;
+	}
+	SetRoles(it->second, 0);
+	entries.erase(it);
+}
+
+void WorkerRoles::Assign(const Unit* scv, Role duty) {
+	Entry& entry = entries[scv->tag];
+	entry.unit = scv;
+	SetRoles(entry, entry.roles | duty);
+}
+
+void WorkerRoles::Release(Tag tag, Role duty) {
+	auto it = entries.find(tag);
+	if (it != entries.end()) {
+		SetRoles(it->second, it->second.roles & ~duty);
+	}
+}
+
+void WorkerRoles::ReleaseAll(Role duty) {
+	if (!Count(duty)) {
+		return;
+	}
+	for (auto& it : entries) {
+		SetRoles(it.second, it.second.roles & ~duty);
+	}
+}
+
+bool WorkerRoles::Has(Tag tag, uint16_t roles) const {
+	auto it = entries.find(tag);
+	return it != entries.end() && (it->second.roles & roles) != 0;
+}
+
+size_t WorkerRoles::Count(Role role) const {
+	for (size_t bit = 0; bit < counts.size(); ++bit) {
+		if (role == (1 << bit)) {
+			return counts[bit];
+		}
+	}
+	return 0;
+}
+
+Units WorkerRoles::Get(uint16_t roles) const {
+	Units units;
+	for (const auto& it : entries) {
+		if (it.second.roles & roles) {
+			units.push_back(it.second.unit);
+		}
+	}
+	return units;
+}
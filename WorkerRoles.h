@@ -0,0 +1,77 @@
+#ifndef WORKER_ROLES_H_
+#define WORKER_ROLES_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_unit.h"
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// What every SCV is doing, by tag, so builder selection and the gas check
+// don't rescan all SCVs against all refineries.
+//
+// Activities follow the SCV's first order. Update() runs once per game loop
+// and only reclassifies the SCVs whose order changed, or all of them when a
+// refinery was built or lost. SCVs out of sight inside a refinery keep the
+// activity they went in with. Duties are given by the bot and kept until
+// released or the SCV dies.
+class WorkerRoles {
+public:
+	enum Role : uint16_t {
+		// Activities, exactly one per SCV
+		Idle = 1 << 0,      // no orders
+		Minerals = 1 << 1,  // gathering anything but a refinery
+		Gas = 1 << 2,       // gathering from one of our refineries
+		Returning = 1 << 3, // returning cargo
+		Builder = 1 << 4,   // on its way to build or building
+		Repairing = 1 << 5,
+		Militia = 1 << 6,   // attacking
+		Other = 1 << 7,
+		AnyActivity = 0xff,
+		// Duties
+		Scout = 1 << 8,
+		RepairCrew = 1 << 9,
+	};
+
+	// Picks up order changes of this game loop's SCVs
+	void Update(const sc2::Units& scvs, const sc2::Units& refineries);
+
+	void OnDestroyed(const sc2::Unit* unit);
+
+	void Assign(const sc2::Unit* scv, Role duty);
+	void Release(sc2::Tag tag, Role duty);
+	// Releases every SCV from the duty
+	void ReleaseAll(Role duty);
+
+	// True if the SCV has any of the roles
+	bool Has(sc2::Tag tag, uint16_t roles) const;
+
+	// Number of SCVs with the role
+	size_t Count(Role role) const;
+
+	// SCVs with any of the roles
+	sc2::Units Get(uint16_t roles) const;
+
+private:
+	struct Entry {
+		const sc2::Unit* unit = nullptr;
+		uint16_t roles = 0;
+		// First order when last classified
+		sc2::AbilityID ability_id;
+		sc2::Tag target = 0;
+		bool classified = false;
+	};
+
+	Role ActivityOf(const sc2::Unit& scv) const;
+	void SetRoles(Entry& entry, uint16_t roles);
+
+	std::unordered_map<sc2::Tag, Entry> entries;
+	// Sorted tags of our refineries
+	std::vector<sc2::Tag> refinery_tags;
+	// SCVs per role bit
+	std::array<uint32_t, 16> counts{};
+};
+
+#endif
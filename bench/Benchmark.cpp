@@ -0,0 +1,109 @@
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace sc2;
+
+BenchResult RunBenchmark(const std::string& name, size_t n,
+	const std::function<void()>& f, double min_seconds) {
+	typedef std::chrono::steady_clock clock;
+
+	// Warm up caches and allocators
+	f();
+
+	size_t iterations = 0;
+	size_t batch = 1;
+	double elapsed = 0.0;
+	do {
+		auto start = clock::now();
+		for (size_t i = 0; i < batch; ++i) {
+			f();
+		}
+		elapsed += std::chrono::duration<double>(clock::now() - start).count();
+		iterations += batch;
+		batch *= 2;
+	} while (elapsed < min_seconds);
+	return { name, n, iterations, elapsed * 1e9 / iterations };
+}
+
+void PrintResults(const std::vector<BenchResult>& results) {
+	std::printf("%-48s %8s %12s %14s\n", "benchmark", "n", "iterations",
+		"ns/iter");
+	for (const auto& r : results) {
+		std::printf("%-48s %8zu %12zu %14.1f\n", r.name.c_str(), r.n,
+			r.iterations, r.ns_per_iter);
+	}
+}
+
+void WriteJson(const std::vector<BenchResult>& results, std::FILE* out) {
+	std::fprintf(out, "{\n  \"benchmarks\": [");
+	for (size_t i = 0; i < results.size(); ++i) {
+		const BenchResult& r = results[i];
+		std::string name;
+		for (char c : r.name) {
+			if (c == '"' || c == '\\') {
+				name += '\\';
+			}
+			name += c;
+		}
+		std::fprintf(out, "%s\n    { \"name\": \"%s\", \"n\": %zu, "
+			"\"iterations\": %zu, \"ns_per_iter\": %.1f }",
+			i ? "," : "", name.c_str(), r.n, r.iterations, r.ns_per_iter);
+	}
+	std::fprintf(out, "\n  ]\n}\n");
+}
+
+namespace {
+const void* volatile sink = nullptr;
+}
+
+void DoNotOptimize(const void* p) {
+	sink = p;
+}
+
+std::vector<Unit> MakeClumpedUnits(size_t n, const Point2D& center,
+	uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> hp(5.0f, 120.0f);
+
+	const UNIT_TYPEID types[] = { UNIT_TYPEID::ZERG_ZERGLING,
+		UNIT_TYPEID::ZERG_BANELING, UNIT_TYPEID::ZERG_ROACH,
+		UNIT_TYPEID::ZERG_HYDRALISK };
+
+	// A clump every 25 units, about 4 apart
+	size_t clumps = n / 25 + 1;
+	std::vector<Unit> units(n);
+	for (size_t i = 0; i < n; ++i) {
+		size_t clump = i % clumps;
+		Point2D c(center.x + 4.0f * clump, center.y + 2.0f * (clump % 2));
+		Unit& u = units[i];
+		u.tag = i + 1;
+		u.alliance = Unit::Alliance::Enemy;
+		u.unit_type = types[i % 4];
+		u.pos = Point3D(c.x + 2.5f * offset(rng), c.y + 2.5f * offset(rng),
+			10.0f);
+		u.health = hp(rng);
+		u.health_max = 120.0f;
+		u.is_alive = true;
+	}
+	return units;
+}
+
+Units ToUnits(std::vector<Unit>& units) {
+	Units result;
+	result.reserve(units.size());
+	for (auto& unit : units) {
+		result.push_back(&unit);
+	}
+	return result;
+}
+
+// Map sizes are approximate, the terrain itself is synthetic
+const MapSize bench_maps[3] = {
+	{ "CactusValleyLE", 184, 184 },
+	{ "BelShirVestigeLE", 148, 148 },
+	{ "ProximaStationLE", 200, 176 },
+};
@@ -0,0 +1,57 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Timing of one benchmark case
+struct BenchResult {
+	std::string name;
+	size_t n;             // problem size (e.g. number of enemies)
+	size_t iterations;    // how many times the case ran
+	double ns_per_iter;   // mean time per run
+};
+
+// Runs f until at least min_seconds have passed (at least once after a
+// warm-up run) and returns the mean time
+BenchResult RunBenchmark(const std::string& name, size_t n,
+	const std::function<void()>& f, double min_seconds = 0.2);
+
+// Prints the results as a table
+void PrintResults(const std::vector<BenchResult>& results);
+
+// Writes the results as a JSON object, for comparing runs
+void WriteJson(const std::vector<BenchResult>& results, std::FILE* out);
+
+// Keeps the compiler from optimizing a result away
+void DoNotOptimize(const void* p);
+
+// n units placed in a few tight clumps (like a zergling/baneling ball)
+// around center, with random hp and a mix of light and armored types
+std::vector<sc2::Unit> MakeClumpedUnits(size_t n, const sc2::Point2D& center,
+	uint32_t seed);
+
+// Pointers to the units, in order
+sc2::Units ToUnits(std::vector<sc2::Unit>& units);
+
+// Sizes of the ladder maps the benches build their synthetic terrain for
+struct MapSize {
+	const char* name;
+	int width;
+	int height;
+};
+
+extern const MapSize bench_maps[3];
+
+// Benchmark suites
+void BenchSiegeTankTargeting(std::vector<BenchResult>& results);
+void BenchTerrainHeight(std::vector<BenchResult>& results);
+void BenchFindGroups(std::vector<BenchResult>& results);
+void BenchBotKernels(std::vector<BenchResult>& results);
+
+#endif
@@ -0,0 +1,67 @@
+#include "BotBench.h"
+
+using namespace sc2;
+
+BenchMap MakeMap(const MapSize& map) {
+	BenchMap result;
+	GameInfo& info = result.game_info;
+	info.width = map.width;
+	info.height = map.height;
+	info.map_name = map.name;
+	info.playable_min = Point2D(2.0f, 2.0f);
+	info.playable_max = Point2D(map.width - 2.0f, map.height - 2.0f);
+	info.terrain_height.width = map.width;
+	info.terrain_height.height = map.height;
+	info.terrain_height.bits_per_pixel = 8;
+	info.terrain_height.data.assign(
+		static_cast<size_t>(map.width) * map.height, 0);
+
+	auto plateau_height = [](int px, int py) {
+		return 100 + 12 * ((px + py) % 4);
+	};
+	for (int y = 0; y < map.height; ++y) {
+		for (int x = 0; x < map.width; ++x) {
+			int height = plateau_height(x / 32, y / 32);
+			bool cliff = x % 32 < 2 || y % 32 < 2;
+			bool ramp = false;
+			// The corner up and right of this cell
+			int cx = (x + 16) / 32 * 32;
+			int cy = (y + 16) / 32 * 32;
+			int along = (x - cx) + (y - cy);
+			int across = (x - cx) - (y - cy);
+			if (cx > 0 && cy > 0 && along >= -5 && along < 6 && across >= -1 &&
+				across <= 2) {
+				// From the plateau below left to the one above right
+				float t = (along + 5) / 10.0f;
+				int low = plateau_height(cx / 32 - 1, cy / 32 - 1);
+				int high = plateau_height(cx / 32, cy / 32);
+				height = static_cast<int>(low + (high - low) * t);
+				ramp = true;
+			}
+			info.terrain_height.data[x + (map.height - 1 - y) * map.width] =
+				static_cast<char>(height);
+			if (ramp) {
+				result.ramp.emplace_back(float(x), float(y));
+			}
+			else if (!cliff) {
+				result.placable.emplace_back(float(x), float(y));
+			}
+		}
+	}
+	info.start_locations = { Point2D(16.5f, 16.5f) };
+	result.start_location = Point2D(16.5f, 16.5f);
+	return result;
+}
+
+Unit OwnUnit(Tag tag, UNIT_TYPEID type, const Point2D& pos) {
+	Unit unit;
+	unit.tag = tag;
+	unit.alliance = Unit::Alliance::Self;
+	unit.unit_type = type;
+	unit.pos = Point3D(pos.x, pos.y, 10.0f);
+	unit.health = 100.0f;
+	unit.health_max = 100.0f;
+	unit.build_progress = 1.0f;
+	unit.is_alive = true;
+	return unit;
+}
@@ -0,0 +1,228 @@
+#ifndef BOT_BENCH_H_
+#define BOT_BENCH_H_
+
+#include "Benchmark.h"
+
+#include "../BasicSc2Bot.h"
+#include "OfflineInterfaces.h"
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Access to the bot's internals for the benches that run its own code on
+// synthetic maps and unit sets through the offline interfaces
+struct BotBenchAccess {
+	// What on_start sets up before the kernels run
+	static void Prepare(BasicSc2Bot& bot, const sc2::Point2D& start_location) {
+		const sc2::GameInfo& game_info = bot.Observation()->GetGameInfo();
+		bot.start_location = start_location;
+		bot.base_location = BasicSc2Bot::BaseLocation::leftbottom;
+		bot.playable_min = game_info.playable_min;
+		bot.playable_max = game_info.playable_max;
+		bot.map_corners = {
+			sc2::Point2D(game_info.playable_min.x, game_info.playable_min.y),
+			sc2::Point2D(game_info.playable_max.x, game_info.playable_min.y),
+			sc2::Point2D(game_info.playable_min.x, game_info.playable_max.y),
+			sc2::Point2D(game_info.playable_max.x, game_info.playable_max.y) };
+		bot.decode_terrain_height();
+		bot.BuildUnitTraits();
+	}
+
+	static void DecodeTerrainHeight(BasicSc2Bot& bot) {
+		bot.decode_terrain_height();
+	}
+
+	static int HeightAt(const BasicSc2Bot& bot, const sc2::Point2D& p) {
+		return bot.height_at(sc2::Point2DI(p));
+	}
+
+	static std::vector<sc2::Point2D> ConvexHull(const BasicSc2Bot& bot,
+		std::vector<sc2::Point2D>& points) {
+		return bot.convexHull(points);
+	}
+
+	static std::vector<sc2::Point2D> CircleIntersection(const BasicSc2Bot& bot,
+		const sc2::Point2D& p1, const sc2::Point2D& p2, float r) {
+		return bot.circle_intersection(p1, p2, r);
+	}
+
+	static sc2::Point2D Towards(const BasicSc2Bot& bot, const sc2::Point2D& p1,
+		const sc2::Point2D& p2, float distance) {
+		return bot.towards(p1, p2, distance);
+	}
+
+	// Groups from a fresh start, like on_start
+	static void FindGroups(BasicSc2Bot& bot, std::vector<sc2::Point2D>& points,
+		int minimum_points_per_group) {
+		bot.ramps.clear();
+		bot.build_map.clear();
+		bot.find_groups(points, minimum_points_per_group, 2);
+	}
+
+	static const std::vector<std::vector<sc2::Point2D>>& Ramps(
+		const BasicSc2Bot& bot) {
+		return bot.ramps;
+	}
+
+	static std::vector<sc2::Point2D> CornerDepots(const BasicSc2Bot& bot,
+		const std::vector<sc2::Point2D>& ramp) {
+		return bot.corner_depots(ramp);
+	}
+
+	static sc2::Point2D BarracksPlacement(BasicSc2Bot& bot,
+		const std::vector<sc2::Point2D>& ramp,
+		const std::vector<sc2::Point2D>& depots) {
+		bot.mainBase_depot_points = depots;
+		return bot.barracks_correct_placement(ramp, depots);
+	}
+
+	static sc2::Point2D NearestSafePosition(BasicSc2Bot& bot,
+		const sc2::Point2D& pos) {
+		return bot.GetNearestSafePosition(pos);
+	}
+
+	static sc2::Point2D KiteVector(BasicSc2Bot& bot, const sc2::Unit* unit,
+		const sc2::Unit* target) {
+		return bot.GetKiteVector(unit, target);
+	}
+
+	static void TargetSiegeTank(BasicSc2Bot& bot) {
+		bot.TargetSiegeTank();
+	}
+
+	static void ControlMarines(BasicSc2Bot& bot) {
+		bot.ControlMarines();
+	}
+
+	static const sc2::Unit* ClosestTarget(BasicSc2Bot& bot,
+		const sc2::Unit* unit) {
+		return bot.GetClosestTarget(unit);
+	}
+
+	// The old version, a nearest query on the enemy grid
+	static const sc2::Unit* ClosestTargetGrid(const BasicSc2Bot& bot,
+		const sc2::Unit* unit) {
+		return bot.EnemyGrid().Nearest(unit->pos,
+			[](const sc2::Unit* enemy_unit) {
+				return enemy_unit->is_alive;
+			}, 13.0f);
+	}
+
+	static int UnitsInCombat(BasicSc2Bot& bot, sc2::UNIT_TYPEID unit_type) {
+		return bot.UnitsInCombat(unit_type);
+	}
+
+	static const sc2::Unit* BattlecruiserTarget(const BasicSc2Bot& bot,
+		const sc2::Unit* unit, bool avoid_turrets) {
+		return bot.GetBattlecruiserTarget(unit, avoid_turrets, 20.0f);
+	}
+
+	// The old version: one pass over the enemies per priority group, each
+	// on a fresh copy of the enemy list
+	static const sc2::Unit* BattlecruiserTargetCascade(const BasicSc2Bot& bot,
+		const sc2::Unit* unit, bool avoid_turrets) {
+		const float max_distance = 20.0f;
+		const sc2::Unit* target = nullptr;
+		float min_distance = std::numeric_limits<float>::max();
+		float min_hp = std::numeric_limits<float>::max();
+		auto update_target = [&](const sc2::Unit* enemy_unit) {
+			float distance = sc2::Distance2D(unit->pos, enemy_unit->pos);
+			if (!enemy_unit->is_alive || distance > max_distance) {
+				return;
+			}
+			if (distance < min_distance ||
+				(distance == min_distance && enemy_unit->health < min_hp)) {
+				min_distance = distance;
+				min_hp = enemy_unit->health;
+				target = enemy_unit;
+			}
+		};
+		auto pass = [&](const std::function<bool(const sc2::Unit*)>& in_group) {
+			for (const auto& enemy_unit :
+				bot.Observation()->GetUnits(sc2::Unit::Alliance::Enemy)) {
+				if (in_group(enemy_unit)) {
+					update_target(enemy_unit);
+				}
+			}
+		};
+		const UnitTraits& traits = bot.unit_traits;
+		pass([&](const sc2::Unit* u) {
+			return threat_levels[u->unit_type] != 0 &&
+				!(avoid_turrets &&
+					traits.Has(u->unit_type, UnitTraits::Turret));
+		});
+		if (!target) {
+			pass([&](const sc2::Unit* u) {
+				return traits.Has(u->unit_type, UnitTraits::Worker);
+			});
+		}
+		if (!target) {
+			pass([&](const sc2::Unit* u) {
+				return traits.Has(u->unit_type, UnitTraits::Turret);
+			});
+		}
+		if (!target) {
+			pass([&](const sc2::Unit* u) {
+				return !traits.Has(u->unit_type, UnitTraits::Structure) &&
+					u->unit_type != sc2::UNIT_TYPEID::ZERG_LARVA &&
+					u->unit_type != sc2::UNIT_TYPEID::ZERG_EGG;
+			});
+		}
+		if (!target) {
+			pass([&](const sc2::Unit* u) {
+				return traits.Has(u->unit_type, UnitTraits::SupplyProvider);
+			});
+		}
+		if (!target) {
+			pass([&](const sc2::Unit* u) {
+				return traits.Has(u->unit_type, UnitTraits::Structure);
+			});
+		}
+		return target;
+	}
+};
+
+// A synthetic map and where our base is on it
+struct BenchMap {
+	sc2::GameInfo game_info;
+	sc2::Point2D start_location;
+	std::vector<sc2::Point2D> placable;
+	std::vector<sc2::Point2D> ramp;
+};
+
+// Plateaus of four heights split by cliffs every 32 cells, and a diagonal
+// ramp (two cells to a row, like the game's) across every cliff corner
+BenchMap MakeMap(const MapSize& map);
+
+// An offline observation of the map holding these units
+class BenchGame {
+public:
+	BenchGame(const sc2::GameInfo& game_info, const sc2::Point2D& start,
+		const std::vector<sc2::Unit>& units)
+		: observation(game_info, sc2::Point3D(start.x, start.y, 10.0f)),
+		query(observation) {
+		OfflineFrame frame;
+		frame.game_loop = 1000;
+		frame.units = units;
+		observation.Update(frame);
+	}
+
+	void Attach(BasicSc2Bot& bot, const sc2::Point2D& start) {
+		bot.UseInterfaces(&observation, &query, &actions);
+		BotBenchAccess::Prepare(bot, start);
+	}
+
+	OfflineActions& Actions() { return actions; }
+
+private:
+	OfflineObservation observation;
+	OfflineQuery query;
+	OfflineActions actions;
+};
+
+// One of our own units, complete and at full health
+sc2::Unit OwnUnit(sc2::Tag tag, sc2::UNIT_TYPEID type,
+	const sc2::Point2D& pos);
+
+#endif
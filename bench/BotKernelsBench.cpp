@@ -0,0 +1,294 @@
+#include "BotBench.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace sc2;
+
+// The bot's own geometry, map analysis and targeting code, run on synthetic
+// maps and unit sets through the offline interfaces
+namespace {
+std::vector<Point2D> RandomPoints(size_t n, float width, float height,
+	uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> x(0.0f, width);
+	std::uniform_real_distribution<float> y(0.0f, height);
+	std::vector<Point2D> points(n);
+	for (auto& p : points) {
+		p = Point2D(x(rng), y(rng));
+	}
+	return points;
+}
+
+void BenchGeometry(std::vector<BenchResult>& results) {
+	const BenchMap map = MakeMap(bench_maps[1]);
+	BenchGame game(map.game_info, map.start_location, {});
+	BasicSc2Bot bot;
+	game.Attach(bot, map.start_location);
+
+	// A mineral line has 8 fields of two cells each
+	for (size_t n : { 16, 256 }) {
+		const std::vector<Point2D> points =
+			RandomPoints(n, 12.0f, 12.0f, static_cast<uint32_t>(n));
+		results.push_back(RunBenchmark("convexHull", n, [&]() {
+			// It sorts its input, so each run gets a fresh copy
+			std::vector<Point2D> input = points;
+			std::vector<Point2D> hull = BotBenchAccess::ConvexHull(bot, input);
+			DoNotOptimize(hull.data());
+			}));
+	}
+
+	// Pairs closer than the radius, as the ramp wall code passes in
+	const size_t pairs = 1024;
+	std::vector<Point2D> from = RandomPoints(pairs, 150.0f, 150.0f, 1);
+	std::vector<Point2D> to(pairs);
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+	for (size_t i = 0; i < pairs; ++i) {
+		to[i] = from[i] + Point2D(1.0f + offset(rng), offset(rng));
+	}
+	results.push_back(RunBenchmark("circle_intersection", pairs, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < pairs; ++i) {
+			std::vector<Point2D> points =
+				BotBenchAccess::CircleIntersection(bot, from[i], to[i], 2.5f);
+			sum += points[0].x;
+		}
+		DoNotOptimize(&sum);
+		}));
+	results.push_back(RunBenchmark("towards", pairs, [&]() {
+		float sum = 0.0f;
+		for (size_t i = 0; i < pairs; ++i) {
+			sum += BotBenchAccess::Towards(bot, from[i], to[i], 3.0f).x;
+		}
+		DoNotOptimize(&sum);
+		}));
+}
+
+void BenchMapAnalysis(std::vector<BenchResult>& results) {
+	for (const auto& size : bench_maps) {
+		BenchMap map = MakeMap(size);
+		BenchGame game(map.game_info, map.start_location, {});
+		BasicSc2Bot bot;
+		game.Attach(bot, map.start_location);
+		std::string name = std::string("/") + size.name;
+
+		// Same arguments as find_ramps_build_map
+		results.push_back(RunBenchmark("find_groups" + name + "/build_map",
+			map.placable.size(), [&]() {
+				BotBenchAccess::FindGroups(bot, map.placable, -1);
+			}, 0.5));
+		results.push_back(RunBenchmark("find_groups" + name + "/ramps",
+			map.ramp.size(), [&]() {
+				BotBenchAccess::FindGroups(bot, map.ramp, 8);
+			}));
+
+		// The ramp nearest the start, sorted by height like find_groups does
+		const std::vector<Point2D>* main_ramp = nullptr;
+		for (const auto& ramp : BotBenchAccess::Ramps(bot)) {
+			if (!main_ramp || Distance2D(ramp[0], map.start_location) <
+				Distance2D((*main_ramp)[0], map.start_location)) {
+				main_ramp = &ramp;
+			}
+		}
+		if (!main_ramp) {
+			continue;
+		}
+		std::vector<Point2D> depots;
+		results.push_back(RunBenchmark("corner_depots" + name,
+			main_ramp->size(), [&]() {
+				depots = BotBenchAccess::CornerDepots(bot, *main_ramp);
+				DoNotOptimize(depots.data());
+			}));
+		if (depots.size() != 2 || std::isnan(depots[0].x) ||
+			std::isnan(depots[1].x)) {
+			std::fprintf(stderr, "corner_depots: no ramp wall found on %s\n",
+				size.name);
+			continue;
+		}
+		results.push_back(RunBenchmark("barracks_correct_placement" + name,
+			main_ramp->size(), [&]() {
+				Point2D barracks =
+					BotBenchAccess::BarracksPlacement(bot, *main_ramp, depots);
+				DoNotOptimize(&barracks);
+			}));
+	}
+}
+
+void BenchUnits(std::vector<BenchResult>& results) {
+	const BenchMap map = MakeMap(bench_maps[1]);
+	const Point2D battle(60.0f, 50.0f);
+
+	for (size_t n : { 10, 50, 200 }) {
+		std::vector<Unit> units = MakeClumpedUnits(n, battle,
+			static_cast<uint32_t>(11 + n));
+		// A battlecruiser looking at the enemies
+		units.push_back(OwnUnit(0x20000, UNIT_TYPEID::TERRAN_BATTLECRUISER,
+			battle + Point2D(-4.0f, 3.0f)));
+		BenchGame game(map.game_info, map.start_location, units);
+		BasicSc2Bot bot;
+		game.Attach(bot, map.start_location);
+		const Unit& battlecruiser = units.back();
+
+		results.push_back(RunBenchmark("GetNearestSafePosition", n, [&]() {
+			Point2D safe = BotBenchAccess::NearestSafePosition(bot, battle);
+			DoNotOptimize(&safe);
+			}));
+		results.push_back(RunBenchmark("GetKiteVector", n, [&]() {
+			float sum = 0.0f;
+			for (size_t i = 0; i < n; ++i) {
+				sum += BotBenchAccess::KiteVector(bot, &battlecruiser,
+					&units[i]).x;
+			}
+			DoNotOptimize(&sum);
+			}));
+	}
+}
+
+// A 60 Marine army in a grid facing the clumps of enemies
+void BenchMarineMicro(std::vector<BenchResult>& results) {
+	const BenchMap map = MakeMap(bench_maps[1]);
+	const Point2D battle(60.0f, 50.0f);
+
+	for (size_t n : { 20, 60, 200 }) {
+		std::vector<Unit> units = MakeClumpedUnits(n, battle,
+			static_cast<uint32_t>(31 + n));
+		for (int i = 0; i < 60; ++i) {
+			units.push_back(OwnUnit(0x30000 + i, UNIT_TYPEID::TERRAN_MARINE,
+				battle + Point2D(-14.0f + 0.75f * (i % 10),
+					-6.0f + 0.75f * (i / 10))));
+			// Half of them still on cooldown, so they kite
+			units.back().weapon_cooldown = i % 2 ? 5.0f : 0.0f;
+		}
+		BenchGame game(map.game_info, map.start_location, units);
+		BasicSc2Bot bot;
+		game.Attach(bot, map.start_location);
+		const Units marines = bot.Observation()->GetUnits(
+			Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_MARINE));
+
+		for (const auto& marine : marines) {
+			if (BotBenchAccess::ClosestTarget(bot, marine) !=
+				BotBenchAccess::ClosestTargetGrid(bot, marine)) {
+				std::fprintf(stderr, "GetClosestTarget: arrays and grid "
+					"targets differ for n = %zu\n", n);
+				break;
+			}
+		}
+
+		results.push_back(RunBenchmark("GetClosestTarget/grid", n, [&]() {
+			for (const auto& marine : marines) {
+				const Unit* target =
+					BotBenchAccess::ClosestTargetGrid(bot, marine);
+				DoNotOptimize(target);
+			}
+			}));
+		results.push_back(RunBenchmark("GetClosestTarget/arrays", n, [&]() {
+			for (const auto& marine : marines) {
+				const Unit* target = BotBenchAccess::ClosestTarget(bot, marine);
+				DoNotOptimize(target);
+			}
+			}));
+		results.push_back(RunBenchmark("UnitsInCombat/marines", n, [&]() {
+			int in_combat = BotBenchAccess::UnitsInCombat(bot,
+				UNIT_TYPEID::TERRAN_MARINE);
+			DoNotOptimize(&in_combat);
+			}));
+		// The gateway drops repeats within a game loop, so after the first
+		// run this is the targeting and kiting math alone
+		results.push_back(RunBenchmark("ControlMarines/60_marines", n, [&]() {
+			BotBenchAccess::ControlMarines(bot);
+			game.Actions().TakeCommands();
+			}));
+	}
+}
+
+// Enemies around a Battlecruiser for its target priorities: a few of every
+// group, on a half cell lattice with few distinct hp values so that ties
+// in distance and hp come up
+std::vector<Unit> MakeBattlecruiserTargets(size_t n, const Point2D& center,
+	uint32_t seed) {
+	const UNIT_TYPEID types[] = {
+		UNIT_TYPEID::ZERG_HYDRALISK, UNIT_TYPEID::ZERG_DRONE,
+		UNIT_TYPEID::ZERG_SPORECRAWLER, UNIT_TYPEID::ZERG_ZERGLING,
+		UNIT_TYPEID::ZERG_OVERLORD, UNIT_TYPEID::ZERG_HATCHERY,
+		UNIT_TYPEID::ZERG_LARVA, UNIT_TYPEID::ZERG_ROACH,
+		UNIT_TYPEID::TERRAN_SUPPLYDEPOT, UNIT_TYPEID::ZERG_QUEEN };
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> offset(-48, 48);
+	std::uniform_int_distribution<int> hp(1, 4);
+	std::vector<Unit> units(n);
+	for (size_t i = 0; i < n; ++i) {
+		Unit& u = units[i];
+		u.tag = i + 1;
+		u.alliance = Unit::Alliance::Enemy;
+		u.unit_type = types[i % 10];
+		u.pos = Point3D(center.x + 0.5f * offset(rng),
+			center.y + 0.5f * offset(rng), 10.0f);
+		u.health = 25.0f * hp(rng);
+		u.health_max = 100.0f;
+		u.build_progress = 1.0f;
+		u.is_alive = i % 17 != 0;
+	}
+	return units;
+}
+
+void BenchBattlecruiserTargeting(std::vector<BenchResult>& results) {
+	const BenchMap map = MakeMap(bench_maps[1]);
+	const Point2D battle(70.0f, 60.0f);
+
+	for (size_t n : { 50, 100, 200, 400 }) {
+		std::vector<Unit> units = MakeBattlecruiserTargets(n, battle,
+			static_cast<uint32_t>(23 + n));
+		// Battlecruisers spread over the fight, some with nothing in range
+		for (int i = 0; i < 8; ++i) {
+			units.push_back(OwnUnit(0x20000 + i,
+				UNIT_TYPEID::TERRAN_BATTLECRUISER,
+				battle + Point2D(-28.0f + 8.0f * i, 4.0f * (i % 3) - 4.0f)));
+		}
+		BenchGame game(map.game_info, map.start_location, units);
+		BasicSc2Bot bot;
+		game.Attach(bot, map.start_location);
+		const Units battlecruisers = bot.Observation()->GetUnits(
+			Unit::Alliance::Self, IsUnit(UNIT_TYPEID::TERRAN_BATTLECRUISER));
+
+		for (bool avoid_turrets : { false, true }) {
+			for (const auto& battlecruiser : battlecruisers) {
+				if (BotBenchAccess::BattlecruiserTarget(bot, battlecruiser,
+					avoid_turrets) !=
+					BotBenchAccess::BattlecruiserTargetCascade(bot,
+						battlecruiser, avoid_turrets)) {
+					std::fprintf(stderr, "TargetBattlecruisers: single pass "
+						"and cascade targets differ for n = %zu\n", n);
+				}
+			}
+		}
+
+		results.push_back(RunBenchmark("TargetBattlecruisers/cascade", n,
+			[&]() {
+				for (const auto& battlecruiser : battlecruisers) {
+					const Unit* target =
+						BotBenchAccess::BattlecruiserTargetCascade(bot,
+							battlecruiser, true);
+					DoNotOptimize(target);
+				}
+			}));
+		results.push_back(RunBenchmark("TargetBattlecruisers/single_pass", n,
+			[&]() {
+				for (const auto& battlecruiser : battlecruisers) {
+					const Unit* target = BotBenchAccess::BattlecruiserTarget(
+						bot, battlecruiser, true);
+					DoNotOptimize(target);
+				}
+			}));
+	}
+}
+}
+
+void BenchBotKernels(std::vector<BenchResult>& results) {
+	BenchGeometry(results);
+	BenchMapAnalysis(results);
+	BenchUnits(results);
+	BenchMarineMicro(results);
+	BenchBattlecruiserTargeting(results);
+}
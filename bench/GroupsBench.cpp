@@ -0,0 +1,143 @@
+#include "Benchmark.h"
+
+#include "../GroupLabeling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <random>
+
+using namespace sc2;
+
+// Grouping of placement and ramp cells in on_start (find_groups)
+namespace {
+// Plateaus split by cliffs every 32 cells, with doodads on them and
+// ramps cut into the cliffs. Cells are listed row by row like
+// find_ramps_build_map does.
+void MakeCells(const MapSize& map, uint32_t seed, std::vector<Point2D>& placable,
+	std::vector<Point2D>& ramp) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> percent(0, 99);
+	for (int y = 0; y < map.height; ++y) {
+		for (int x = 0; x < map.width; ++x) {
+			bool cliff = x % 32 < 2 || y % 32 < 2;
+			if (!cliff) {
+				if (percent(rng) >= 5) {
+					placable.emplace_back(float(x), float(y));
+				}
+				continue;
+			}
+			// A ramp every other plateau along each cliff
+			bool ramp_x = x % 32 < 2 && (y % 64) >= 12 && (y % 64) < 18;
+			bool ramp_y = y % 32 < 2 && (x % 64) >= 40 && (x % 64) < 46;
+			if (ramp_x || ramp_y) {
+				ramp.emplace_back(float(x), float(y));
+			}
+		}
+	}
+}
+
+// The old find_groups flood fill, without the group post-processing
+std::vector<std::vector<Point2D>> FloodFillOld(
+	const std::vector<Point2D>& points, int map_width, int map_height,
+	float step, int max_distance_between_points) {
+	const unsigned int height = static_cast<unsigned int>(map_height / step);
+	const unsigned int width = static_cast<unsigned int>(map_width / step);
+
+	std::vector<Point2DI> nearby;
+	for (int dx = -max_distance_between_points;
+		dx <= max_distance_between_points; ++dx) {
+		for (int dy = -max_distance_between_points;
+			dy <= max_distance_between_points; ++dy) {
+			if (abs(dx) + abs(dy) <= max_distance_between_points) {
+				nearby.emplace_back(Point2DI(dx, dy));
+			}
+		}
+	}
+
+	std::vector<std::vector<Point2D>> groups;
+	std::vector<Point2D> remaining(points.begin(), points.end());
+	std::deque<Point2D> queue;
+	while (!remaining.empty()) {
+		std::vector<Point2D> currentGroup;
+		auto start = remaining.back();
+		remaining.pop_back();
+		queue.emplace_back(start);
+		currentGroup.emplace_back(start);
+		while (!queue.empty()) {
+			Point2D base = queue.front();
+			queue.pop_front();
+			for (const auto& offset : nearby) {
+				float px = base.x + offset.x * step;
+				float py = base.y + offset.y * step;
+				if (px < 0 || py < 0 || px >= width * step ||
+					py >= height * step) {
+					continue;
+				}
+				Point2D point(px, py);
+				auto it = std::find(remaining.begin(), remaining.end(), point);
+				if (it != remaining.end()) {
+					remaining.erase(it);
+					queue.emplace_back(point);
+					currentGroup.emplace_back(point);
+				}
+			}
+		}
+		groups.emplace_back(currentGroup);
+	}
+	return groups;
+}
+
+// find_groups' offsets: manhattan distance in steps, whole cells only
+std::vector<Point2DI> CellOffsets(float step, int max_distance) {
+	std::vector<Point2DI> offsets;
+	for (int dx = -max_distance; dx <= max_distance; ++dx) {
+		for (int dy = -max_distance; dy <= max_distance; ++dy) {
+			float ox = dx * step;
+			float oy = dy * step;
+			if (abs(dx) + abs(dy) <= max_distance && ox == std::floor(ox) &&
+				oy == std::floor(oy)) {
+				offsets.emplace_back(
+					Point2DI(static_cast<int>(ox), static_cast<int>(oy)));
+			}
+		}
+	}
+	return offsets;
+}
+
+void BenchGroups(std::vector<BenchResult>& results, const MapSize& map,
+	const char* kind, const std::vector<Point2D>& points, float step) {
+	const std::vector<Point2DI> offsets = CellOffsets(step, 2);
+	std::string name = std::string("find_groups/") + map.name + "/" + kind;
+
+	// The flood fill takes seconds on a full map, so it is timed only once
+	std::vector<std::vector<Point2D>> old_groups;
+	std::vector<std::vector<Point2D>> new_groups;
+	results.push_back(RunBenchmark(name + "/flood_fill", points.size(), [&]() {
+		old_groups = FloodFillOld(points, map.width, map.height, step, 2);
+		}, 0.0));
+	results.push_back(RunBenchmark(name + "/labeling", points.size(), [&]() {
+		new_groups = LabelGroups(points, map.width, map.height, offsets);
+		DoNotOptimize(new_groups.data());
+		}));
+
+	if (old_groups != new_groups) {
+		std::fprintf(stderr,
+			"find_groups: labeling and flood fill differ for %s %s\n",
+			map.name, kind);
+	}
+}
+}
+
+void BenchFindGroups(std::vector<BenchResult>& results) {
+	for (const auto& map : bench_maps) {
+		std::vector<Point2D> placable;
+		std::vector<Point2D> ramp;
+		MakeCells(map, map.width + map.height, placable, ramp);
+
+		// Same steps as find_ramps_build_map: 0.5 for build maps, 1 for ramps
+		BenchGroups(results, map, "build_map", placable, 0.5f);
+		BenchGroups(results, map, "ramps", ramp, 1.0f);
+	}
+}
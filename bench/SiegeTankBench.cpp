@@ -0,0 +1,30 @@
+#include "BotBench.h"
+
+using namespace sc2;
+
+// BasicSc2Bot::TargetSiegeTank: four sieged tanks looking at a ball of units
+void BenchSiegeTankTargeting(std::vector<BenchResult>& results) {
+	const BenchMap map = MakeMap(bench_maps[1]);
+	const Point2D battle(50.0f, 40.0f);
+
+	for (size_t n : { 50, 100, 200 }) {
+		std::vector<Unit> units =
+			MakeClumpedUnits(n, battle, static_cast<uint32_t>(7 + n));
+		for (int i = 0; i < 4; ++i) {
+			units.push_back(OwnUnit(0x10000 + i,
+				UNIT_TYPEID::TERRAN_SIEGETANKSIEGED,
+				battle + Point2D(-10.0f + 2.0f * i, -10.0f)));
+		}
+		BenchGame game(map.game_info, map.start_location, units);
+		BasicSc2Bot bot;
+		game.Attach(bot, map.start_location);
+
+		// The enemy grid is built once per game loop and the gateway drops
+		// repeats within a game loop, so after the first run this is the
+		// packed counts and the scoring
+		results.push_back(RunBenchmark("TargetSiegeTank", n, [&]() {
+			BotBenchAccess::TargetSiegeTank(bot);
+			game.Actions().TakeCommands();
+			}));
+	}
+}
@@ -0,0 +1,105 @@
+#include "BotBench.h"
+
+#include "sc2api/sc2_map_info.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace sc2;
+
+// Terrain height lookups done by on_start: every ramp group is sorted by
+// height in find_groups, then scanned by upper_lower
+namespace {
+// A few plateaus of different height with ramps between them
+GameInfo MakeGameInfo(const MapSize& map, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> level(0, 3);
+	GameInfo info;
+	info.width = map.width;
+	info.height = map.height;
+	info.terrain_height.width = map.width;
+	info.terrain_height.height = map.height;
+	info.terrain_height.bits_per_pixel = 8;
+	info.terrain_height.data.resize(static_cast<size_t>(map.width) * map.height);
+	for (int y = 0; y < map.height; ++y) {
+		for (int x = 0; x < map.width; ++x) {
+			int plateau = (x / 32 + y / 32) % 4;
+			info.terrain_height.data[y * map.width + x] =
+				static_cast<char>(140 + 12 * plateau + (level(rng) == 0));
+		}
+	}
+	return info;
+}
+
+// Twenty ramp-sized groups of cells
+std::vector<std::vector<Point2D>> MakeRamps(const MapSize& map, uint32_t seed) {
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> x_dist(4, map.width - 12);
+	std::uniform_int_distribution<int> y_dist(4, map.height - 12);
+	std::vector<std::vector<Point2D>> ramps(20);
+	for (auto& ramp : ramps) {
+		int x0 = x_dist(rng);
+		int y0 = y_dist(rng);
+		for (int dx = 0; dx < 8; ++dx) {
+			for (int dy = 0; dy < 5; ++dy) {
+				ramp.emplace_back(float(x0 + dx), float(y0 + dy));
+			}
+		}
+		std::shuffle(ramp.begin(), ramp.end(), rng);
+	}
+	return ramps;
+}
+
+// The old height_at: a new HeightMap (copy of the image) per lookup
+int HeightPerCall(const GameInfo& info, const Point2D& p) {
+	HeightMap h_map(info);
+	return static_cast<int>(h_map.TerrainHeight(Point2DI(p)));
+}
+
+// Sort every ramp by height and count the cells at the top, like on_start
+template <typename HeightAt>
+size_t SortAndScan(std::vector<std::vector<Point2D>> ramps, HeightAt height_at) {
+	size_t top = 0;
+	for (auto& ramp : ramps) {
+		std::sort(ramp.begin(), ramp.end(),
+			[&height_at](const Point2D& a, const Point2D& b) {
+				return height_at(a) > height_at(b);
+			});
+		int height = height_at(ramp[0]);
+		for (const auto& p : ramp) {
+			if (height_at(p) == height) {
+				++top;
+			}
+		}
+	}
+	return top;
+}
+}
+
+void BenchTerrainHeight(std::vector<BenchResult>& results) {
+	for (const auto& map : bench_maps) {
+		GameInfo info = MakeGameInfo(map, map.width);
+		std::vector<std::vector<Point2D>> ramps = MakeRamps(map, map.height);
+		size_t cells = static_cast<size_t>(map.width) * map.height;
+		std::string name = std::string("on_start heights/") + map.name;
+
+		results.push_back(RunBenchmark(name + "/per_call", cells, [&]() {
+			size_t top = SortAndScan(ramps, [&info](const Point2D& p) {
+				return HeightPerCall(info, p);
+				});
+			DoNotOptimize(&top);
+			}));
+		// The bot's decode_terrain_height, then its height_at
+		const Point2D start(16.5f, 16.5f);
+		BenchGame game(info, start, {});
+		BasicSc2Bot bot;
+		game.Attach(bot, start);
+		results.push_back(RunBenchmark(name + "/decoded", cells, [&]() {
+			BotBenchAccess::DecodeTerrainHeight(bot);
+			size_t top = SortAndScan(ramps, [&bot](const Point2D& p) {
+				return BotBenchAccess::HeightAt(bot, p);
+				});
+			DoNotOptimize(&top);
+			}));
+	}
+}
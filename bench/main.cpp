@@ -0,0 +1,43 @@
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Micro benchmarks for the per-frame bot code, no game needed.
+// Usage: UEDBot_bench [--json <file>], "-" writes the JSON to stdout
+int main(int argc, char* argv[]) {
+	const char* json_path = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			json_path = argv[++i];
+		}
+		else {
+			std::fprintf(stderr, "Usage: %s [--json <file>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<BenchResult> results;
+
+	BenchSiegeTankTargeting(results);
+	BenchTerrainHeight(results);
+	BenchFindGroups(results);
+	BenchBotKernels(results);
+
+	if (!json_path) {
+		PrintResults(results);
+		return 0;
+	}
+	bool to_stdout = std::strcmp(json_path, "-") == 0;
+	std::FILE* out = to_stdout ? stdout : std::fopen(json_path, "w");
+	if (!out) {
+		std::fprintf(stderr, "Can't write %s\n", json_path);
+		return 1;
+	}
+	WriteJson(results, out);
+	if (!to_stdout) {
+		std::fclose(out);
+		PrintResults(results);
+	}
+	return 0;
+}
@@ -5,6 +5,7 @@
 #include "sc2utils/sc2_arg_parser.h"
 
 #include "BasicSc2Bot.h"
+#include "GameRecording.h"
 #include "LadderInterface.h"
 
 // LadderInterface allows the bot to be tested against the built-in AI or
@@ -0,0 +1,26 @@
+#ifndef FRAME_SOURCE_H_
+#define FRAME_SOURCE_H_
+
+#include "OfflineInterfaces.h"
+
+#include "sc2api/sc2_gametypes.h"
+
+#include <vector>
+
+// Where an offline game gets its frames from
+class FrameSource {
+public:
+	virtual ~FrameSource() {}
+
+	virtual const sc2::GameInfo& Info() const = 0;
+	virtual sc2::Point3D StartLocation() const = 0;
+
+	// Fills the next frame, false once the game is over
+	virtual bool Next(OfflineFrame& frame) = 0;
+
+	// Commands the bot sent for the last frame. Sources that replay fixed
+	// frames ignore them.
+	virtual void Apply(const std::vector<OfflineCommand>&) {}
+};
+
+#endif
@@ -0,0 +1,324 @@
+#include "OfflineData.h"
+
+#include <unordered_map>
+
+using namespace sc2;
+
+namespace {
+const float loops_per_second = 22.4f;
+
+// Per second values from the faster game speed, converted below
+struct Row {
+	UNIT_TYPEID type;
+	int minerals;
+	int vespene;
+	float food_used;
+	float food_provided;
+	float build_seconds;
+	float radius;
+	int footprint;
+	float speed;
+	float health;
+	float dps;
+	float range;
+	bool flying;
+	std::vector<Attribute> attributes;
+};
+
+std::vector<OfflineUnitInfo> BuildTable() {
+	const Attribute light = Attribute::Light;
+	const Attribute armored = Attribute::Armored;
+	const Attribute bio = Attribute::Biological;
+	const Attribute mech = Attribute::Mechanical;
+	const Attribute massive = Attribute::Massive;
+	const Attribute structure = Attribute::Structure;
+
+	const std::vector<Row> rows = {
+		// Terran units
+		{ UNIT_TYPEID::TERRAN_SCV, 50, 0, 1, 0, 12, 0.375f, 0, 3.94f, 45, 4.7f, 0.1f, false, { light, bio, mech } },
+		{ UNIT_TYPEID::TERRAN_MULE, 0, 0, 0, 0, 0, 0.375f, 0, 3.94f, 60, 0, 0, false, { light, mech } },
+		{ UNIT_TYPEID::TERRAN_MARINE, 50, 0, 1, 0, 18, 0.375f, 0, 3.15f, 45, 9.8f, 5, false, { light, bio } },
+		{ UNIT_TYPEID::TERRAN_SIEGETANK, 150, 125, 3, 0, 32, 0.875f, 0, 3.15f, 175, 20.2f, 7, false, { armored, mech } },
+		{ UNIT_TYPEID::TERRAN_SIEGETANKSIEGED, 150, 125, 3, 0, 32, 0.875f, 0, 0, 175, 40.0f, 13, false, { armored, mech } },
+		{ UNIT_TYPEID::TERRAN_BATTLECRUISER, 400, 300, 6, 0, 64, 1.25f, 0, 2.62f, 550, 50.0f, 6, true, { armored, mech, massive } },
+
+		// Terran structures
+		{ UNIT_TYPEID::TERRAN_COMMANDCENTER, 400, 0, 0, 15, 71, 2.75f, 5, 0, 1500, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING, 400, 0, 0, 15, 71, 2.75f, 5, 0.94f, 1500, 0, 0, true, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_ORBITALCOMMAND, 150, 0, 0, 15, 25, 2.75f, 5, 0, 1500, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_PLANETARYFORTRESS, 150, 150, 0, 15, 36, 2.75f, 5, 0, 1500, 20.0f, 6, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_SUPPLYDEPOT, 100, 0, 0, 8, 21, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED, 100, 0, 0, 8, 21, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_REFINERY, 75, 0, 0, 0, 21, 1.5f, 3, 0, 500, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_BARRACKS, 150, 0, 0, 0, 46, 1.5f, 3, 0, 1000, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_BARRACKSFLYING, 150, 0, 0, 0, 46, 1.5f, 3, 0.94f, 1000, 0, 0, true, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_FACTORY, 150, 100, 0, 0, 43, 1.5f, 3, 0, 1250, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_FACTORYFLYING, 150, 100, 0, 0, 43, 1.5f, 3, 0.94f, 1250, 0, 0, true, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_STARPORT, 150, 100, 0, 0, 36, 1.5f, 3, 0, 1300, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_STARPORTFLYING, 150, 100, 0, 0, 36, 1.5f, 3, 0.94f, 1300, 0, 0, true, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_ENGINEERINGBAY, 125, 0, 0, 0, 25, 1.5f, 3, 0, 850, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_ARMORY, 150, 100, 0, 0, 46, 1.5f, 3, 0, 750, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_FUSIONCORE, 150, 150, 0, 0, 46, 1.5f, 3, 0, 750, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_BUNKER, 100, 0, 0, 0, 29, 1.5f, 3, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_MISSILETURRET, 100, 0, 0, 0, 18, 1.0f, 2, 0, 250, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_BARRACKSTECHLAB, 50, 25, 0, 0, 18, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_BARRACKSREACTOR, 50, 50, 0, 0, 36, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_FACTORYTECHLAB, 50, 25, 0, 0, 18, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_FACTORYREACTOR, 50, 50, 0, 0, 36, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_STARPORTTECHLAB, 50, 25, 0, 0, 18, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+		{ UNIT_TYPEID::TERRAN_STARPORTREACTOR, 50, 50, 0, 0, 36, 1.0f, 2, 0, 400, 0, 0, false, { armored, mech, structure } },
+
+		// The enemy of the synthetic game
+		{ UNIT_TYPEID::ZERG_ZERGLING, 25, 0, 0.5f, 0, 17, 0.375f, 0, 4.13f, 35, 10.0f, 0.1f, false, { light, bio } },
+		{ UNIT_TYPEID::ZERG_ROACH, 75, 25, 2, 0, 19, 0.625f, 0, 3.15f, 145, 11.2f, 4, false, { armored, bio } },
+		{ UNIT_TYPEID::ZERG_HATCHERY, 300, 0, 0, 6, 71, 2.75f, 5, 0, 1500, 0, 0, false, { armored, bio, structure } },
+
+		// Resources
+		{ UNIT_TYPEID::NEUTRAL_MINERALFIELD, 0, 0, 0, 0, 0, 1.125f, 0, 0, 0, 0, 0, false, {} },
+		{ UNIT_TYPEID::NEUTRAL_VESPENEGEYSER, 0, 0, 0, 0, 0, 1.5f, 3, 0, 0, 0, 0, false, {} },
+	};
+
+	std::vector<OfflineUnitInfo> table;
+	for (const auto& row : rows) {
+		OfflineUnitInfo info;
+		info.type = row.type;
+		info.minerals = row.minerals;
+		info.vespene = row.vespene;
+		info.food_used = row.food_used;
+		info.food_provided = row.food_provided;
+		info.build_loops =
+			static_cast<uint32_t>(row.build_seconds * loops_per_second);
+		info.radius = row.radius;
+		info.footprint = row.footprint;
+		info.speed = row.speed / loops_per_second;
+		info.health = row.health;
+		info.damage = row.dps / loops_per_second;
+		info.range = row.range;
+		info.flying = row.flying;
+		info.attributes = row.attributes;
+		table.push_back(info);
+	}
+	return table;
+}
+
+const std::vector<OfflineUnitInfo>& Table() {
+	static const std::vector<OfflineUnitInfo> table = BuildTable();
+	return table;
+}
+
+const std::unordered_map<uint32_t, uint32_t>& GenericAbilities() {
+	static const std::unordered_map<uint32_t, uint32_t> generic = {
+		{ static_cast<uint32_t>(ABILITY_ID::MOVE_MOVE),
+			static_cast<uint32_t>(ABILITY_ID::MOVE) },
+		{ static_cast<uint32_t>(ABILITY_ID::ATTACK_ATTACK),
+			static_cast<uint32_t>(ABILITY_ID::ATTACK) },
+		{ static_cast<uint32_t>(ABILITY_ID::STOP_STOP),
+			static_cast<uint32_t>(ABILITY_ID::STOP) },
+		{ static_cast<uint32_t>(ABILITY_ID::HARVEST_GATHER_SCV),
+			static_cast<uint32_t>(ABILITY_ID::HARVEST_GATHER) },
+		{ static_cast<uint32_t>(ABILITY_ID::HARVEST_RETURN_SCV),
+			static_cast<uint32_t>(ABILITY_ID::HARVEST_RETURN) },
+		{ static_cast<uint32_t>(ABILITY_ID::HARVEST_GATHER_MULE),
+			static_cast<uint32_t>(ABILITY_ID::HARVEST_GATHER) },
+		{ static_cast<uint32_t>(ABILITY_ID::HARVEST_RETURN_MULE),
+			static_cast<uint32_t>(ABILITY_ID::HARVEST_RETURN) },
+		{ static_cast<uint32_t>(ABILITY_ID::EFFECT_REPAIR_SCV),
+			static_cast<uint32_t>(ABILITY_ID::EFFECT_REPAIR) },
+		{ static_cast<uint32_t>(ABILITY_ID::EFFECT_REPAIR_MULE),
+			static_cast<uint32_t>(ABILITY_ID::EFFECT_REPAIR) },
+		{ static_cast<uint32_t>(ABILITY_ID::BUILD_TECHLAB_BARRACKS),
+			static_cast<uint32_t>(ABILITY_ID::BUILD_TECHLAB) },
+	};
+	return generic;
+}
+}
+
+const OfflineUnitInfo* FindUnitInfo(UnitTypeID type) {
+	for (const auto& info : Table()) {
+		if (info.type == type) {
+			return &info;
+		}
+	}
+	return nullptr;
+}
+
+uint32_t GenericAbility(AbilityID ability) {
+	uint32_t id = static_cast<uint32_t>(ability);
+	auto it = GenericAbilities().find(id);
+	return it != GenericAbilities().end() ? it->second : id;
+}
+
+uint32_t OrderAbility(AbilityID ability, UnitTypeID unit_type) {
+	bool mule = unit_type == UNIT_TYPEID::TERRAN_MULE;
+	ABILITY_ID specific = static_cast<ABILITY_ID>(GenericAbility(ability));
+	switch (specific) {
+	case ABILITY_ID::MOVE:
+		specific = ABILITY_ID::MOVE_MOVE;
+		break;
+	case ABILITY_ID::ATTACK:
+		specific = ABILITY_ID::ATTACK_ATTACK;
+		break;
+	case ABILITY_ID::STOP:
+		specific = ABILITY_ID::STOP_STOP;
+		break;
+	case ABILITY_ID::HARVEST_GATHER:
+		specific = mule ? ABILITY_ID::HARVEST_GATHER_MULE
+			: ABILITY_ID::HARVEST_GATHER_SCV;
+		break;
+	case ABILITY_ID::HARVEST_RETURN:
+		specific = mule ? ABILITY_ID::HARVEST_RETURN_MULE
+			: ABILITY_ID::HARVEST_RETURN_SCV;
+		break;
+	case ABILITY_ID::EFFECT_REPAIR:
+		specific = mule ? ABILITY_ID::EFFECT_REPAIR_MULE
+			: ABILITY_ID::EFFECT_REPAIR_SCV;
+		break;
+	default:
+		// Other orders keep the ability they were given with
+		return static_cast<uint32_t>(ability);
+	}
+	return static_cast<uint32_t>(specific);
+}
+
+UNIT_TYPEID ProducedType(AbilityID ability) {
+	switch (static_cast<ABILITY_ID>(GenericAbility(ability))) {
+	case ABILITY_ID::TRAIN_SCV:
+		return UNIT_TYPEID::TERRAN_SCV;
+	case ABILITY_ID::TRAIN_MARINE:
+		return UNIT_TYPEID::TERRAN_MARINE;
+	case ABILITY_ID::TRAIN_SIEGETANK:
+		return UNIT_TYPEID::TERRAN_SIEGETANK;
+	case ABILITY_ID::TRAIN_BATTLECRUISER:
+		return UNIT_TYPEID::TERRAN_BATTLECRUISER;
+	case ABILITY_ID::BUILD_COMMANDCENTER:
+		return UNIT_TYPEID::TERRAN_COMMANDCENTER;
+	case ABILITY_ID::BUILD_SUPPLYDEPOT:
+		return UNIT_TYPEID::TERRAN_SUPPLYDEPOT;
+	case ABILITY_ID::BUILD_REFINERY:
+		return UNIT_TYPEID::TERRAN_REFINERY;
+	case ABILITY_ID::BUILD_BARRACKS:
+		return UNIT_TYPEID::TERRAN_BARRACKS;
+	case ABILITY_ID::BUILD_ENGINEERINGBAY:
+		return UNIT_TYPEID::TERRAN_ENGINEERINGBAY;
+	case ABILITY_ID::BUILD_MISSILETURRET:
+		return UNIT_TYPEID::TERRAN_MISSILETURRET;
+	case ABILITY_ID::BUILD_BUNKER:
+		return UNIT_TYPEID::TERRAN_BUNKER;
+	case ABILITY_ID::BUILD_FACTORY:
+		return UNIT_TYPEID::TERRAN_FACTORY;
+	case ABILITY_ID::BUILD_STARPORT:
+		return UNIT_TYPEID::TERRAN_STARPORT;
+	case ABILITY_ID::BUILD_ARMORY:
+		return UNIT_TYPEID::TERRAN_ARMORY;
+	case ABILITY_ID::BUILD_FUSIONCORE:
+		return UNIT_TYPEID::TERRAN_FUSIONCORE;
+	case ABILITY_ID::MORPH_ORBITALCOMMAND:
+		return UNIT_TYPEID::TERRAN_ORBITALCOMMAND;
+	default:
+		return UNIT_TYPEID::INVALID;
+	}
+}
+
+UNIT_TYPEID AddonType(UnitTypeID parent, bool reactor) {
+	switch (parent.ToType()) {
+	case UNIT_TYPEID::TERRAN_BARRACKS:
+		return reactor ? UNIT_TYPEID::TERRAN_BARRACKSREACTOR
+			: UNIT_TYPEID::TERRAN_BARRACKSTECHLAB;
+	case UNIT_TYPEID::TERRAN_FACTORY:
+		return reactor ? UNIT_TYPEID::TERRAN_FACTORYREACTOR
+			: UNIT_TYPEID::TERRAN_FACTORYTECHLAB;
+	case UNIT_TYPEID::TERRAN_STARPORT:
+		return reactor ? UNIT_TYPEID::TERRAN_STARPORTREACTOR
+			: UNIT_TYPEID::TERRAN_STARPORTTECHLAB;
+	default:
+		return UNIT_TYPEID::INVALID;
+	}
+}
+
+UNIT_TYPEID FlyingType(UnitTypeID landed) {
+	switch (landed.ToType()) {
+	case UNIT_TYPEID::TERRAN_COMMANDCENTER:
+		return UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING;
+	case UNIT_TYPEID::TERRAN_BARRACKS:
+		return UNIT_TYPEID::TERRAN_BARRACKSFLYING;
+	case UNIT_TYPEID::TERRAN_FACTORY:
+		return UNIT_TYPEID::TERRAN_FACTORYFLYING;
+	case UNIT_TYPEID::TERRAN_STARPORT:
+		return UNIT_TYPEID::TERRAN_STARPORTFLYING;
+	default:
+		return UNIT_TYPEID::INVALID;
+	}
+}
+
+UNIT_TYPEID LandedType(UnitTypeID flying) {
+	switch (flying.ToType()) {
+	case UNIT_TYPEID::TERRAN_COMMANDCENTERFLYING:
+		return UNIT_TYPEID::TERRAN_COMMANDCENTER;
+	case UNIT_TYPEID::TERRAN_BARRACKSFLYING:
+		return UNIT_TYPEID::TERRAN_BARRACKS;
+	case UNIT_TYPEID::TERRAN_FACTORYFLYING:
+		return UNIT_TYPEID::TERRAN_FACTORY;
+	case UNIT_TYPEID::TERRAN_STARPORTFLYING:
+		return UNIT_TYPEID::TERRAN_STARPORT;
+	default:
+		return UNIT_TYPEID::INVALID;
+	}
+}
+
+UPGRADE_ID ResearchedUpgrade(AbilityID ability) {
+	switch (static_cast<ABILITY_ID>(GenericAbility(ability))) {
+	case ABILITY_ID::RESEARCH_COMBATSHIELD:
+		return UPGRADE_ID::COMBATSHIELD;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONSLEVEL1:
+		return UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL1;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONSLEVEL2:
+		return UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL2;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYWEAPONSLEVEL3:
+		return UPGRADE_ID::TERRANINFANTRYWEAPONSLEVEL3;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL1:
+		return UPGRADE_ID::TERRANINFANTRYARMORSLEVEL1;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL2:
+		return UPGRADE_ID::TERRANINFANTRYARMORSLEVEL2;
+	case ABILITY_ID::RESEARCH_TERRANINFANTRYARMORLEVEL3:
+		return UPGRADE_ID::TERRANINFANTRYARMORSLEVEL3;
+	case ABILITY_ID::RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL1:
+		return UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL1;
+	case ABILITY_ID::RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL2:
+		return UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL2;
+	case ABILITY_ID::RESEARCH_TERRANVEHICLEANDSHIPPLATINGLEVEL3:
+		return UPGRADE_ID::TERRANVEHICLEANDSHIPARMORSLEVEL3;
+	default:
+		return UPGRADE_ID::INVALID;
+	}
+}
+
+UnitTypes MakeUnitTypeData() {
+	UnitTypes types(2048);
+	for (size_t i = 0; i < types.size(); ++i) {
+		types[i].unit_type_id = UnitTypeID(static_cast<uint32_t>(i));
+	}
+	for (const auto& info : Table()) {
+		UnitTypeData& data = types[static_cast<uint32_t>(info.type)];
+		data.name = UnitTypeToName(info.type);
+		data.available = true;
+		data.mineral_cost = info.minerals;
+		data.vespene_cost = info.vespene;
+		data.food_required = info.food_used;
+		data.food_provided = info.food_provided;
+		data.build_time = static_cast<float>(info.build_loops);
+		data.movement_speed = info.speed * loops_per_second;
+		data.attributes = info.attributes;
+	}
+	return types;
+}
+
+Abilities MakeAbilityData() {
+	Abilities abilities(4096);
+	for (size_t i = 0; i < abilities.size(); ++i) {
+		abilities[i].ability_id = AbilityID(static_cast<uint32_t>(i));
+	}
+	for (const auto& generic : GenericAbilities()) {
+		abilities[generic.first].remaps_to_ability_id = generic.second;
+	}
+	return abilities;
+}
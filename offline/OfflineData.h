@@ -0,0 +1,60 @@
+#ifndef OFFLINE_DATA_H_
+#define OFFLINE_DATA_H_
+
+#include "sc2api/sc2_data.h"
+#include "sc2api/sc2_typeenums.h"
+
+#include <cstdint>
+#include <vector>
+
+// Unit and ability data for offline runs, in place of what the game sends.
+// Only covers what the synthetic game uses; times are in game loops at
+// faster speed, distances in cells.
+struct OfflineUnitInfo {
+	sc2::UNIT_TYPEID type;
+	int minerals;
+	int vespene;
+	float food_used;
+	float food_provided;
+	uint32_t build_loops;
+	float radius;
+	// Side of the square footprint in cells, 0 for units
+	int footprint;
+	float speed;
+	float health;
+	// Damage per game loop and range of the weapon, 0 for none
+	float damage;
+	float range;
+	bool flying;
+	std::vector<sc2::Attribute> attributes;
+};
+
+// nullptr for types the table doesn't know
+const OfflineUnitInfo* FindUnitInfo(sc2::UnitTypeID type);
+
+// Generic ability for a specific one (MOVE for MOVE_MOVE, ...)
+uint32_t GenericAbility(sc2::AbilityID ability);
+
+// Specific ability the game reports in the unit's orders for a generic one
+// (HARVEST_GATHER_SCV for an SCV's HARVEST_GATHER, ...)
+uint32_t OrderAbility(sc2::AbilityID ability, sc2::UnitTypeID unit_type);
+
+// Unit made by a train, build or morph ability, INVALID for other abilities.
+// Add-ons depend on the structure, see AddonType.
+sc2::UNIT_TYPEID ProducedType(sc2::AbilityID ability);
+
+// Tech lab or reactor for this production structure, INVALID if it has none
+sc2::UNIT_TYPEID AddonType(sc2::UnitTypeID parent, bool reactor);
+
+// Flying and landed form of a structure that can lift, INVALID if none
+sc2::UNIT_TYPEID FlyingType(sc2::UnitTypeID landed);
+sc2::UNIT_TYPEID LandedType(sc2::UnitTypeID flying);
+
+// Upgrade finished by a research ability, INVALID for other abilities
+sc2::UPGRADE_ID ResearchedUpgrade(sc2::AbilityID ability);
+
+// Indexed by unit type id and ability id, like the game's data
+sc2::UnitTypes MakeUnitTypeData();
+sc2::Abilities MakeAbilityData();
+
+#endif
@@ -0,0 +1,76 @@
+#include "OfflineHarness.h"
+
+#include "OfflineInterfaces.h"
+
+#include "BasicSc2Bot.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace sc2;
+
+namespace {
+// Same order as the client's event dispatch
+void DispatchEvents(BasicSc2Bot& bot, const OfflineEvents& events) {
+	for (const Unit* unit : events.destroyed) {
+		bot.OnUnitDestroyed(unit);
+	}
+	for (const Unit* unit : events.created) {
+		bot.OnUnitCreated(unit);
+	}
+	for (const Unit* unit : events.idle) {
+		bot.OnUnitIdle(unit);
+	}
+	for (const UpgradeID& upgrade : events.upgrades) {
+		bot.OnUpgradeCompleted(upgrade);
+	}
+	for (const Unit* unit : events.completed) {
+		bot.OnBuildingConstructionComplete(unit);
+	}
+	for (const Unit* unit : events.entered_vision) {
+		bot.OnUnitEnterVision(unit);
+	}
+}
+}
+
+OfflineRunResult RunOffline(BasicSc2Bot& bot, FrameSource& source,
+	uint32_t max_steps) {
+	OfflineRunResult run;
+	OfflineFrame frame;
+	if (!source.Next(frame)) {
+		return run;
+	}
+
+	OfflineObservation observation(source.Info(), source.StartLocation());
+	OfflineQuery query(observation);
+	OfflineActions actions;
+	bot.UseInterfaces(&observation, &query, &actions);
+
+	OfflineEvents events = observation.Update(frame);
+	bot.OnGameStart();
+	while (frame.results.empty()) {
+		DispatchEvents(bot, events);
+
+		auto start = std::chrono::steady_clock::now();
+		bot.OnStep();
+		uint64_t us = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - start).count());
+		run.step_us_total += us;
+		run.step_us_max = std::max(run.step_us_max, us);
+		++run.steps;
+
+		source.Apply(actions.TakeCommands());
+		if ((max_steps && run.steps >= max_steps) || !source.Next(frame)) {
+			break;
+		}
+		events = observation.Update(frame);
+	}
+	bot.OnGameEnd();
+
+	run.last_game_loop = observation.GetGameLoop();
+	run.commands = actions.Sent();
+	run.results = observation.GetResults();
+	bot.UseInterfaces(nullptr, nullptr, nullptr);
+	return run;
+}
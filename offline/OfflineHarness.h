@@ -0,0 +1,31 @@
+#ifndef OFFLINE_HARNESS_H_
+#define OFFLINE_HARNESS_H_
+
+#include "FrameSource.h"
+
+#include "sc2api/sc2_gametypes.h"
+
+#include <cstdint>
+#include <vector>
+
+class BasicSc2Bot;
+
+// What an offline game did
+struct OfflineRunResult {
+	uint32_t steps = 0;
+	uint32_t last_game_loop = 0;
+	// Time spent in OnStep, in microseconds
+	uint64_t step_us_total = 0;
+	uint64_t step_us_max = 0;
+	size_t commands = 0;
+	std::vector<sc2::PlayerResult> results;
+};
+
+// Plays one game of a frame source through the bot, calling the bot the way
+// the client does: OnGameStart, then per frame the unit callbacks and OnStep,
+// and OnGameEnd at the end. Stops early after max_steps steps (0 for no
+// limit).
+OfflineRunResult RunOffline(BasicSc2Bot& bot, FrameSource& source,
+	uint32_t max_steps = 0);
+
+#endif
@@ -0,0 +1,505 @@
+#include "OfflineInterfaces.h"
+
+#include "OfflineData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+using namespace sc2;
+
+namespace {
+// Keeps the town hall clear of its resources, like the game does
+const float town_hall_resource_distance = 6.0f;
+
+bool IsTownHallType(UnitTypeID type) {
+	return type == UNIT_TYPEID::TERRAN_COMMANDCENTER ||
+		type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND ||
+		type == UNIT_TYPEID::TERRAN_PLANETARYFORTRESS ||
+		type == UNIT_TYPEID::ZERG_HATCHERY;
+}
+
+bool IsResource(UnitTypeID type) {
+	return type == UNIT_TYPEID::NEUTRAL_MINERALFIELD ||
+		type == UNIT_TYPEID::NEUTRAL_MINERALFIELD750 ||
+		type == UNIT_TYPEID::NEUTRAL_VESPENEGEYSER;
+}
+
+// Whether the unit covers the cell on the ground
+bool Covers(const Unit& unit, int x, int y) {
+	if (unit.is_flying) {
+		return false;
+	}
+	if (unit.unit_type == UNIT_TYPEID::NEUTRAL_MINERALFIELD ||
+		unit.unit_type == UNIT_TYPEID::NEUTRAL_MINERALFIELD750) {
+		// 2x1, centred on the line between the two cells
+		int left = static_cast<int>(std::floor(unit.pos.x)) - 1;
+		return y == static_cast<int>(std::floor(unit.pos.y)) &&
+			x >= left && x < left + 2;
+	}
+	const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type);
+	if (!info || !info->footprint) {
+		return false;
+	}
+	float half = info->footprint / 2.0f;
+	int left = static_cast<int>(std::floor(unit.pos.x - half + 0.5f));
+	int bottom = static_cast<int>(std::floor(unit.pos.y - half + 0.5f));
+	return x >= left && x < left + info->footprint && y >= bottom &&
+		y < bottom + info->footprint;
+}
+}
+
+OfflineObservation::OfflineObservation(const GameInfo& info,
+	const Point3D& start)
+	: game_info(info), start_location(start),
+	unit_types(MakeUnitTypeData()), abilities(MakeAbilityData()) {}
+
+OfflineEvents OfflineObservation::Update(const OfflineFrame& frame) {
+	OfflineEvents events;
+	game_loop = frame.game_loop;
+	minerals = frame.minerals;
+	vespene = frame.vespene;
+	food_used = frame.food_used;
+	food_cap = frame.food_cap;
+	results = frame.results;
+
+	for (const auto& upgrade : frame.upgrades) {
+		if (std::find(upgrades.begin(), upgrades.end(), upgrade) ==
+			upgrades.end()) {
+			events.upgrades.push_back(upgrade);
+		}
+	}
+	upgrades = frame.upgrades;
+
+	// Units missing from the frame are out of sight, not dead; their objects
+	// stay for the bot and only the frame's dead units are destroyed
+	std::unordered_set<Tag> was_visible;
+	for (const Unit* unit : units) {
+		was_visible.insert(unit->tag);
+	}
+	units.clear();
+	for (const auto& state : frame.units) {
+		std::unique_ptr<Unit>& slot = unit_pool[state.tag];
+		bool is_new = !slot || !slot->is_alive;
+		if (!slot) {
+			slot.reset(new Unit());
+		}
+		bool had_orders = !slot->orders.empty();
+		float old_progress = slot->build_progress;
+
+		*slot = state;
+		slot->is_alive = true;
+		slot->last_seen_game_loop = game_loop;
+		units.push_back(slot.get());
+
+		if (first_frame) {
+			continue;
+		}
+		const Unit* unit = slot.get();
+		if (unit->alliance == Unit::Alliance::Self) {
+			if (is_new) {
+				events.created.push_back(unit);
+			}
+			if (unit->orders.empty() && (is_new || had_orders)) {
+				events.idle.push_back(unit);
+			}
+			if (!is_new && old_progress < 1.0f && unit->build_progress >= 1.0f) {
+				events.completed.push_back(unit);
+			}
+		}
+		else if (unit->alliance == Unit::Alliance::Enemy &&
+			!was_visible.count(unit->tag)) {
+			events.entered_vision.push_back(unit);
+		}
+	}
+
+	for (Tag tag : frame.dead_units) {
+		auto it = unit_pool.find(tag);
+		if (it == unit_pool.end() || !it->second->is_alive) {
+			continue;
+		}
+		it->second->is_alive = false;
+		if (!first_frame) {
+			events.destroyed.push_back(it->second.get());
+		}
+	}
+	first_frame = false;
+	return events;
+}
+
+Units OfflineObservation::GetUnits() const {
+	return units;
+}
+
+Units OfflineObservation::GetUnits(Unit::Alliance alliance,
+	Filter filter) const {
+	Units selected;
+	for (const Unit* unit : units) {
+		if (unit->alliance == alliance && (!filter || filter(*unit))) {
+			selected.push_back(unit);
+		}
+	}
+	return selected;
+}
+
+Units OfflineObservation::GetUnits(Filter filter) const {
+	Units selected;
+	for (const Unit* unit : units) {
+		if (!filter || filter(*unit)) {
+			selected.push_back(unit);
+		}
+	}
+	return selected;
+}
+
+const Unit* OfflineObservation::GetUnit(Tag tag) const {
+	auto it = unit_pool.find(tag);
+	if (it == unit_pool.end() || !it->second->is_alive) {
+		return nullptr;
+	}
+	return it->second.get();
+}
+
+const RawActions& OfflineObservation::GetRawActions() const {
+	static const RawActions none;
+	return none;
+}
+
+const SpatialActions& OfflineObservation::GetFeatureLayerActions() const {
+	static const SpatialActions none;
+	return none;
+}
+
+const SpatialActions& OfflineObservation::GetRenderedActions() const {
+	static const SpatialActions none;
+	return none;
+}
+
+const std::vector<ChatMessage>& OfflineObservation::GetChatMessages() const {
+	static const std::vector<ChatMessage> none;
+	return none;
+}
+
+const std::vector<PowerSource>& OfflineObservation::GetPowerSources() const {
+	static const std::vector<PowerSource> none;
+	return none;
+}
+
+const std::vector<Effect>& OfflineObservation::GetEffects() const {
+	static const std::vector<Effect> none;
+	return none;
+}
+
+const std::vector<UpgradeID>& OfflineObservation::GetUpgrades() const {
+	return upgrades;
+}
+
+const Score& OfflineObservation::GetScore() const {
+	static const Score score{};
+	return score;
+}
+
+const Abilities& OfflineObservation::GetAbilityData(bool) const {
+	return abilities;
+}
+
+const UnitTypes& OfflineObservation::GetUnitTypeData(bool) const {
+	return unit_types;
+}
+
+const Upgrades& OfflineObservation::GetUpgradeData(bool) const {
+	static const Upgrades none;
+	return none;
+}
+
+const Buffs& OfflineObservation::GetBuffData(bool) const {
+	static const Buffs none;
+	return none;
+}
+
+const Effects& OfflineObservation::GetEffectData(bool) const {
+	static const Effects none;
+	return none;
+}
+
+int32_t OfflineObservation::GetFoodArmy() const {
+	return food_used - GetFoodWorkers();
+}
+
+int32_t OfflineObservation::GetFoodWorkers() const {
+	return static_cast<int32_t>(GetUnits(Unit::Alliance::Self,
+		IsUnit(UNIT_TYPEID::TERRAN_SCV)).size());
+}
+
+int32_t OfflineObservation::GetIdleWorkerCount() const {
+	return static_cast<int32_t>(GetUnits(Unit::Alliance::Self,
+		[](const Unit& unit) {
+			return unit.unit_type == UNIT_TYPEID::TERRAN_SCV &&
+				unit.orders.empty();
+		}).size());
+}
+
+int32_t OfflineObservation::GetArmyCount() const {
+	return static_cast<int32_t>(GetUnits(Unit::Alliance::Self,
+		[](const Unit& unit) {
+			const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type);
+			return info && !info->footprint &&
+				unit.unit_type != UNIT_TYPEID::TERRAN_SCV &&
+				unit.unit_type != UNIT_TYPEID::TERRAN_MULE;
+		}).size());
+}
+
+bool OfflineObservation::HasCreep(const Point2D&) const {
+	return false;
+}
+
+Visibility OfflineObservation::GetVisibility(const Point2D&) const {
+	return Visibility::Visible;
+}
+
+bool OfflineObservation::GridBit(const ImageData& grid,
+	const Point2D& point) const {
+	int x = static_cast<int>(point.x);
+	int y = static_cast<int>(point.y);
+	if (point.x < 0.0f || point.y < 0.0f || x >= grid.width ||
+		y >= grid.height) {
+		return false;
+	}
+	size_t index = static_cast<size_t>(x) +
+		static_cast<size_t>(grid.height - 1 - y) * grid.width;
+	unsigned char byte = static_cast<unsigned char>(grid.data[index / 8]);
+	return (byte >> (7 - index % 8)) & 1;
+}
+
+bool OfflineObservation::IsPathable(const Point2D& point) const {
+	return GridBit(game_info.pathing_grid, point);
+}
+
+bool OfflineObservation::IsPlacable(const Point2D& point) const {
+	return GridBit(game_info.placement_grid, point);
+}
+
+float OfflineObservation::TerrainHeight(const Point2D& point) const {
+	const ImageData& grid = game_info.terrain_height;
+	int x = static_cast<int>(point.x);
+	int y = static_cast<int>(point.y);
+	if (point.x < 0.0f || point.y < 0.0f || x >= grid.width ||
+		y >= grid.height) {
+		return 0.0f;
+	}
+	unsigned char byte =
+		static_cast<unsigned char>(grid.data[x + (grid.height - 1 - y) *
+			grid.width]);
+	return -100.0f + 200.0f * byte / 255.0f;
+}
+
+AvailableAbilities OfflineQuery::GetAbilitiesForUnit(const Unit* unit,
+	bool) {
+	AvailableAbilities available;
+	if (!unit) {
+		return available;
+	}
+	available.unit_tag = unit->tag;
+	available.unit_type_id = unit->unit_type;
+	auto add = [&available](ABILITY_ID ability) {
+		AvailableAbility entry;
+		entry.ability_id = ability;
+		available.abilities.push_back(entry);
+	};
+	switch (unit->unit_type.ToType()) {
+	case UNIT_TYPEID::TERRAN_BATTLECRUISER:
+		add(ABILITY_ID::ATTACK);
+		add(ABILITY_ID::MOVE);
+		add(ABILITY_ID::EFFECT_TACTICALJUMP);
+		break;
+	case UNIT_TYPEID::TERRAN_ORBITALCOMMAND:
+		if (unit->energy >= 50.0f) {
+			add(ABILITY_ID::EFFECT_CALLDOWNMULE);
+			add(ABILITY_ID::EFFECT_SCAN);
+		}
+		break;
+	default:
+		if (const OfflineUnitInfo* info = FindUnitInfo(unit->unit_type)) {
+			if (!info->footprint) {
+				add(ABILITY_ID::ATTACK);
+				add(ABILITY_ID::MOVE);
+			}
+		}
+		break;
+	}
+	return available;
+}
+
+std::vector<AvailableAbilities> OfflineQuery::GetAbilitiesForUnits(
+	const Units& units, bool ignore_resource_requirements) {
+	std::vector<AvailableAbilities> available;
+	for (const Unit* unit : units) {
+		available.push_back(
+			GetAbilitiesForUnit(unit, ignore_resource_requirements));
+	}
+	return available;
+}
+
+float OfflineQuery::PathingDistance(const Point2D& start,
+	const Point2D& end) {
+	if (!observation.IsPathable(start) || !observation.IsPathable(end)) {
+		return 0.0f;
+	}
+	return Distance2D(start, end);
+}
+
+float OfflineQuery::PathingDistance(const Unit* start, const Point2D& end) {
+	if (!start) {
+		return 0.0f;
+	}
+	// Flying units go straight
+	if (start->is_flying) {
+		return Distance2D(start->pos, end);
+	}
+	return PathingDistance(Point2D(start->pos), end);
+}
+
+std::vector<float> OfflineQuery::PathingDistance(
+	const std::vector<PathingQuery>& queries) {
+	std::vector<float> distances;
+	for (const auto& query : queries) {
+		const Unit* unit = query.start_unit_tag_ != NullTag
+			? observation.GetUnit(query.start_unit_tag_) : nullptr;
+		distances.push_back(unit ? PathingDistance(unit, query.end_)
+			: PathingDistance(query.start_, query.end_));
+	}
+	return distances;
+}
+
+bool OfflineQuery::Placement(const AbilityID& ability,
+	const Point2D& target_pos, const Unit*) {
+	UNIT_TYPEID type = ProducedType(ability);
+	const OfflineUnitInfo* info = FindUnitInfo(type);
+	if (!info || !info->footprint) {
+		return true;
+	}
+
+	const Units units = observation.GetUnits();
+	if (type == UNIT_TYPEID::TERRAN_REFINERY) {
+		// Only on a free geyser
+		bool geyser = false;
+		for (const Unit* unit : units) {
+			if (DistanceSquared2D(unit->pos, target_pos) > 0.01f) {
+				continue;
+			}
+			if (unit->unit_type == UNIT_TYPEID::NEUTRAL_VESPENEGEYSER) {
+				geyser = true;
+			}
+			else if (unit->unit_type == UNIT_TYPEID::TERRAN_REFINERY) {
+				return false;
+			}
+		}
+		return geyser;
+	}
+
+	float half = info->footprint / 2.0f;
+	int left = static_cast<int>(std::floor(target_pos.x - half + 0.5f));
+	int bottom = static_cast<int>(std::floor(target_pos.y - half + 0.5f));
+	for (int y = bottom; y < bottom + info->footprint; ++y) {
+		for (int x = left; x < left + info->footprint; ++x) {
+			Point2D cell(x + 0.5f, y + 0.5f);
+			if (!observation.IsPlacable(cell) ||
+				!observation.IsPathable(cell)) {
+				return false;
+			}
+			for (const Unit* unit : units) {
+				if (Covers(*unit, x, y)) {
+					return false;
+				}
+			}
+		}
+	}
+
+	if (IsTownHallType(type)) {
+		for (const Unit* unit : units) {
+			if (IsResource(unit->unit_type) &&
+				Distance2D(unit->pos, target_pos) <
+				town_hall_resource_distance) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+std::vector<bool> OfflineQuery::Placement(
+	const std::vector<PlacementQuery>& queries) {
+	std::vector<bool> results;
+	for (const auto& query : queries) {
+		const Unit* unit = query.placing_unit_tag != NullTag
+			? observation.GetUnit(query.placing_unit_tag) : nullptr;
+		results.push_back(Placement(query.ability, query.target_pos, unit));
+	}
+	return results;
+}
+
+void OfflineActions::Add(const Unit* unit, const OfflineCommand& command) {
+	if (!unit) {
+		return;
+	}
+	commands.push_back(command);
+	commands.back().unit = unit->tag;
+	tags.push_back(unit->tag);
+	++sent;
+}
+
+void OfflineActions::UnitCommand(const Unit* unit, AbilityID ability,
+	bool queued_command) {
+	OfflineCommand command;
+	command.ability = ability;
+	command.queued = queued_command;
+	Add(unit, command);
+}
+
+void OfflineActions::UnitCommand(const Unit* unit, AbilityID ability,
+	const Point2D& point, bool queued_command) {
+	OfflineCommand command;
+	command.ability = ability;
+	command.target = OfflineCommand::Point;
+	command.point = point;
+	command.queued = queued_command;
+	Add(unit, command);
+}
+
+void OfflineActions::UnitCommand(const Unit* unit, AbilityID ability,
+	const Unit* target, bool queued_command) {
+	OfflineCommand command;
+	command.ability = ability;
+	command.target = OfflineCommand::Unit;
+	command.target_unit = target ? target->tag : NullTag;
+	command.queued = queued_command;
+	Add(unit, command);
+}
+
+void OfflineActions::UnitCommand(const Units& units, AbilityID ability,
+	bool queued_move) {
+	for (const Unit* unit : units) {
+		UnitCommand(unit, ability, queued_move);
+	}
+}
+
+void OfflineActions::UnitCommand(const Units& units, AbilityID ability,
+	const Point2D& point, bool queued_command) {
+	for (const Unit* unit : units) {
+		UnitCommand(unit, ability, point, queued_command);
+	}
+}
+
+void OfflineActions::UnitCommand(const Units& units, AbilityID ability,
+	const Unit* target, bool queued_command) {
+	for (const Unit* unit : units) {
+		UnitCommand(unit, ability, target, queued_command);
+	}
+}
+
+std::vector<OfflineCommand> OfflineActions::TakeCommands() {
+	std::vector<OfflineCommand> taken;
+	taken.swap(commands);
+	tags.clear();
+	return taken;
+}
@@ -0,0 +1,205 @@
+#ifndef OFFLINE_INTERFACES_H_
+#define OFFLINE_INTERFACES_H_
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_gametypes.h"
+#include "sc2api/sc2_interfaces.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// The game state of one game loop, as a frame source hands it out
+struct OfflineFrame {
+	uint32_t game_loop = 0;
+	int32_t minerals = 0;
+	int32_t vespene = 0;
+	int32_t food_used = 0;
+	int32_t food_cap = 0;
+	std::vector<sc2::Unit> units;
+	std::vector<sc2::UpgradeID> upgrades;
+	// Units that died since the frame before; units missing from the frame
+	// are only out of sight
+	std::vector<sc2::Tag> dead_units;
+	// Set on the last frame of a game
+	std::vector<sc2::PlayerResult> results;
+};
+
+// One unit command sent by the bot
+struct OfflineCommand {
+	enum Target { None, Point, Unit };
+
+	sc2::Tag unit;
+	sc2::AbilityID ability;
+	Target target = None;
+	sc2::Point2D point;
+	sc2::Tag target_unit = sc2::NullTag;
+	bool queued = false;
+};
+
+// Callbacks owed to the bot for a new frame, in the order the client calls
+// them
+struct OfflineEvents {
+	std::vector<const sc2::Unit*> destroyed;
+	std::vector<const sc2::Unit*> created;
+	std::vector<const sc2::Unit*> idle;
+	std::vector<sc2::UpgradeID> upgrades;
+	std::vector<const sc2::Unit*> completed;
+	std::vector<const sc2::Unit*> entered_vision;
+};
+
+// ObservationInterface over frames. Unit objects are kept per tag for the
+// whole game, like the client does, so pointers held by the bot stay valid.
+class OfflineObservation : public sc2::ObservationInterface {
+public:
+	OfflineObservation(const sc2::GameInfo& game_info,
+		const sc2::Point3D& start_location);
+
+	// Replaces the state with this frame and returns the callbacks it causes.
+	// The first frame causes none.
+	OfflineEvents Update(const OfflineFrame& frame);
+
+	uint32_t GetPlayerID() const override { return 1; }
+	uint32_t GetGameLoop() const override { return game_loop; }
+	sc2::Units GetUnits() const override;
+	sc2::Units GetUnits(sc2::Unit::Alliance alliance,
+		sc2::Filter filter = {}) const override;
+	sc2::Units GetUnits(sc2::Filter filter) const override;
+	const sc2::Unit* GetUnit(sc2::Tag tag) const override;
+	const sc2::RawActions& GetRawActions() const override;
+	const sc2::SpatialActions& GetFeatureLayerActions() const override;
+	const sc2::SpatialActions& GetRenderedActions() const override;
+	const std::vector<sc2::ChatMessage>& GetChatMessages() const override;
+	const std::vector<sc2::PowerSource>& GetPowerSources() const override;
+	const std::vector<sc2::Effect>& GetEffects() const override;
+	const std::vector<sc2::UpgradeID>& GetUpgrades() const override;
+	const sc2::Score& GetScore() const override;
+	const sc2::Abilities& GetAbilityData(
+		bool force_refresh = false) const override;
+	const sc2::UnitTypes& GetUnitTypeData(
+		bool force_refresh = false) const override;
+	const sc2::Upgrades& GetUpgradeData(
+		bool force_refresh = false) const override;
+	const sc2::Buffs& GetBuffData(bool force_refresh = false) const override;
+	const sc2::Effects& GetEffectData(
+		bool force_refresh = false) const override;
+	const sc2::GameInfo& GetGameInfo() const override { return game_info; }
+	int32_t GetMinerals() const override { return minerals; }
+	int32_t GetVespene() const override { return vespene; }
+	int32_t GetFoodCap() const override { return food_cap; }
+	int32_t GetFoodUsed() const override { return food_used; }
+	int32_t GetFoodArmy() const override;
+	int32_t GetFoodWorkers() const override;
+	int32_t GetIdleWorkerCount() const override;
+	int32_t GetArmyCount() const override;
+	int32_t GetWarpGateCount() const override { return 0; }
+	int32_t GetLarvaCount() const override { return 0; }
+	sc2::Point2D GetCameraPos() const override { return start_location; }
+	sc2::Point3D GetStartLocation() const override { return start_location; }
+	const std::vector<sc2::PlayerResult>& GetResults() const override {
+		return results;
+	}
+	bool HasCreep(const sc2::Point2D& point) const override;
+	sc2::Visibility GetVisibility(const sc2::Point2D& point) const override;
+	bool IsPathable(const sc2::Point2D& point) const override;
+	bool IsPlacable(const sc2::Point2D& point) const override;
+	float TerrainHeight(const sc2::Point2D& point) const override;
+	const SC2APIProtocol::Observation* GetRawObservation() const override {
+		return nullptr;
+	}
+
+private:
+	// 1 bit per cell, top row first, like the game's grids
+	bool GridBit(const sc2::ImageData& grid, const sc2::Point2D& point) const;
+
+	sc2::GameInfo game_info;
+	sc2::Point3D start_location;
+	sc2::UnitTypes unit_types;
+	sc2::Abilities abilities;
+
+	uint32_t game_loop = 0;
+	int32_t minerals = 0;
+	int32_t vespene = 0;
+	int32_t food_used = 0;
+	int32_t food_cap = 0;
+	std::vector<sc2::UpgradeID> upgrades;
+	std::vector<sc2::PlayerResult> results;
+	bool first_frame = true;
+
+	// Every unit seen this game, and the ones in the current frame in frame
+	// order
+	std::unordered_map<sc2::Tag, std::unique_ptr<sc2::Unit>> unit_pool;
+	sc2::Units units;
+};
+
+// QueryInterface answered from the map grids and the units of the
+// observation, without path finding
+class OfflineQuery : public sc2::QueryInterface {
+public:
+	explicit OfflineQuery(const OfflineObservation& observation_source)
+		: observation(observation_source) {}
+
+	sc2::AvailableAbilities GetAbilitiesForUnit(const sc2::Unit* unit,
+		bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities> GetAbilitiesForUnits(
+		const sc2::Units& units,
+		bool ignore_resource_requirements = false) override;
+
+	// Straight line distance, 0 when either end isn't pathable (as the game
+	// answers for unreachable points)
+	float PathingDistance(const sc2::Point2D& start,
+		const sc2::Point2D& end) override;
+	float PathingDistance(const sc2::Unit* start,
+		const sc2::Point2D& end) override;
+	std::vector<float> PathingDistance(
+		const std::vector<PathingQuery>& queries) override;
+
+	bool Placement(const sc2::AbilityID& ability,
+		const sc2::Point2D& target_pos,
+		const sc2::Unit* unit = nullptr) override;
+	std::vector<bool> Placement(
+		const std::vector<PlacementQuery>& queries) override;
+
+private:
+	const OfflineObservation& observation;
+};
+
+// ActionInterface that keeps the commands for the frame source
+class OfflineActions : public sc2::ActionInterface {
+public:
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		bool queued_command = false) override;
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		const sc2::Point2D& point, bool queued_command = false) override;
+	void UnitCommand(const sc2::Unit* unit, sc2::AbilityID ability,
+		const sc2::Unit* target, bool queued_command = false) override;
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		bool queued_move = false) override;
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		const sc2::Point2D& point, bool queued_command = false) override;
+	void UnitCommand(const sc2::Units& units, sc2::AbilityID ability,
+		const sc2::Unit* target, bool queued_command = false) override;
+	const std::vector<sc2::Tag>& Commands() const override { return tags; }
+	void ToggleAutocast(sc2::Tag, sc2::AbilityID) override {}
+	void ToggleAutocast(const std::vector<sc2::Tag>&, sc2::AbilityID) override {}
+	void SendChat(const std::string&,
+		sc2::ChatChannel = sc2::ChatChannel::All) override {}
+	void SendActions() override {}
+
+	// Commands since the last call, in the order they were sent
+	std::vector<OfflineCommand> TakeCommands();
+
+	// Commands sent over the whole game
+	size_t Sent() const { return sent; }
+
+private:
+	void Add(const sc2::Unit* unit, const OfflineCommand& command);
+
+	std::vector<OfflineCommand> commands;
+	std::vector<sc2::Tag> tags;
+	size_t sent = 0;
+};
+
+#endif
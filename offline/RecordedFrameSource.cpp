@@ -0,0 +1,18 @@
+#include "RecordedFrameSource.h"
+
+bool RecordedFrameSource::Next(OfflineFrame& frame) {
+	if (!reader.Next()) {
+		return false;
+	}
+	const RecordedFrame& recorded = reader.Frame();
+	frame.game_loop = recorded.game_loop;
+	frame.minerals = recorded.minerals;
+	frame.vespene = recorded.vespene;
+	frame.food_used = recorded.food_used;
+	frame.food_cap = recorded.food_cap;
+	frame.units = recorded.units;
+	frame.upgrades = recorded.upgrades;
+	frame.dead_units = recorded.dead_units;
+	frame.results = recorded.results;
+	return true;
+}
@@ -0,0 +1,27 @@
+#ifndef RECORDED_FRAME_SOURCE_H_
+#define RECORDED_FRAME_SOURCE_H_
+
+#include "FrameSource.h"
+#include "GameRecording.h"
+
+#include <string>
+
+// Replays a game recorded with --Record. The frames are what the client saw
+// in that game, so the bot's commands don't change them.
+class RecordedFrameSource : public FrameSource {
+public:
+	// False if the file isn't a recording
+	bool Open(const std::string& path) { return reader.Open(path); }
+	uint32_t FrameCount() const { return reader.FrameCount(); }
+
+	const sc2::GameInfo& Info() const override { return reader.Info(); }
+	sc2::Point3D StartLocation() const override {
+		return reader.StartLocation();
+	}
+	bool Next(OfflineFrame& frame) override;
+
+private:
+	RecordingReader reader;
+};
+
+#endif
@@ -0,0 +1,1077 @@
+#include "SyntheticGame.h"
+
+#include "OfflineData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+using namespace sc2;
+
+namespace {
+const int map_size = 128;
+const int playable_min = 8;
+const int playable_max = 120;
+
+// Height bytes of the levels, decoded as -100 + 200 * byte / 255
+const unsigned char main_height = 140;
+const unsigned char natural_height = 120;
+const unsigned char low_height = 100;
+
+const Point2D main_base(24.5f, 27.5f);
+const Point2D natural_base(51.5f, 53.5f);
+const Point2D third_base(60.5f, 24.5f);
+
+const int mineral_contents = 1800;
+const int vespene_contents = 2250;
+const uint32_t gather_loops = 64;
+const int mineral_trip = 5;
+const int vespene_trip = 4;
+const int mule_trip = 25;
+const uint32_t mule_loops = 1434;
+const uint32_t research_loops = 2240;
+const uint32_t jump_loops = 90;
+const float energy_per_loop = 0.7875f / 22.4f;
+const float max_energy = 200.0f;
+const float max_food = 200.0f;
+
+Point2D Mirror(const Point2D& point) {
+	return Point2D(map_size - point.x, map_size - point.y);
+}
+
+// Where the waves gather, below the enemy natural ramp
+const Point2D wave_spawn = Mirror(Point2D(70.0f, 54.0f));
+
+struct Cell {
+	bool pathable;
+	bool placeable;
+	unsigned char height;
+};
+
+// A cell of our side of the map (x + y < 127). The main is the square up to
+// 40 with a diagonal ramp out of its corner, like the usual main ramp, down
+// to the natural square; the natural has a wide ramp down to the lowland.
+// Both are ringed by cliffs.
+Cell SideCell(int x, int y) {
+	if (x < playable_min || y < playable_min || x >= playable_max ||
+		y >= playable_max) {
+		return { false, false, 0 };
+	}
+	// The main ramp is a band along the diagonal, two cells to a row; its top
+	// row is at the height of the main, so the bot sees it as the upper edge
+	int along = x + y;
+	int across = x - y;
+	if (along >= 73 && along < 84 && across >= -1 && across <= 2) {
+		float t = (along - 73) / 10.0f;
+		return { true, false, static_cast<unsigned char>(main_height +
+			(natural_height - main_height) * t) };
+	}
+	if (x >= 64 && x < 68 && y >= 50 && y < 58) {
+		float t = (x - 64 + 0.5f) / 4.0f;
+		return { true, false, static_cast<unsigned char>(natural_height +
+			(low_height - natural_height) * t) };
+	}
+	if (x < 40 && y < 40) {
+		return { true, true, main_height };
+	}
+	if (x >= 42 && x < 64 && y >= 42 && y < 64) {
+		return { true, true, natural_height };
+	}
+	if (x < 43 && y < 43) {
+		return { false, false, (main_height + natural_height) / 2 };
+	}
+	if (x >= 39 && x < 67 && y >= 39 && y < 67) {
+		return { false, false, (natural_height + low_height) / 2 };
+	}
+	return { true, true, low_height };
+}
+
+bool IsSelfTownHall(const Unit& unit) {
+	return unit.alliance == Unit::Alliance::Self && unit.build_progress >= 1.0f &&
+		(unit.unit_type == UNIT_TYPEID::TERRAN_COMMANDCENTER ||
+			unit.unit_type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND ||
+			unit.unit_type == UNIT_TYPEID::TERRAN_PLANETARYFORTRESS);
+}
+
+bool IsMineral(const Unit& unit) {
+	return unit.unit_type == UNIT_TYPEID::NEUTRAL_MINERALFIELD;
+}
+
+bool IsStructure(const Unit& unit) {
+	const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type);
+	return info && info->footprint > 0 && !IsMineral(unit) &&
+		unit.unit_type != UNIT_TYPEID::NEUTRAL_VESPENEGEYSER;
+}
+
+bool CanHitAir(UnitTypeID type) {
+	return type == UNIT_TYPEID::TERRAN_MARINE ||
+		type == UNIT_TYPEID::TERRAN_BATTLECRUISER;
+}
+
+// Cells covered on the ground, as [x0, x1) x [y0, y1)
+struct Rect {
+	int x0, y0, x1, y1;
+
+	bool Overlaps(const Rect& other) const {
+		return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 &&
+			other.y0 < y1;
+	}
+};
+
+Rect Footprint(UnitTypeID type, const Point2D& pos) {
+	if (type == UNIT_TYPEID::NEUTRAL_MINERALFIELD) {
+		int left = static_cast<int>(std::floor(pos.x)) - 1;
+		int row = static_cast<int>(std::floor(pos.y));
+		return { left, row, left + 2, row + 1 };
+	}
+	const OfflineUnitInfo* info = FindUnitInfo(type);
+	int size = info ? info->footprint : 0;
+	float half = size / 2.0f;
+	int left = static_cast<int>(std::floor(pos.x - half + 0.5f));
+	int bottom = static_cast<int>(std::floor(pos.y - half + 0.5f));
+	return { left, bottom, left + size, bottom + size };
+}
+}
+
+SyntheticGame::SyntheticGame() : SyntheticGame(Settings()) {}
+
+SyntheticGame::SyntheticGame(const Settings& game_settings)
+	: settings(game_settings) {
+	BuildMap();
+	AddStartingUnits();
+}
+
+Point3D SyntheticGame::StartLocation() const {
+	return Point3D(main_base.x, main_base.y, HeightAt(main_base));
+}
+
+void SyntheticGame::BuildMap() {
+	std::vector<bool> pathable(map_size * map_size, false);
+	placeable.assign(map_size * map_size, false);
+	heights.assign(map_size * map_size, 0);
+
+	// Cells of the enemy side are the mirror of ours
+	for (int y = 0; y < map_size; ++y) {
+		for (int x = 0; x < map_size; ++x) {
+			bool ours = x + y < map_size - 1;
+			Cell cell = SideCell(ours ? x : map_size - 1 - x,
+				ours ? y : map_size - 1 - y);
+			pathable[x + y * map_size] = cell.pathable;
+			placeable[x + y * map_size] = cell.placeable;
+			heights[x + y * map_size] = cell.height;
+		}
+	}
+
+	game_info.width = map_size;
+	game_info.height = map_size;
+	game_info.map_name = "Synthetic";
+	game_info.playable_min = Point2D(playable_min, playable_min);
+	game_info.playable_max = Point2D(playable_max, playable_max);
+	game_info.start_locations = { main_base, Mirror(main_base) };
+	game_info.enemy_start_locations = { Mirror(main_base) };
+
+	PlayerInfo self;
+	self.player_id = 1;
+	self.player_type = PlayerType::Participant;
+	self.race_requested = Race::Terran;
+	self.race_actual = Race::Terran;
+	PlayerInfo enemy;
+	enemy.player_id = 2;
+	enemy.player_type = PlayerType::Computer;
+	enemy.race_requested = Race::Zerg;
+	enemy.race_actual = Race::Zerg;
+	game_info.player_info = { self, enemy };
+
+	// The game's layout: top row first, 1 bit per cell for the grids
+	auto pack_bits = [](const std::vector<bool>& cells, ImageData& image) {
+		image.width = map_size;
+		image.height = map_size;
+		image.bits_per_pixel = 1;
+		image.data.assign(map_size * map_size / 8, 0);
+		for (int y = 0; y < map_size; ++y) {
+			for (int x = 0; x < map_size; ++x) {
+				if (cells[x + y * map_size]) {
+					int index = x + (map_size - 1 - y) * map_size;
+					image.data[index / 8] |= static_cast<char>(0x80 >> (index % 8));
+				}
+			}
+		}
+	};
+	pack_bits(placeable, game_info.placement_grid);
+
+	// Resources block pathing, like in the game's grid
+	for (const Point2D& base : { main_base, natural_base, third_base }) {
+		for (const Point2D& pos : { base, Mirror(base) }) {
+			AddBase(pos, base.x < third_base.x);
+		}
+	}
+	for (const Unit& unit : units) {
+		Rect cells = Footprint(unit.unit_type, unit.pos);
+		for (int y = cells.y0; y < cells.y1; ++y) {
+			for (int x = cells.x0; x < cells.x1; ++x) {
+				pathable[x + y * map_size] = false;
+			}
+		}
+	}
+	pack_bits(pathable, game_info.pathing_grid);
+
+	ImageData& terrain = game_info.terrain_height;
+	terrain.width = map_size;
+	terrain.height = map_size;
+	terrain.bits_per_pixel = 8;
+	terrain.data.assign(map_size * map_size, 0);
+	for (int y = 0; y < map_size; ++y) {
+		for (int x = 0; x < map_size; ++x) {
+			terrain.data[x + (map_size - 1 - y) * map_size] =
+				static_cast<char>(heights[x + y * map_size]);
+		}
+	}
+}
+
+void SyntheticGame::AddBase(const Point2D& town_hall, bool side_minerals) {
+	// Offsets are for a base on our side and are mirrored on the enemy's
+	float flip = town_hall.x < map_size / 2 ? 1.0f : -1.0f;
+	for (int i = 0; i < 8; ++i) {
+		Point2D pos = side_minerals
+			? Point2D(town_hall.x - flip * (7.5f + i % 2), town_hall.y +
+				flip * (i - 4.0f))
+			: Point2D(town_hall.x + flip * (i - 4.5f), town_hall.y - flip *
+				(7.0f + i % 2));
+		Unit& mineral =
+			Spawn(UNIT_TYPEID::NEUTRAL_MINERALFIELD, Unit::Alliance::Neutral, pos);
+		mineral.mineral_contents = mineral_contents;
+	}
+	Point2D geysers[2] = {
+		side_minerals ? Point2D(-3.0f, -7.0f) : Point2D(-7.0f, -3.0f),
+		Point2D(7.0f, -3.0f),
+	};
+	for (const Point2D& offset : geysers) {
+		Unit& geyser = Spawn(UNIT_TYPEID::NEUTRAL_VESPENEGEYSER,
+			Unit::Alliance::Neutral, town_hall + offset * flip);
+		geyser.vespene_contents = vespene_contents;
+	}
+}
+
+void SyntheticGame::AddStartingUnits() {
+	Spawn(UNIT_TYPEID::TERRAN_COMMANDCENTER, Unit::Alliance::Self, main_base);
+	for (int i = 0; i < 12; ++i) {
+		Point2D pos(main_base.x - 3.5f, main_base.y - 2.75f + i * 0.5f);
+		Spawn(UNIT_TYPEID::TERRAN_SCV, Unit::Alliance::Self, pos);
+	}
+	Spawn(UNIT_TYPEID::ZERG_HATCHERY, Unit::Alliance::Enemy, Mirror(main_base));
+	Spawn(UNIT_TYPEID::ZERG_HATCHERY, Unit::Alliance::Enemy,
+		Mirror(natural_base));
+}
+
+Unit& SyntheticGame::Spawn(UNIT_TYPEID type, Unit::Alliance alliance,
+	const Point2D& pos, float build_progress) {
+	const OfflineUnitInfo* info = FindUnitInfo(type);
+	Unit unit;
+	unit.display_type = Unit::DisplayType::Visible;
+	unit.alliance = alliance;
+	unit.tag = next_tag++;
+	unit.unit_type = type;
+	unit.owner = alliance == Unit::Alliance::Self ? 1
+		: alliance == Unit::Alliance::Enemy ? 2 : 16;
+	unit.pos = Point3D(pos.x, pos.y, HeightAt(pos));
+	unit.build_progress = build_progress;
+	if (info) {
+		unit.radius = info->radius;
+		unit.health_max = info->health;
+		unit.health = build_progress < 1.0f ? info->health * 0.1f : info->health;
+		unit.is_flying = info->flying;
+	}
+	unit.last_seen_game_loop = game_loop;
+	units.push_back(unit);
+	return units.back();
+}
+
+Unit* SyntheticGame::Find(Tag tag) {
+	for (Unit& unit : units) {
+		if (unit.tag == tag) {
+			return &unit;
+		}
+	}
+	return nullptr;
+}
+
+float SyntheticGame::HeightAt(const Point2D& pos) const {
+	int x = std::min(std::max(static_cast<int>(pos.x), 0), map_size - 1);
+	int y = std::min(std::max(static_cast<int>(pos.y), 0), map_size - 1);
+	return -100.0f + 200.0f * heights[x + y * map_size] / 255.0f;
+}
+
+int SyntheticGame::FoodUsed() const {
+	float food = 0.0f;
+	for (const Unit& unit : units) {
+		if (unit.alliance != Unit::Alliance::Self) {
+			continue;
+		}
+		if (const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type)) {
+			food += info->food_used;
+		}
+		// Queued units take their supply when queued
+		for (const UnitOrder& order : unit.orders) {
+			const OfflineUnitInfo* info =
+				FindUnitInfo(ProducedType(order.ability_id));
+			if (info && !info->footprint) {
+				food += info->food_used;
+			}
+		}
+	}
+	return static_cast<int>(std::ceil(food));
+}
+
+int SyntheticGame::FoodCap() const {
+	float food = 0.0f;
+	for (const Unit& unit : units) {
+		if (unit.alliance != Unit::Alliance::Self || unit.build_progress < 1.0f) {
+			continue;
+		}
+		if (const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type)) {
+			food += info->food_provided;
+		}
+	}
+	return static_cast<int>(std::min(food, max_food));
+}
+
+bool SyntheticGame::Next(OfflineFrame& frame) {
+	if (over) {
+		return false;
+	}
+	if (started) {
+		Step();
+	}
+	started = true;
+	CheckGameOver();
+
+	frame.game_loop = game_loop;
+	frame.minerals = minerals;
+	frame.vespene = vespene;
+	frame.food_used = FoodUsed();
+	frame.food_cap = FoodCap();
+	frame.units.assign(units.begin(), units.end());
+	frame.upgrades = upgrades;
+	frame.dead_units = dead_units;
+	frame.results = results;
+	return true;
+}
+
+void SyntheticGame::Apply(const std::vector<OfflineCommand>& commands) {
+	for (const auto& command : commands) {
+		ApplyCommand(command);
+	}
+}
+
+bool SyntheticGame::Pay(int minerals_cost, int vespene_cost) {
+	if (minerals < minerals_cost || vespene < vespene_cost) {
+		return false;
+	}
+	minerals -= minerals_cost;
+	vespene -= vespene_cost;
+	return true;
+}
+
+bool SyntheticGame::Pay(UNIT_TYPEID type) {
+	const OfflineUnitInfo* info = FindUnitInfo(type);
+	if (!info) {
+		return false;
+	}
+	if (!info->footprint && info->food_used > 0.0f &&
+		FoodUsed() + info->food_used > FoodCap()) {
+		return false;
+	}
+	return Pay(info->minerals, info->vespene);
+}
+
+void SyntheticGame::ApplyCommand(const OfflineCommand& command) {
+	Unit* unit = Find(command.unit);
+	if (!unit || unit->alliance != Unit::Alliance::Self ||
+		unit->health <= 0.0f) {
+		return;
+	}
+	uint32_t generic = GenericAbility(command.ability);
+	ABILITY_ID ability = static_cast<ABILITY_ID>(generic);
+	bool ready = unit->build_progress >= 1.0f;
+
+	// Orders carry the specific abilities, as in the game
+	UnitOrder order;
+	order.ability_id = AbilityID(OrderAbility(generic, unit->unit_type));
+	order.target_pos = command.point;
+	order.target_unit_tag = command.target_unit;
+	if (command.target == OfflineCommand::Unit) {
+		if (const Unit* target = Find(command.target_unit)) {
+			order.target_pos = target->pos;
+		}
+	}
+	auto give = [&](const UnitOrder& new_order) {
+		if (!command.queued) {
+			unit->orders.clear();
+			extra[unit->tag].timer_running = false;
+		}
+		unit->orders.push_back(new_order);
+	};
+
+	UNIT_TYPEID produced = ProducedType(command.ability);
+	const OfflineUnitInfo* produced_info = FindUnitInfo(produced);
+	if (produced_info) {
+		if (produced == UNIT_TYPEID::TERRAN_ORBITALCOMMAND) {
+			if (ready && unit->orders.empty() &&
+				unit->unit_type == UNIT_TYPEID::TERRAN_COMMANDCENTER &&
+				Pay(produced_info->minerals, 0)) {
+				unit->orders.push_back(order);
+			}
+		}
+		else if (produced_info->footprint) {
+			// Paid when the SCV starts it, as in the game
+			if (unit->unit_type == UNIT_TYPEID::TERRAN_SCV &&
+				minerals >= produced_info->minerals &&
+				vespene >= produced_info->vespene) {
+				give(order);
+			}
+		}
+		else if (ready && IsStructure(*unit) && !unit->is_flying &&
+			unit->orders.size() < 5 && Pay(produced)) {
+			unit->orders.push_back(order);
+		}
+		return;
+	}
+
+	if (ability == ABILITY_ID::BUILD_TECHLAB ||
+		ability == ABILITY_ID::BUILD_REACTOR) {
+		UNIT_TYPEID addon =
+			AddonType(unit->unit_type, ability == ABILITY_ID::BUILD_REACTOR);
+		if (addon != UNIT_TYPEID::INVALID && ready && !unit->is_flying &&
+			unit->orders.empty() && unit->add_on_tag == NullTag && Pay(addon)) {
+			Point2D pos(unit->pos.x + 2.5f, unit->pos.y - 0.5f);
+			Tag addon_tag = Spawn(addon, Unit::Alliance::Self, pos, 0.0f).tag;
+			unit->add_on_tag = addon_tag;
+			order.target_unit_tag = addon_tag;
+			unit->orders.push_back(order);
+		}
+		return;
+	}
+
+	UPGRADE_ID upgrade = ResearchedUpgrade(command.ability);
+	if (upgrade != UPGRADE_ID::INVALID) {
+		bool owned = std::find(upgrades.begin(), upgrades.end(),
+			UpgradeID(upgrade)) != upgrades.end();
+		if (ready && !owned && unit->orders.empty() && Pay(100, 100)) {
+			unit->orders.push_back(order);
+		}
+		return;
+	}
+
+	const OfflineUnitInfo* info = FindUnitInfo(unit->unit_type);
+	switch (ability) {
+	case ABILITY_ID::STOP:
+	case ABILITY_ID::HALT:
+		unit->orders.clear();
+		break;
+	case ABILITY_ID::SMART: {
+		const Unit* target = Find(command.target_unit);
+		if (target && (IsMineral(*target) ||
+			target->unit_type == UNIT_TYPEID::TERRAN_REFINERY)) {
+			order.ability_id = OrderAbility(ABILITY_ID::HARVEST_GATHER,
+				unit->unit_type);
+		}
+		else if (target && target->alliance == Unit::Alliance::Enemy) {
+			order.ability_id = ABILITY_ID::ATTACK_ATTACK;
+		}
+		else {
+			order.ability_id = ABILITY_ID::MOVE_MOVE;
+		}
+		if (info && !info->footprint) {
+			give(order);
+		}
+		break;
+	}
+	case ABILITY_ID::MOVE:
+	case ABILITY_ID::ATTACK:
+	case ABILITY_ID::EFFECT_REPAIR:
+		if (info && (!info->footprint || unit->is_flying)) {
+			give(order);
+		}
+		break;
+	case ABILITY_ID::HARVEST_GATHER:
+	case ABILITY_ID::HARVEST_RETURN:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_SCV ||
+			unit->unit_type == UNIT_TYPEID::TERRAN_MULE) {
+			give(order);
+		}
+		break;
+	case ABILITY_ID::EFFECT_TACTICALJUMP:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_BATTLECRUISER) {
+			give(order);
+		}
+		break;
+	case ABILITY_ID::LAND:
+		if (LandedType(unit->unit_type) != UNIT_TYPEID::INVALID) {
+			give(order);
+		}
+		break;
+	case ABILITY_ID::LIFT: {
+		UNIT_TYPEID flying = FlyingType(unit->unit_type);
+		if (flying != UNIT_TYPEID::INVALID && ready && unit->orders.empty()) {
+			unit->unit_type = flying;
+			unit->is_flying = true;
+			unit->add_on_tag = NullTag;
+		}
+		break;
+	}
+	case ABILITY_ID::MORPH_SIEGEMODE:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANK) {
+			unit->unit_type = UNIT_TYPEID::TERRAN_SIEGETANKSIEGED;
+			unit->orders.clear();
+		}
+		break;
+	case ABILITY_ID::MORPH_UNSIEGE:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_SIEGETANKSIEGED) {
+			unit->unit_type = UNIT_TYPEID::TERRAN_SIEGETANK;
+		}
+		break;
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_LOWER:
+		if (ready && unit->unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOT) {
+			unit->unit_type = UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED;
+		}
+		break;
+	case ABILITY_ID::MORPH_SUPPLYDEPOT_RAISE:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_SUPPLYDEPOTLOWERED) {
+			unit->unit_type = UNIT_TYPEID::TERRAN_SUPPLYDEPOT;
+		}
+		break;
+	case ABILITY_ID::EFFECT_CALLDOWNMULE: {
+		const Unit* target = Find(command.target_unit);
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND &&
+			unit->energy >= 50.0f && target && IsMineral(*target)) {
+			unit->energy -= 50.0f;
+			Point2D pos = target->pos;
+			Tag mineral = target->tag;
+			Unit& mule = Spawn(UNIT_TYPEID::TERRAN_MULE, Unit::Alliance::Self,
+				pos + Point2D(1.0f, 0.0f));
+			UnitOrder gather;
+			gather.ability_id = ABILITY_ID::HARVEST_GATHER_MULE;
+			gather.target_unit_tag = mineral;
+			gather.target_pos = pos;
+			mule.orders.push_back(gather);
+			extra[mule.tag].expires = game_loop + mule_loops;
+		}
+		break;
+	}
+	case ABILITY_ID::EFFECT_SCAN:
+		if (unit->unit_type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND &&
+			unit->energy >= 50.0f) {
+			unit->energy -= 50.0f;
+		}
+		break;
+	case ABILITY_ID::CANCEL_BUILDINPROGRESS:
+		if (!ready && info) {
+			minerals += info->minerals * 3 / 4;
+			vespene += info->vespene * 3 / 4;
+			unit->health = 0.0f;
+		}
+		break;
+	default:
+		// Rally points and everything else have no effect here
+		break;
+	}
+}
+
+bool SyntheticGame::MoveTowards(Unit& unit, const Point2D& target,
+	float distance) {
+	const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type);
+	float speed = info ? info->speed : 0.0f;
+	Point2D pos(unit.pos);
+	float remaining = Distance2D(pos, target) - distance;
+	if (remaining <= 0.0f) {
+		return true;
+	}
+	if (speed <= 0.0f) {
+		return false;
+	}
+	float step = std::min(speed, remaining);
+	Point2D direction = (target - pos) / Distance2D(pos, target);
+	pos += direction * step;
+	pos.x = std::min(std::max(pos.x, static_cast<float>(playable_min)),
+		static_cast<float>(playable_max));
+	pos.y = std::min(std::max(pos.y, static_cast<float>(playable_min)),
+		static_cast<float>(playable_max));
+	unit.pos = Point3D(pos.x, pos.y, HeightAt(pos));
+	unit.facing = std::atan2(direction.y, direction.x);
+	return remaining <= speed;
+}
+
+void SyntheticGame::Step() {
+	++game_loop;
+	if (game_loop >= settings.first_wave_loop &&
+		(game_loop - settings.first_wave_loop) % settings.wave_interval == 0) {
+		SpawnWave();
+	}
+
+	StepCombat();
+
+	// Orders may spawn units; they start acting on the next loop
+	size_t count = units.size();
+	for (size_t i = 0; i < count; ++i) {
+		Unit& unit = units[i];
+		if (unit.alliance == Unit::Alliance::Neutral || unit.health <= 0.0f) {
+			continue;
+		}
+		if (unit.unit_type == UNIT_TYPEID::TERRAN_ORBITALCOMMAND) {
+			unit.energy = std::min(unit.energy + energy_per_loop, max_energy);
+		}
+		auto it = extra.find(unit.tag);
+		if (it != extra.end() && it->second.expires &&
+			game_loop >= it->second.expires) {
+			unit.health = 0.0f;
+			continue;
+		}
+		StepOrder(unit);
+	}
+
+	// Depleted minerals are reported dead too, as in the game
+	dead_units.clear();
+	units.erase(std::remove_if(units.begin(), units.end(),
+		[this](const Unit& unit) {
+			bool dead = unit.alliance == Unit::Alliance::Neutral ?
+				IsMineral(unit) && unit.mineral_contents <= 0 :
+				unit.health <= 0.0f;
+			if (dead) {
+				dead_units.push_back(unit.tag);
+			}
+			return dead;
+		}), units.end());
+	std::unordered_set<Tag> alive;
+	for (const Unit& unit : units) {
+		alive.insert(unit.tag);
+	}
+	for (auto it = extra.begin(); it != extra.end();) {
+		it = alive.count(it->first) ? std::next(it) : extra.erase(it);
+	}
+	UpdateCounts();
+}
+
+void SyntheticGame::StepOrder(Unit& unit) {
+	if (unit.build_progress < 1.0f || unit.orders.empty()) {
+		return;
+	}
+	UnitOrder& order = unit.orders.front();
+	ABILITY_ID ability =
+		static_cast<ABILITY_ID>(GenericAbility(order.ability_id));
+	bool done = false;
+
+	if (IsStructure(unit) && !unit.is_flying) {
+		done = StepProduction(unit, order);
+	}
+	else if (ProducedType(order.ability_id) != UNIT_TYPEID::INVALID) {
+		StepBuild(unit, order);
+		return;
+	}
+	else {
+		const Unit* target = order.target_unit_tag != NullTag
+			? Find(order.target_unit_tag) : nullptr;
+		switch (ability) {
+		case ABILITY_ID::MOVE:
+			done = MoveTowards(unit, target ? Point2D(target->pos)
+				: order.target_pos, target ? target->radius + unit.radius : 0.1f);
+			break;
+		case ABILITY_ID::ATTACK:
+			if (order.target_unit_tag != NullTag && !target) {
+				done = true;
+			}
+			else if (unit.engaged_target_tag == NullTag) {
+				// Enemy waves keep their attack order to the end
+				done = MoveTowards(unit, target ? Point2D(target->pos)
+					: order.target_pos, 0.5f) && !target &&
+					unit.alliance == Unit::Alliance::Self;
+			}
+			break;
+		case ABILITY_ID::HARVEST_GATHER:
+		case ABILITY_ID::HARVEST_RETURN:
+			StepHarvest(unit, order);
+			return;
+		case ABILITY_ID::EFFECT_REPAIR: {
+			Unit* repaired = Find(order.target_unit_tag);
+			if (!repaired || repaired->health >= repaired->health_max) {
+				done = true;
+			}
+			else if (MoveTowards(unit, repaired->pos,
+				repaired->radius + unit.radius + 0.5f)) {
+				repaired->health = std::min(repaired->health + 1.0f,
+					repaired->health_max);
+			}
+			break;
+		}
+		case ABILITY_ID::EFFECT_TACTICALJUMP: {
+			Extra& state = extra[unit.tag];
+			if (!state.timer_running) {
+				state.timer_running = true;
+				state.timer_start = game_loop;
+			}
+			else if (game_loop - state.timer_start >= jump_loops) {
+				state.timer_running = false;
+				unit.pos = Point3D(order.target_pos.x, order.target_pos.y,
+					HeightAt(order.target_pos));
+				done = true;
+			}
+			break;
+		}
+		case ABILITY_ID::LAND:
+			if (MoveTowards(unit, order.target_pos, 0.0f)) {
+				unit.unit_type = LandedType(unit.unit_type);
+				unit.is_flying = false;
+				done = true;
+			}
+			break;
+		default:
+			done = true;
+			break;
+		}
+	}
+	if (done) {
+		unit.orders.erase(unit.orders.begin());
+	}
+}
+
+void SyntheticGame::StepHarvest(Unit& unit, UnitOrder& order) {
+	Extra& state = extra[unit.tag];
+	Unit* resource = Find(order.target_unit_tag);
+	bool mule = unit.unit_type == UNIT_TYPEID::TERRAN_MULE;
+
+	const AbilityID gather = OrderAbility(ABILITY_ID::HARVEST_GATHER,
+		unit.unit_type);
+	if (GenericAbility(order.ability_id) ==
+		static_cast<uint32_t>(ABILITY_ID::HARVEST_RETURN)) {
+		if (!state.carrying) {
+			order.ability_id = gather;
+			return;
+		}
+		const Unit* closest = nullptr;
+		for (const Unit& other : units) {
+			if (IsSelfTownHall(other) && !other.is_flying && (!closest ||
+				DistanceSquared2D(unit.pos, other.pos) <
+				DistanceSquared2D(unit.pos, closest->pos))) {
+				closest = &other;
+			}
+		}
+		if (!closest) {
+			return;
+		}
+		if (MoveTowards(unit, closest->pos, closest->radius + unit.radius)) {
+			bool gas = resource &&
+				resource->unit_type == UNIT_TYPEID::TERRAN_REFINERY;
+			(gas ? vespene : minerals) += state.carrying;
+			state.carrying = 0;
+			// Queued orders take over once the cargo is in
+			if (resource && unit.orders.size() == 1) {
+				order.ability_id = gather;
+			}
+			else {
+				unit.orders.erase(unit.orders.begin());
+			}
+		}
+		return;
+	}
+
+	bool refinery = resource &&
+		resource->unit_type == UNIT_TYPEID::TERRAN_REFINERY &&
+		resource->alliance == Unit::Alliance::Self;
+	if (!resource || (!IsMineral(*resource) && !refinery) ||
+		unit.orders.size() > 1) {
+		unit.orders.erase(unit.orders.begin());
+		return;
+	}
+	if (refinery && (resource->build_progress < 1.0f || mule)) {
+		return;
+	}
+	if (!MoveTowards(unit, resource->pos, resource->radius + unit.radius)) {
+		return;
+	}
+	if (!state.timer_running) {
+		state.timer_running = true;
+		state.timer_start = game_loop;
+		return;
+	}
+	if (game_loop - state.timer_start < gather_loops) {
+		return;
+	}
+	state.timer_running = false;
+	if (refinery) {
+		state.carrying = vespene_trip;
+	}
+	else {
+		state.carrying = std::min(mule ? mule_trip : mineral_trip,
+			resource->mineral_contents);
+		resource->mineral_contents -= state.carrying;
+	}
+	order.ability_id = OrderAbility(ABILITY_ID::HARVEST_RETURN, unit.unit_type);
+}
+
+bool SyntheticGame::Free(UnitTypeID type, const Point2D& pos) const {
+	Rect cells = Footprint(type, pos);
+	for (int y = cells.y0; y < cells.y1; ++y) {
+		for (int x = cells.x0; x < cells.x1; ++x) {
+			if (x < playable_min || y < playable_min || x >= playable_max ||
+				y >= playable_max || !placeable[x + y * map_size]) {
+				return false;
+			}
+		}
+	}
+	for (const Unit& unit : units) {
+		if (unit.is_flying || (unit.alliance != Unit::Alliance::Neutral &&
+			unit.health <= 0.0f)) {
+			continue;
+		}
+		if ((IsStructure(unit) || IsMineral(unit) ||
+			unit.unit_type == UNIT_TYPEID::NEUTRAL_VESPENEGEYSER) &&
+			cells.Overlaps(Footprint(unit.unit_type, unit.pos))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void SyntheticGame::StepBuild(Unit& unit, UnitOrder& order) {
+	UNIT_TYPEID type = ProducedType(order.ability_id);
+	const OfflineUnitInfo* info = FindUnitInfo(type);
+	Unit* target = order.target_unit_tag != NullTag
+		? Find(order.target_unit_tag) : nullptr;
+
+	// Started: keep building next to it until it's done
+	if (target && target->unit_type == type) {
+		if (!MoveTowards(unit, target->pos, target->radius + unit.radius)) {
+			return;
+		}
+		target->build_progress = std::min(target->build_progress +
+			1.0f / std::max(info->build_loops, 1u), 1.0f);
+		target->health = std::min(target->health + 0.9f * info->health /
+			std::max(info->build_loops, 1u), target->health_max);
+		if (target->build_progress >= 1.0f) {
+			unit.orders.erase(unit.orders.begin());
+		}
+		return;
+	}
+
+	if (!MoveTowards(unit, order.target_pos, info->footprint / 2.0f +
+		unit.radius)) {
+		return;
+	}
+	bool placeable = false;
+	if (type == UNIT_TYPEID::TERRAN_REFINERY) {
+		// Only on a free geyser
+		placeable = target &&
+			target->unit_type == UNIT_TYPEID::NEUTRAL_VESPENEGEYSER;
+		for (const Unit& other : units) {
+			if (target && other.unit_type == UNIT_TYPEID::TERRAN_REFINERY &&
+				DistanceSquared2D(other.pos, target->pos) < 0.01f) {
+				placeable = false;
+			}
+		}
+	}
+	else {
+		placeable = Free(type, order.target_pos);
+	}
+	if (!placeable || !Pay(type)) {
+		unit.orders.erase(unit.orders.begin());
+		return;
+	}
+	Point2D pos = target ? Point2D(target->pos) : order.target_pos;
+	order.target_unit_tag =
+		Spawn(type, Unit::Alliance::Self, pos, 0.0f).tag;
+}
+
+bool SyntheticGame::StepProduction(Unit& unit, UnitOrder& order) {
+	UNIT_TYPEID produced = ProducedType(order.ability_id);
+	uint32_t loops = research_loops;
+	Unit* addon = nullptr;
+	if (produced != UNIT_TYPEID::INVALID) {
+		loops = FindUnitInfo(produced)->build_loops;
+	}
+	else if ((addon = Find(order.target_unit_tag)) != nullptr) {
+		loops = FindUnitInfo(addon->unit_type)->build_loops;
+	}
+	else if (ResearchedUpgrade(order.ability_id) == UPGRADE_ID::INVALID) {
+		return true;
+	}
+	order.progress += 1.0f / std::max(loops, 1u);
+	if (addon) {
+		addon->build_progress = std::min(order.progress, 1.0f);
+		addon->health = addon->health_max * std::max(addon->build_progress,
+			0.1f);
+	}
+	if (order.progress < 1.0f) {
+		return false;
+	}
+
+	if (produced == UNIT_TYPEID::TERRAN_ORBITALCOMMAND) {
+		unit.unit_type = produced;
+		unit.energy = 50.0f;
+	}
+	else if (produced != UNIT_TYPEID::INVALID) {
+		const OfflineUnitInfo* info = FindUnitInfo(produced);
+		Point2D pos(unit.pos.x, unit.pos.y - unit.radius - info->radius - 0.5f);
+		Spawn(produced, Unit::Alliance::Self, pos);
+	}
+	else if (!addon) {
+		upgrades.push_back(ResearchedUpgrade(order.ability_id));
+	}
+	return true;
+}
+
+void SyntheticGame::StepCombat() {
+	std::vector<size_t> fighters;
+	for (size_t i = 0; i < units.size(); ++i) {
+		if (units[i].alliance != Unit::Alliance::Neutral &&
+			units[i].build_progress >= 1.0f) {
+			fighters.push_back(i);
+		}
+	}
+
+	std::vector<float> damage(units.size(), 0.0f);
+	for (size_t i : fighters) {
+		Unit& unit = units[i];
+		unit.engaged_target_tag = NullTag;
+		const OfflineUnitInfo* info = FindUnitInfo(unit.unit_type);
+		if (!info || info->damage <= 0.0f) {
+			continue;
+		}
+		const UnitOrder* order = unit.orders.empty() ? nullptr
+			: &unit.orders.front();
+		uint32_t ability = order ? GenericAbility(order->ability_id) : 0;
+		bool attacking = ability == static_cast<uint32_t>(ABILITY_ID::ATTACK);
+		// Workers only fight when told to, and a move order wins over fighting
+		if ((unit.unit_type == UNIT_TYPEID::TERRAN_SCV && !attacking) ||
+			ability == static_cast<uint32_t>(ABILITY_ID::MOVE)) {
+			continue;
+		}
+
+		size_t best = units.size();
+		float best_distance = 0.0f;
+		for (size_t j : fighters) {
+			const Unit& other = units[j];
+			if (other.alliance == unit.alliance ||
+				(other.is_flying && !CanHitAir(unit.unit_type))) {
+				continue;
+			}
+			float reach = info->range + unit.radius + other.radius;
+			float distance = Distance2D(unit.pos, other.pos);
+			if (distance > reach) {
+				continue;
+			}
+			// The ordered target first, then the closest
+			if (attacking && order->target_unit_tag == other.tag) {
+				best = j;
+				break;
+			}
+			if (best == units.size() || distance < best_distance) {
+				best = j;
+				best_distance = distance;
+			}
+		}
+		if (best != units.size()) {
+			unit.engaged_target_tag = units[best].tag;
+			damage[best] += info->damage;
+		}
+	}
+	for (size_t i = 0; i < units.size(); ++i) {
+		units[i].health -= damage[i];
+	}
+
+	// Enemy units go for the closest of our units they can see
+	for (size_t i : fighters) {
+		Unit& unit = units[i];
+		if (unit.alliance != Unit::Alliance::Enemy || unit.orders.empty() ||
+			unit.engaged_target_tag != NullTag) {
+			continue;
+		}
+		const Unit* closest = nullptr;
+		for (size_t j : fighters) {
+			const Unit& other = units[j];
+			if (other.alliance == Unit::Alliance::Self && !other.is_flying &&
+				Distance2D(unit.pos, other.pos) < 10.0f && (!closest ||
+					DistanceSquared2D(unit.pos, other.pos) <
+					DistanceSquared2D(unit.pos, closest->pos))) {
+				closest = &other;
+			}
+		}
+		if (!closest &&
+			Distance2D(unit.pos, unit.orders.front().target_pos) < 2.0f) {
+			// Nothing left at the target; move on to the next structure
+			for (size_t j : fighters) {
+				if (units[j].alliance == Unit::Alliance::Self &&
+					IsStructure(units[j]) && !units[j].is_flying) {
+					closest = &units[j];
+					break;
+				}
+			}
+		}
+		if (closest) {
+			unit.orders.front().target_pos = closest->pos;
+		}
+	}
+}
+
+void SyntheticGame::SpawnWave() {
+	int zerglings = settings.wave_size + 2 * waves;
+	int roaches = zerglings / 4;
+	++waves;
+	UnitOrder attack;
+	attack.ability_id = ABILITY_ID::ATTACK_ATTACK;
+	attack.target_pos = main_base;
+	for (int i = 0; i < zerglings + roaches; ++i) {
+		Point2D pos(wave_spawn.x + (i % 6) * 1.0f, wave_spawn.y + (i / 6) * 1.0f);
+		Unit& unit = Spawn(i < zerglings ? UNIT_TYPEID::ZERG_ZERGLING
+			: UNIT_TYPEID::ZERG_ROACH, Unit::Alliance::Enemy, pos);
+		unit.orders.push_back(attack);
+	}
+}
+
+void SyntheticGame::UpdateCounts() {
+	std::unordered_map<Tag, int> workers;
+	for (const Unit& unit : units) {
+		if (unit.unit_type == UNIT_TYPEID::TERRAN_SCV && !unit.orders.empty() &&
+			(unit.orders.front().ability_id == ABILITY_ID::HARVEST_GATHER_SCV ||
+				unit.orders.front().ability_id ==
+				ABILITY_ID::HARVEST_RETURN_SCV)) {
+			++workers[unit.orders.front().target_unit_tag];
+		}
+	}
+	for (Unit& unit : units) {
+		unit.last_seen_game_loop = game_loop;
+		if (unit.unit_type == UNIT_TYPEID::TERRAN_REFINERY) {
+			unit.ideal_harvesters = unit.build_progress >= 1.0f ? 3 : 0;
+			unit.assigned_harvesters = workers[unit.tag];
+		}
+		else if (IsSelfTownHall(unit)) {
+			unit.ideal_harvesters = 0;
+			unit.assigned_harvesters = 0;
+			for (const Unit& mineral : units) {
+				if (IsMineral(mineral) &&
+					Distance2D(mineral.pos, unit.pos) < 10.0f) {
+					unit.ideal_harvesters += 2;
+					unit.assigned_harvesters += workers[mineral.tag];
+				}
+			}
+		}
+	}
+}
+
+void SyntheticGame::CheckGameOver() {
+	bool self_alive = false;
+	bool enemy_alive = false;
+	for (const Unit& unit : units) {
+		if (IsStructure(unit)) {
+			self_alive |= unit.alliance == Unit::Alliance::Self;
+			enemy_alive |= unit.alliance == Unit::Alliance::Enemy;
+		}
+	}
+	if (self_alive && enemy_alive && game_loop < settings.max_loops) {
+		return;
+	}
+	GameResult result = !self_alive ? GameResult::Loss
+		: !enemy_alive ? GameResult::Win : GameResult::Tie;
+	GameResult enemy_result = result == GameResult::Win ? GameResult::Loss
+		: result == GameResult::Loss ? GameResult::Win : GameResult::Tie;
+	results = { { 1, result }, { 2, enemy_result } };
+	over = true;
+}
@@ -0,0 +1,102 @@
+#ifndef SYNTHETIC_GAME_H_
+#define SYNTHETIC_GAME_H_
+
+#include "FrameSource.h"
+
+#include "sc2api/sc2_common.h"
+#include "sc2api/sc2_gametypes.h"
+#include "sc2api/sc2_unit.h"
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// A small deterministic game against waves of zerglings and roaches.
+// Two mirrored sides on a 128x128 map, each with a main, a natural and a
+// third base. Our commands are carried out with simple rules: straight line
+// movement, fixed gather trips, damage per loop in range. It is meant to
+// exercise the bot's code paths the same way every run, not to be balanced.
+class SyntheticGame : public FrameSource {
+public:
+	struct Settings {
+		// The game ends as a tie after this many loops
+		uint32_t max_loops = 22400;
+		uint32_t first_wave_loop = 5376;
+		uint32_t wave_interval = 2016;
+		// Zerglings in the first wave; each wave brings two more and a roach
+		// for every four zerglings
+		int wave_size = 6;
+	};
+
+	SyntheticGame();
+	explicit SyntheticGame(const Settings& settings);
+
+	const sc2::GameInfo& Info() const override { return game_info; }
+	sc2::Point3D StartLocation() const override;
+	bool Next(OfflineFrame& frame) override;
+	void Apply(const std::vector<OfflineCommand>& commands) override;
+
+private:
+	// State the unit struct has no room for
+	struct Extra {
+		// Loop a timed order (gather trip, jump, ...) started
+		uint32_t timer_start = 0;
+		bool timer_running = false;
+		int carrying = 0;
+		// Loop a MULE expires
+		uint32_t expires = 0;
+	};
+
+	void BuildMap();
+	void AddBase(const sc2::Point2D& town_hall, bool side_minerals);
+	void AddStartingUnits();
+	sc2::Unit& Spawn(sc2::UNIT_TYPEID type, sc2::Unit::Alliance alliance,
+		const sc2::Point2D& pos, float build_progress = 1.0f);
+	sc2::Unit* Find(sc2::Tag tag);
+
+	void ApplyCommand(const OfflineCommand& command);
+	bool Pay(sc2::UNIT_TYPEID type);
+	bool Pay(int minerals_cost, int vespene_cost);
+
+	void Step();
+	void StepOrder(sc2::Unit& unit);
+	void StepHarvest(sc2::Unit& unit, sc2::UnitOrder& order);
+	void StepBuild(sc2::Unit& unit, sc2::UnitOrder& order);
+	bool StepProduction(sc2::Unit& unit, sc2::UnitOrder& order);
+	void StepCombat();
+	void SpawnWave();
+	void UpdateCounts();
+	void CheckGameOver();
+	// Moves at the unit's speed, true once within distance of the target
+	bool MoveTowards(sc2::Unit& unit, const sc2::Point2D& target,
+		float distance);
+	// Whether a structure fits, ignoring units that can move away
+	bool Free(sc2::UnitTypeID type, const sc2::Point2D& pos) const;
+	float HeightAt(const sc2::Point2D& pos) const;
+	int FoodUsed() const;
+	int FoodCap() const;
+
+	Settings settings;
+	sc2::GameInfo game_info;
+	// Indexed x + y * width, bottom row first
+	std::vector<unsigned char> heights;
+	std::vector<bool> placeable;
+	uint32_t game_loop = 0;
+	int minerals = 50;
+	int vespene = 0;
+	std::vector<sc2::UpgradeID> upgrades;
+	std::vector<sc2::PlayerResult> results;
+	// Units removed by the last step
+	std::vector<sc2::Tag> dead_units;
+	bool started = false;
+	bool over = false;
+	int waves = 0;
+
+	// A deque so units spawned mid-loop don't move the others
+	std::deque<sc2::Unit> units;
+	std::unordered_map<sc2::Tag, Extra> extra;
+	sc2::Tag next_tag = 0x100000001ull;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "OfflineHarness.h"
+#include "RecordedFrameSource.h"
+#include "SyntheticGame.h"
+
+#include "BasicSc2Bot.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+// Plays the bot against the synthetic game, or through a game recorded with
+// --Record, no SC2 install needed.
+// Usage: UEDBot_offline [steps] [recording]
+int main(int argc, char* argv[]) {
+	uint32_t max_steps = 0;
+	if (argc > 1) {
+		max_steps = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+	}
+
+	SyntheticGame game;
+	RecordedFrameSource recording;
+	FrameSource* source = &game;
+	if (argc > 2) {
+		if (!recording.Open(argv[2])) {
+			std::fprintf(stderr, "%s is not a recording\n", argv[2]);
+			return 1;
+		}
+		std::printf("replaying %u frames of %s\n", recording.FrameCount(),
+			recording.Info().map_name.c_str());
+		source = &recording;
+	}
+
+	BasicSc2Bot bot;
+	OfflineRunResult run = RunOffline(bot, *source, max_steps);
+
+	std::printf("steps: %u (game loop %u)\n", run.steps, run.last_game_loop);
+	if (run.steps) {
+		std::printf("OnStep: %.1f ms total, %.1f us mean, %llu us max\n",
+			run.step_us_total / 1000.0,
+			static_cast<double>(run.step_us_total) / run.steps,
+			static_cast<unsigned long long>(run.step_us_max));
+	}
+	std::printf("commands sent: %zu\n", run.commands);
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include "GameBackend.h"
+
+#include <algorithm>
+#include <iostream>
+#include "sc2api/sc2_api.h"
+#include "sc2lib/sc2_lib.h"
+#include "sc2utils/sc2_manage_process.h"
+#include "sc2utils/sc2_arg_parser.h"
+
+#include "BasicSc2Bot.h"
+#include "GameRecording.h"
+#include "LadderInterface.h"
+
+#include "OfflineHarness.h"
+#include "RecordedFrameSource.h"
+#include "SyntheticGame.h"
+
+using namespace sc2;
+
+namespace {
+// Fills the match result from the bot's steps and game end
+class ResultMonitor : public GameMonitor {
+public:
+	explicit ResultMonitor(MatchResult& result) : result(result) {}
+
+	void OnStepTimed(double microseconds) override {
+		result.step_times.Record(microseconds);
+	}
+
+	void OnGameEnded(const ObservationInterface* observation) override {
+		result.finished = true;
+		result.game_loops = observation->GetGameLoop();
+		for (const auto& player : observation->GetResults()) {
+			if (player.player_id == observation->GetPlayerID()) {
+				result.result = player.result;
+			}
+		}
+	}
+
+private:
+	MatchResult& result;
+};
+
+// Against the built-in AI, the way the bot plays with -c
+class LiveBackend : public GameBackend {
+public:
+	void Play(const MatchSpec& match, char* argv[],
+		MatchResult& result) override {
+		ConnectionOptions options;
+		options.ComputerOpponent = true;
+		options.ComputerRace = GetRaceFromString(match.race);
+		options.ComputerDifficulty = GetDifficultyFromString(match.difficulty);
+		options.Map = match.map.empty() ? kDefaultMap : match.map;
+		options.StartPort = match.start_port;
+
+		BasicSc2Bot bot;
+		ResultMonitor monitor(result);
+		bot.SetMonitor(&monitor);
+		RunGame(options, argv, &bot, Race::Terran);
+	}
+};
+
+// The synthetic game, or a recording played back
+class OfflineBackend : public GameBackend {
+public:
+	void Play(const MatchSpec& match, char*[], MatchResult& result) override {
+		SyntheticGame game;
+		RecordedFrameSource recording;
+		FrameSource* source = &game;
+		if (!match.map.empty()) {
+			if (!recording.Open(match.map)) {
+				std::cout << match.map << " is not a recording" << std::endl;
+				return;
+			}
+			source = &recording;
+		}
+
+		BasicSc2Bot bot;
+		ResultMonitor monitor(result);
+		bot.SetMonitor(&monitor);
+		RunOffline(bot, *source, match.max_steps);
+	}
+};
+}
+
+std::unique_ptr<GameBackend> MakeGameBackend(const std::string& name) {
+	if (name == "live") {
+		return std::unique_ptr<GameBackend>(new LiveBackend());
+	}
+	if (name == "offline") {
+		return std::unique_ptr<GameBackend>(new OfflineBackend());
+	}
+	return nullptr;
+}
@@ -0,0 +1,40 @@
+#ifndef GAME_BACKEND_H_
+#define GAME_BACKEND_H_
+
+#include "MatchReport.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// One game for a worker to play
+struct MatchSpec {
+	// Map for live games. For offline games a recording, empty for the
+	// synthetic game.
+	std::string map;
+	// Computer opponent, as on the bot's command line
+	std::string race = "random";
+	std::string difficulty = "Hard";
+	// First port of this worker's range, 0 for the default ports
+	int32_t start_port = 0;
+	// Offline games stop after this many steps, 0 for no limit
+	uint32_t max_steps = 0;
+};
+
+// Plays games in the worker's own process
+class GameBackend {
+public:
+	virtual ~GameBackend() {}
+
+	// Plays the match to its end. result.finished stays false if the game
+	// never got to the end.
+	virtual void Play(const MatchSpec& match, char* argv[],
+		MatchResult& result) = 0;
+};
+
+// "live" plays against the built-in AI through the SC2 client, "offline"
+// runs the synthetic game or a recording (offline/). nullptr for other
+// names.
+std::unique_ptr<GameBackend> MakeGameBackend(const std::string& name);
+
+#endif
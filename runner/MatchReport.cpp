@@ -0,0 +1,131 @@
+#include "MatchReport.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace sc2;
+
+bool WriteMatchResult(const std::string& path, const MatchResult& result) {
+	std::string partial = path + ".partial";
+	{
+		std::ofstream out(partial);
+		if (!out) {
+			return false;
+		}
+		out.precision(17);
+		out << "finished " << result.finished << "\n";
+		out << "result " << static_cast<int>(result.result) << "\n";
+		out << "game_loops " << result.game_loops << "\n";
+		out << "step_times ";
+		result.step_times.Write(out);
+		if (!out) {
+			return false;
+		}
+	}
+	std::remove(path.c_str());
+	return std::rename(partial.c_str(), path.c_str()) == 0;
+}
+
+bool ReadMatchResult(const std::string& path, MatchResult& result) {
+	std::ifstream in(path);
+	std::string key;
+	int game_result = 0;
+	in >> key >> result.finished;
+	in >> key >> game_result;
+	in >> key >> result.game_loops;
+	in >> key;
+	if (!in || !result.step_times.Read(in)) {
+		return false;
+	}
+	result.result = static_cast<GameResult>(game_result);
+	return true;
+}
+
+const char* GameResultName(GameResult result) {
+	switch (result) {
+	case GameResult::Win:
+		return "Win";
+	case GameResult::Loss:
+		return "Loss";
+	case GameResult::Tie:
+		return "Tie";
+	default:
+		return "Undecided";
+	}
+}
+
+MatchReport::Row& MatchReport::RowOf(const std::string& matchup) {
+	for (auto& row : rows) {
+		if (row.matchup == matchup) {
+			return row;
+		}
+	}
+	rows.emplace_back();
+	rows.back().matchup = matchup;
+	return rows.back();
+}
+
+void MatchReport::Add(const std::string& matchup, const MatchResult& result) {
+	for (Row* row : { &RowOf(matchup), &total }) {
+		row->games++;
+		switch (result.result) {
+		case GameResult::Win:
+			row->wins++;
+			break;
+		case GameResult::Loss:
+			row->losses++;
+			break;
+		default:
+			// Games cut short count as ties
+			row->ties++;
+			break;
+		}
+		if (result.finished) {
+			row->game_loops += result.game_loops;
+			row->finished++;
+		}
+		row->step_times.Merge(result.step_times);
+	}
+}
+
+void MatchReport::AddFailed(const std::string& matchup) {
+	for (Row* row : { &RowOf(matchup), &total }) {
+		row->games++;
+		row->failed++;
+	}
+}
+
+void MatchReport::PrintRow(std::ostream& out, const Row& row) {
+	char length[16] = "-";
+	if (row.finished) {
+		uint32_t seconds = static_cast<uint32_t>(
+			row.game_loops / row.finished / 22.4);
+		std::snprintf(length, sizeof(length), "%u:%02u", seconds / 60,
+			seconds % 60);
+	}
+	const LatencyHistogram& times = row.step_times;
+	double mean = times.Count() ?
+		times.Total() / static_cast<double>(times.Count()) : 0.0;
+	char line[256];
+	std::snprintf(line, sizeof(line),
+		"%-36s %5zu %5zu %5zu %5zu %6zu %7s %9.1f %9.1f %9.1f %9.1f %9.1f",
+		row.matchup.c_str(), row.games, row.wins, row.losses, row.ties,
+		row.failed, length, mean, times.Percentile(0.50),
+		times.Percentile(0.95), times.Percentile(0.99), times.Max());
+	out << line << std::endl;
+}
+
+void MatchReport::Print(std::ostream& out) const {
+	char line[256];
+	std::snprintf(line, sizeof(line),
+		"%-36s %5s %5s %5s %5s %6s %7s %9s %9s %9s %9s %9s", "matchup",
+		"games", "wins", "losses", "ties", "failed", "length", "mean us",
+		"p50 us", "p95 us", "p99 us", "max us");
+	out << line << std::endl;
+	for (const auto& row : rows) {
+		PrintRow(out, row);
+	}
+	if (rows.size() > 1) {
+		PrintRow(out, total);
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef MATCH_REPORT_H_
+#define MATCH_REPORT_H_
+
+#include "LatencyHistogram.h"
+
+#include "sc2api/sc2_gametypes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// What one game did, as a worker reports it to the runner
+struct MatchResult {
+	// Set once the bot saw the end of the game
+	bool finished = false;
+	sc2::GameResult result = sc2::GameResult::Undecided;
+	uint32_t game_loops = 0;
+	LatencyHistogram step_times;
+};
+
+// Result files are written to a temporary name and renamed when complete,
+// so a worker that dies leaves no result behind
+bool WriteMatchResult(const std::string& path, const MatchResult& result);
+bool ReadMatchResult(const std::string& path, MatchResult& result);
+
+// Results summed up per matchup (map, race and difficulty) and overall
+class MatchReport {
+public:
+	MatchReport() { total.matchup = "all"; }
+
+	// A finished game of the matchup; failed for the games that didn't get
+	// to the end
+	void Add(const std::string& matchup, const MatchResult& result);
+	void AddFailed(const std::string& matchup);
+
+	void Print(std::ostream& out) const;
+
+private:
+	struct Row {
+		std::string matchup;
+		size_t games = 0;
+		size_t wins = 0;
+		size_t losses = 0;
+		size_t ties = 0;
+		size_t failed = 0;
+		// Over the finished games
+		uint64_t game_loops = 0;
+		size_t finished = 0;
+		LatencyHistogram step_times;
+	};
+
+	Row& RowOf(const std::string& matchup);
+	static void PrintRow(std::ostream& out, const Row& row);
+
+	// In the order the matchups were first added
+	std::vector<Row> rows;
+	Row total;
+};
+
+const char* GameResultName(sc2::GameResult result);
+
+#endif
@@ -0,0 +1,232 @@
+#include "GameBackend.h"
+#include "MatchReport.h"
+
+#include "sc2utils/sc2_arg_parser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Plays a matrix of games (maps x computer races) in parallel worker
+// processes, each on its own range of ports, and sums up results, game
+// length and OnStep latency in one report. The workers are this executable
+// started again with --Worker.
+//
+// Usage: UEDBot_runner [-b live|offline] [-m maps] [-a races] [-d difficulty]
+//     [-n repeat] [-j parallel] [-o start port] [-s steps] [-w work dir]
+//     [-R report file]
+
+namespace {
+// The test matrix at the bottom of BasicSc2Bot.cpp
+const char* default_maps =
+	"CactusValleyLE.SC2Map,BelShirVestigeLE.SC2Map,ProximaStationLE.SC2Map";
+const char* default_races = "zerg,terran,protoss";
+// Ports a worker may use from its start port on
+const int32_t ports_per_worker = 16;
+
+std::vector<std::string> Split(const std::string& list) {
+	std::vector<std::string> items;
+	size_t start = 0;
+	while (start <= list.size()) {
+		size_t end = list.find(',', start);
+		if (end == std::string::npos) {
+			end = list.size();
+		}
+		if (end > start) {
+			items.push_back(list.substr(start, end - start));
+		}
+		start = end + 1;
+	}
+	return items;
+}
+
+std::string Quote(const std::string& arg) {
+	return "\"" + arg + "\"";
+}
+
+// The value of the option, or fallback if it wasn't given
+std::string Option(sc2::ArgParser& parser, const std::string& name,
+	const std::string& fallback) {
+	std::string value;
+	return parser.Get(name, value) ? value : fallback;
+}
+
+std::string Matchup(const MatchSpec& match, bool live) {
+	std::string map = match.map.empty() ? "synthetic" : match.map;
+	// Leave out the directory and the extension
+	size_t slash = map.find_last_of("/\\");
+	if (slash != std::string::npos) {
+		map = map.substr(slash + 1);
+	}
+	size_t dot = map.find('.');
+	if (dot != std::string::npos) {
+		map = map.substr(0, dot);
+	}
+	return live ? map + " vs " + match.race + " " + match.difficulty : map;
+}
+
+// Plays one game and writes its result, run in the worker process
+int RunWorker(const std::string& backend_name, const MatchSpec& match,
+	const std::string& result_path, const std::string& log_path,
+	char* argv[]) {
+	std::unique_ptr<GameBackend> backend = MakeGameBackend(backend_name);
+	if (!backend) {
+		std::cerr << "Unknown backend " << backend_name << std::endl;
+		return 1;
+	}
+	// The bot's own output goes to the game's log
+	if (!log_path.empty() && !std::freopen(log_path.c_str(), "w", stdout)) {
+		std::cerr << "Could not write " << log_path << std::endl;
+	}
+
+	MatchResult result;
+	backend->Play(match, argv, result);
+	std::cout.flush();
+	return WriteMatchResult(result_path, result) ? 0 : 1;
+}
+}
+
+int main(int argc, char* argv[]) {
+	sc2::ArgParser arg_parser(argv[0]);
+	arg_parser.AddOptions({
+		{ "-b", "--Backend", "live (the SC2 client, default) or offline" },
+		{ "-m", "--Maps", "Comma separated maps, or recordings for offline" },
+		{ "-a", "--Races", "Comma separated races of the computer opponent" },
+		{ "-d", "--ComputerDifficulty", "Difficulty of the computer opponent" },
+		{ "-n", "--Repeat", "Games per map and race" },
+		{ "-j", "--Parallel", "Games played at once" },
+		{ "-o", "--StartPort", "First port of the workers' port ranges" },
+		{ "-s", "--Steps", "Steps per offline game, 0 for the whole game" },
+		{ "-w", "--WorkDir", "Existing directory for result and log files" },
+		{ "-R", "--Report", "File to also write the report to" },
+		{ "-W", "--Worker", "Play one game and write its result here" },
+		{ "-L", "--Log", "Log file of a worker's game" }
+		});
+	arg_parser.Parse(argc, argv);
+
+	const std::string backend = Option(arg_parser, "Backend", "live");
+	const bool live = backend == "live";
+	if (!MakeGameBackend(backend)) {
+		std::cerr << "Unknown backend " << backend << std::endl;
+		return 1;
+	}
+	MatchSpec spec;
+	spec.difficulty = Option(arg_parser, "ComputerDifficulty", "Hard");
+	spec.max_steps = static_cast<uint32_t>(
+		std::strtoul(Option(arg_parser, "Steps", "0").c_str(), nullptr, 10));
+	const int32_t start_port =
+		std::atoi(Option(arg_parser, "StartPort", "5000").c_str());
+
+	std::string result_path;
+	if (arg_parser.Get("Worker", result_path)) {
+		spec.map = Option(arg_parser, "Maps", "");
+		spec.race = Option(arg_parser, "Races", "random");
+		spec.start_port = start_port;
+		return RunWorker(backend, spec, result_path,
+			Option(arg_parser, "Log", ""), argv);
+	}
+
+	// Offline games have no opponent to choose, and without recordings
+	// they are all the synthetic game
+	std::vector<std::string> maps =
+		Split(Option(arg_parser, "Maps", live ? default_maps : ""));
+	std::vector<std::string> races =
+		Split(Option(arg_parser, "Races", live ? default_races : "random"));
+	if (maps.empty()) {
+		maps.push_back("");
+	}
+	if (!live) {
+		races = { "random" };
+	}
+	const int repeat =
+		std::max(std::atoi(Option(arg_parser, "Repeat", "1").c_str()), 1);
+	const int parallel =
+		std::max(std::atoi(Option(arg_parser, "Parallel", "2").c_str()), 1);
+	const std::string work_dir = Option(arg_parser, "WorkDir", ".");
+
+	std::vector<MatchSpec> matches;
+	for (const auto& map : maps) {
+		for (const auto& race : races) {
+			for (int i = 0; i < repeat; ++i) {
+				matches.push_back(spec);
+				matches.back().map = map;
+				matches.back().race = race;
+			}
+		}
+	}
+
+	// Each worker takes the next game until none are left, always on the
+	// ports of its slot
+	std::atomic<size_t> next_match(0);
+	std::vector<char> completed(matches.size(), 0);
+	std::vector<MatchResult> results(matches.size());
+	std::mutex print_mutex;
+	size_t done = 0;
+	auto worker = [&](int slot) {
+		for (size_t i = next_match++; i < matches.size(); i = next_match++) {
+			const MatchSpec& match = matches[i];
+			std::string name = work_dir + "/match_" + std::to_string(i);
+			std::string result_file = name + ".result";
+			std::remove(result_file.c_str());
+
+			std::string command = Quote(argv[0]) + " -W " +
+				Quote(result_file) + " -L " + Quote(name + ".log") +
+				" -b " + backend + " -a " + match.race + " -d " +
+				match.difficulty + " -o " +
+				std::to_string(start_port + slot * ports_per_worker) + " -s " +
+				std::to_string(match.max_steps);
+			if (!match.map.empty()) {
+				command += " -m " + Quote(match.map);
+			}
+#ifdef _WIN32
+			// cmd.exe drops the outer quotes of the whole line
+			command = "\"" + command + "\"";
+#endif
+			int status = std::system(command.c_str());
+			completed[i] = status == 0 &&
+				ReadMatchResult(result_file, results[i]) &&
+				results[i].finished;
+
+			std::lock_guard<std::mutex> lock(print_mutex);
+			++done;
+			std::cout << "[" << done << "/" << matches.size() << "] "
+				<< Matchup(match, live) << ": "
+				<< (completed[i] ? GameResultName(results[i].result) :
+					"failed, see " + name + ".log") << std::endl;
+		}
+	};
+	std::vector<std::thread> workers;
+	for (int slot = 0; slot < parallel; ++slot) {
+		workers.emplace_back(worker, slot);
+	}
+	for (auto& thread : workers) {
+		thread.join();
+	}
+
+	MatchReport report;
+	for (size_t i = 0; i < matches.size(); ++i) {
+		if (completed[i]) {
+			report.Add(Matchup(matches[i], live), results[i]);
+		}
+		else {
+			report.AddFailed(Matchup(matches[i], live));
+		}
+	}
+	report.Print(std::cout);
+	std::string report_path;
+	if (arg_parser.Get("Report", report_path)) {
+		std::ofstream out(report_path);
+		report.Print(out);
+		if (!out) {
+			std::cerr << "Could not write " << report_path << std::endl;
+		}
+	}
+	return 0;
+}